@@ -1,8 +1,38 @@
 #include "src/ui/MainWindow.hpp"
+#include "src/ui/RenderService.hpp"
+#include "src/core/Engine3D.hpp"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <algorithm>
 
 int main(int argc, char *argv[]) {
+    configureDefaultSurfaceFormat();
     QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("files", "Модели и сцены для --thumbnails (.obj, .scene)");
+    const QCommandLineOption thumbnailsOption("thumbnails", "Отрисовать превью в папку без окна и выйти", "dir");
+    const QCommandLineOption thumbnailSizeOption("thumbnail-size", "Сторона превью, px", "px", "256");
+    parser.addOptions({thumbnailsOption, thumbnailSizeOption});
+    parser.process(app);
+
+    // Пакетные превью: окно не создаётся, кадры — в offscreen-контексте
+    if (parser.isSet(thumbnailsOption)) {
+        RenderService service;
+        QObject::connect(&service, &RenderService::failed, [](const QString &path, const QString &error){
+            qWarning().noquote() << "[THUMB]" << path << ":" << error;
+        });
+        QObject::connect(&service, &RenderService::thumbnailsFinished, &app, [&app](int rendered, int failed){
+            qInfo().noquote() << QString("[THUMB] Готово: %1, ошибок: %2").arg(rendered).arg(failed);
+            app.exit(failed > 0 ? 1 : 0);
+        });
+        const int size = std::max(16, parser.value(thumbnailSizeOption).toInt());
+        if (!service.renderThumbnails(parser.positionalArguments(), parser.value(thumbnailsOption), size)) return 1;
+        return app.exec();
+    }
+
     MainWindow window;
     window.show();
 
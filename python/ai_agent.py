@@ -4,12 +4,14 @@ import asyncio
 import httpx
 import json
 import os
+import struct
 from PyQt6.QtWidgets import (
     QApplication, QMainWindow, QTabWidget, QWidget, QVBoxLayout,
     QTextEdit, QPushButton, QLabel, QFileDialog, QHBoxLayout, QMessageBox
 )
 from PyQt6.QtCore import Qt, QThread, pyqtSignal
 from PyQt6.QtGui import QDrag
+from PyQt6.QtNetwork import QLocalSocket
 from PyQt6.QtOpenGLWidgets import QOpenGLWidget
 from OpenGL.GL import *
 from OpenGL.GLU import gluPerspective
@@ -19,8 +21,36 @@ OPENROUTER_URL = "https://openrouter.ai/api/v1/chat/completions"
 DEFAULT_MODEL = "qwen/qwen-turbo"
 # Пользовательский конфиг в домашней директории
 SETTINGS_PATH = os.path.join(os.path.expanduser("~"), ".config", "SimpleCASCADE", "settings.json")
-TEMP_OBJ_PATH = os.path.join(os.path.dirname(__file__), "temp_model.obj")
-FLAG_PATH = os.path.join(os.path.dirname(__file__), "model_ready.flag")
+# Канал моделей редактора (QLocalServer); адрес передаёт редактор при запуске агента
+MODEL_SOCKET = os.environ.get("SIMPLECASCADE_MODEL_SOCKET", "")
+# Кадры канала: u8 type, u32 length (little-endian), payload — как в ModelReceiver.hpp
+FRAME_BEGIN, FRAME_DATA, FRAME_END = 1, 2, 3
+FRAME_CHUNK = 64 * 1024
+
+
+def send_model_to_editor(obj_data, name=""):
+    """Стримит OBJ в редактор кусками; разбор на стороне редактора идёт вне GUI-потока."""
+    if not MODEL_SOCKET:
+        raise RuntimeError("агент запущен не из редактора: канал моделей неизвестен")
+    sock = QLocalSocket()
+    sock.connectToServer(MODEL_SOCKET)
+    if not sock.waitForConnected(2000):
+        raise RuntimeError(f"редактор недоступен: {sock.errorString()}")
+
+    def frame(kind, payload=b""):
+        sock.write(struct.pack("<BI", kind, len(payload)) + payload)
+
+    frame(FRAME_BEGIN, name.encode("utf-8"))
+    data = obj_data.encode("utf-8")
+    for offset in range(0, len(data), FRAME_CHUNK):
+        frame(FRAME_DATA, data[offset:offset + FRAME_CHUNK])
+        sock.waitForBytesWritten(2000)
+    frame(FRAME_END)
+    if not sock.waitForBytesWritten(5000) and sock.bytesToWrite() > 0:
+        raise RuntimeError(f"не удалось передать модель: {sock.errorString()}")
+    sock.disconnectFromServer()
+    if sock.state() != QLocalSocket.LocalSocketState.UnconnectedState:
+        sock.waitForDisconnected(2000)
 
 
 class AsyncWorker(QThread):
@@ -449,10 +479,7 @@ class AIWindow(QMainWindow):
             QMessageBox.warning(self, "Ошибка", "Нет данных для вставки")
             return
         try:
-            with open(TEMP_OBJ_PATH, "w", encoding="utf-8") as f:
-                f.write(obj_data)
-            with open(FLAG_PATH, "w") as f:
-                f.write("insert")
+            send_model_to_editor(obj_data)
             QMessageBox.information(self, "Готово", "Модель отправлена в сцену")
         except Exception as e:
             QMessageBox.critical(self, "Ошибка", f"Не удалось отправить: {e}")
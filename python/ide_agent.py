@@ -1,4 +1,4 @@
-import sys, json, os, httpx
+import sys, json, os, asyncio, threading
 
 OPENROUTER_URL = "https://openrouter.ai/api/v1/chat/completions"
 DEFAULT_MODEL = "qwen/qwen-turbo"
@@ -16,7 +16,7 @@ def get_api_key():
         pass
     return ""
 
-async def fetch_suggestion(content: str, cursor: int, language: str, path: str) -> str:
+def build_request(content: str, cursor: int, language: str, path: str, stream: bool = False):
     headers = {"HTTP-Referer": "http://localhost", "X-Title": "SimpleCASCADE IDE"}
     api_key = get_api_key()
     if api_key:
@@ -36,13 +36,124 @@ async def fetch_suggestion(content: str, cursor: int, language: str, path: str)
         "temperature": 0.2,
         "max_tokens": 128,
     }
+    if stream:
+        payload["stream"] = True
+    return headers, payload
+
+async def fetch_suggestion(content: str, cursor: int, language: str, path: str) -> str:
+    import httpx
+    headers, payload = build_request(content, cursor, language, path)
     async with httpx.AsyncClient(timeout=20.0) as client:
         r = await client.post(OPENROUTER_URL, json=payload, headers=headers)
         r.raise_for_status()
         data = r.json()
         return data["choices"][0]["message"]["content"]
 
+# ===== Долгоживущий воркер (--serve): JSON Lines через stdin/stdout, см. AICompletion.hpp =====
+
+class Worker:
+    def __init__(self, stub: bool):
+        self.stub = stub
+        # Один клиент на всё время жизни: соединение и TLS переиспользуются между запросами.
+        # httpx импортируется только здесь — заглушке сеть не нужна
+        self.client = None
+        if not stub:
+            import httpx
+            self.client = httpx.AsyncClient(timeout=20.0)
+        self.tasks = {}
+
+    def send(self, message):
+        sys.stdout.write(json.dumps(message, ensure_ascii=False) + "\n")
+        sys.stdout.flush()
+
+    async def stream_remote(self, req):
+        headers, payload = build_request(req.get("content", ""), int(req.get("cursor", 0)),
+                                         req.get("language", ""), req.get("path", ""), stream=True)
+        async with self.client.stream("POST", OPENROUTER_URL, json=payload, headers=headers) as r:
+            r.raise_for_status()
+            async for line in r.aiter_lines():
+                if not line.startswith("data:"):
+                    continue
+                data = line[5:].strip()
+                if data == "[DONE]":
+                    break
+                try:
+                    delta = json.loads(data)["choices"][0].get("delta", {}).get("content") or ""
+                except (ValueError, KeyError, IndexError):
+                    continue
+                if delta:
+                    yield delta
+
+    async def stream_stub(self, req):
+        # Детерминированная заглушка: дописывает хвост текущей строки, кусками с задержкой
+        content, cursor = req.get("content", ""), int(req.get("cursor", 0))
+        line = content[:cursor].rsplit("\n", 1)[-1].strip()
+        for piece in ["// ", "stub: ", line[:32] or "completion"]:
+            await asyncio.sleep(0.05)
+            yield piece
+
+    async def complete(self, req):
+        rid = req.get("id")
+        text = ""
+        try:
+            source = self.stream_stub(req) if self.stub else self.stream_remote(req)
+            async for delta in source:
+                text += delta
+                self.send({"type": "partial", "id": rid, "text": text})
+            # done несёт всю подсказку целиком, без хвостовых пробелов: редактор заменяет ею накопленное из partial
+            self.send({"type": "done", "id": rid, "text": text.rstrip()})
+        except asyncio.CancelledError:
+            pass
+        except Exception as e:
+            self.send({"type": "error", "id": rid, "error": str(e)})
+        finally:
+            self.tasks.pop(rid, None)
+
+    def handle(self, msg):
+        kind = msg.get("type")
+        if kind == "complete":
+            # Значим только последний запрос — всё, что ещё в полёте, устарело
+            for task in list(self.tasks.values()):
+                task.cancel()
+            self.tasks[msg.get("id")] = asyncio.ensure_future(self.complete(msg))
+        elif kind == "cancel":
+            task = self.tasks.pop(msg.get("id"), None)
+            if task:
+                task.cancel()
+
+    async def run(self):
+        loop = asyncio.get_running_loop()
+        queue = asyncio.Queue()
+
+        # stdin читается в отдельном потоке: кроссплатформенного асинхронного stdin нет
+        def reader():
+            for raw in sys.stdin:
+                loop.call_soon_threadsafe(queue.put_nowait, raw)
+            loop.call_soon_threadsafe(queue.put_nowait, None)
+        threading.Thread(target=reader, daemon=True).start()
+
+        while True:
+            raw = await queue.get()
+            if raw is None:
+                break
+            try:
+                msg = json.loads(raw)
+            except ValueError:
+                continue
+            if isinstance(msg, dict):
+                self.handle(msg)
+        for task in list(self.tasks.values()):
+            task.cancel()
+        if self.client is not None:
+            await self.client.aclose()
+
+def serve(stub: bool):
+    asyncio.run(Worker(stub).run())
+
 def main():
+    if "--serve" in sys.argv:
+        serve("--stub" in sys.argv)
+        return
     raw = sys.stdin.read()
     try:
         body = json.loads(raw)
@@ -54,7 +165,6 @@ def main():
     language = body.get("language", "")
     path = body.get("path", "")
     try:
-        import asyncio
         text = asyncio.run(fetch_suggestion(content, cursor, language, path))
         print(text.strip(), end="")
     except Exception:
@@ -62,4 +172,3 @@ def main():
 
 if __name__ == "__main__":
     main()
-
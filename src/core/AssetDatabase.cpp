@@ -0,0 +1,195 @@
+// src/core/AssetDatabase.cpp
+#include "AssetDatabase.hpp"
+#include <QJsonArray>
+#include <QUuid>
+#include <cstring>
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "CookedMesh пишет массивы в порядке байт хоста");
+
+quint32 ImportSettings::hash() const {
+    // FNV-1a по полям: qHash не обещает одинаковых значений между версиями Qt
+    quint32 bits = 0;
+    std::memcpy(&bits, &scale, sizeof(bits));
+    quint32 h = 2166136261u;
+    for (quint32 v : {bits, quint32(centerPivot)}) {
+        for (int i = 0; i < 4; ++i) { h ^= (v >> (8 * i)) & 0xff; h *= 16777619u; }
+    }
+    return h;
+}
+
+void applyImportSettings(const ImportSettings &settings, std::vector<Vertex> &vertices) {
+    if (vertices.empty()) return;
+    Vertex offset{0, 0, 0};
+    if (settings.centerPivot) {
+        Vertex lo, hi;
+        computeAABB(vertices, lo, hi);
+        offset = {-(lo.x + hi.x) * 0.5f, -lo.y, -(lo.z + hi.z) * 0.5f};
+    }
+    if (settings.scale == 1.0f && !settings.centerPivot) return;
+    for (Vertex &v : vertices) {
+        v.x = (v.x + offset.x) * settings.scale;
+        v.y = (v.y + offset.y) * settings.scale;
+        v.z = (v.z + offset.z) * settings.scale;
+    }
+}
+
+namespace {
+
+template <typename T>
+void put(QByteArray &out, const T &v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+template <typename T>
+bool take(const char *&p, const char *end, T &v) {
+    if (static_cast<size_t>(end - p) < sizeof(v)) return false;
+    std::memcpy(&v, p, sizeof(v));
+    p += sizeof(v);
+    return true;
+}
+
+} // namespace
+
+QByteArray CookedMesh::save(const std::vector<Vertex> &vertices, const std::vector<Face> &faces,
+                            quint64 contentHash, quint32 settingsHash) {
+    size_t indexCount = 0;
+    for (const Face &f : faces) indexCount += f.indices.size();
+    QByteArray out;
+    out.reserve(qsizetype(StampBytes + 12 + vertices.size() * sizeof(Vertex) + faces.size() * 4 + indexCount * 4));
+    put(out, Magic);
+    put(out, Version);
+    put(out, contentHash);
+    put(out, settingsHash);
+    put(out, quint32(vertices.size()));
+    put(out, quint32(faces.size()));
+    put(out, quint32(indexCount));
+    out.append(reinterpret_cast<const char*>(vertices.data()), qsizetype(vertices.size() * sizeof(Vertex)));
+    for (const Face &f : faces) put(out, quint32(f.indices.size()));
+    for (const Face &f : faces) {
+        out.append(reinterpret_cast<const char*>(f.indices.data()), qsizetype(f.indices.size() * sizeof(int)));
+    }
+    return out;
+}
+
+bool CookedMesh::readStamp(const QByteArray &header, quint64 &contentHash, quint32 &settingsHash) {
+    const char *p = header.constData();
+    const char *end = p + header.size();
+    quint32 magic = 0, version = 0;
+    return take(p, end, magic) && magic == Magic && take(p, end, version) && version == Version
+        && take(p, end, contentHash) && take(p, end, settingsHash);
+}
+
+bool CookedMesh::load(const QByteArray &data, std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    quint64 contentHash = 0;
+    quint32 settingsHash = 0;
+    if (!readStamp(data, contentHash, settingsHash)) return false;
+    const char *p = data.constData() + StampBytes;
+    const char *end = data.constData() + data.size();
+    quint32 vertexCount = 0, faceCount = 0, indexCount = 0;
+    if (!take(p, end, vertexCount) || !take(p, end, faceCount) || !take(p, end, indexCount)) return false;
+    // Размеры проверяются до выделения памяти: битый заголовок не должен просить гигабайты
+    const size_t need = size_t(vertexCount) * sizeof(Vertex) + (size_t(faceCount) + indexCount) * 4;
+    if (static_cast<size_t>(end - p) != need) return false;
+
+    vertices.resize(vertexCount);
+    std::memcpy(vertices.data(), p, size_t(vertexCount) * sizeof(Vertex));
+    p += size_t(vertexCount) * sizeof(Vertex);
+    const char *sizes = p;
+    const char *indices = p + size_t(faceCount) * 4;
+    faces.assign(faceCount, Face());
+    size_t used = 0;
+    for (quint32 f = 0; f < faceCount; ++f) {
+        quint32 n = 0;
+        std::memcpy(&n, sizes + size_t(f) * 4, sizeof(n));
+        if (n > indexCount - used) return false;
+        faces[f].indices.resize(n);
+        std::memcpy(faces[f].indices.data(), indices + used * 4, size_t(n) * sizeof(int));
+        used += n;
+        for (int i : faces[f].indices) {
+            if (i < 0 || quint32(i) >= vertexCount) return false;
+        }
+    }
+    return used == indexCount;
+}
+
+void AssetDatabase::clear() {
+    m_records.clear();
+    m_byGuid.clear();
+    m_bySource.clear();
+}
+
+AssetRecord *AssetDatabase::find(const QString &guid) {
+    auto it = m_byGuid.constFind(guid);
+    return it == m_byGuid.cend() ? nullptr : &m_records[*it];
+}
+
+const AssetRecord *AssetDatabase::find(const QString &guid) const {
+    auto it = m_byGuid.constFind(guid);
+    return it == m_byGuid.cend() ? nullptr : &m_records[*it];
+}
+
+AssetRecord *AssetDatabase::findBySource(const QString &source) {
+    auto it = m_bySource.constFind(source);
+    return it == m_bySource.cend() ? nullptr : &m_records[*it];
+}
+
+AssetRecord &AssetDatabase::add(const QString &source, const QString &cookedDir) {
+    AssetRecord r;
+    r.guid = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    r.source = source;
+    r.cooked = cookedDir + "/" + r.guid + ".mesh";
+    m_byGuid.insert(r.guid, m_records.size());
+    m_bySource.insert(r.source, m_records.size());
+    m_records.push_back(std::move(r));
+    return m_records.back();
+}
+
+QJsonObject AssetDatabase::toJson() const {
+    QJsonArray arr;
+    for (const AssetRecord &r : m_records) {
+        arr.push_back(QJsonObject{
+            {"guid", r.guid},
+            {"source", r.source},
+            {"cooked", r.cooked},
+            {"hash", QString::number(r.contentHash, 16)},
+            // Миллисекунды и размеры за пределами 2^53 в JSON теряют точность — пишем строкой
+            {"mtime", QString::number(r.mtime)},
+            {"size", QString::number(r.size)},
+            {"settings", QJsonObject{{"scale", r.settings.scale}, {"centerPivot", r.settings.centerPivot}}},
+        });
+    }
+    return QJsonObject{{"version", Version}, {"assets", arr}};
+}
+
+bool AssetDatabase::fromJson(const QJsonObject &root, const QString &cookedDir) {
+    if (root.value("version").toInt() != Version || !root.value("assets").isArray()) return false;
+    std::vector<AssetRecord> records;
+    for (const auto &it : root.value("assets").toArray()) {
+        const QJsonObject jo = it.toObject();
+        // По cooked переимпорт пишет файл: путь вида "../../.bashrc" из правленой
+        // руками базы не должен дойти до QSaveFile
+        const QUuid uuid(jo.value("guid").toString());
+        AssetRecord r;
+        r.source = jo.value("source").toString();
+        if (uuid.isNull() || r.source.isEmpty()) continue;
+        r.guid = uuid.toString(QUuid::WithoutBraces);
+        r.cooked = cookedDir + "/" + r.guid + ".mesh";
+        r.contentHash = jo.value("hash").toString().toULongLong(nullptr, 16);
+        r.mtime = jo.value("mtime").toString().toLongLong();
+        r.size = jo.value("size").toString().toLongLong();
+        const QJsonObject settings = jo.value("settings").toObject();
+        r.settings.scale = float(settings.value("scale").toDouble(1.0));
+        r.settings.centerPivot = settings.value("centerPivot").toBool(false);
+        records.push_back(std::move(r));
+    }
+    m_records = std::move(records);
+    index();
+    return true;
+}
+
+void AssetDatabase::index() {
+    m_byGuid.clear();
+    m_bySource.clear();
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        m_byGuid.insert(m_records[i].guid, i);
+        m_bySource.insert(m_records[i].source, i);
+    }
+}
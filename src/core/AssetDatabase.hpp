@@ -0,0 +1,82 @@
+// src/core/AssetDatabase.hpp
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <vector>
+#include "Mesh.hpp"
+
+// Настройки импорта OBJ; меняются — ассет готовится заново
+struct ImportSettings {
+    float scale = 1.0f;
+    bool centerPivot = false; // начало координат — в центр основания AABB
+
+    // Попадает в заголовок готового меша: по нему видно, с какими настройками он собран
+    quint32 hash() const;
+    bool operator==(const ImportSettings &o) const { return scale == o.scale && centerPivot == o.centerPivot; }
+};
+
+void applyImportSettings(const ImportSettings &settings, std::vector<Vertex> &vertices);
+
+// Ассет проекта: исходный файл и его готовая (cooked) бинарная копия.
+// mtime/size — stat источника на момент импорта: совпали — источник не
+// перечитывается, меш берётся из cooked.
+struct AssetRecord {
+    QString guid;
+    QString source;           // относительно корня проекта; вне корня — абсолютный
+    QString cooked;           // относительно корня проекта
+    quint64 contentHash = 0;  // первые 8 байт MD5 источника; 0 — ещё не импортирован
+    qint64 mtime = 0;
+    qint64 size = 0;
+    ImportSettings settings;
+};
+
+// Готовый меш ассета (.mesh): массивы как есть (little-endian), читаются одним memcpy.
+//
+//   u32 magic 'SCCK', u32 version, u64 contentHash, u32 settingsHash,
+//   u32 vertexCount, u32 faceCount, u32 indexCount,
+//   f32[3*vertexCount], u32[faceCount] вершин в грани, i32[indexCount]
+namespace CookedMesh {
+    constexpr quint32 Magic = 0x4B434353; // "SCCK"
+    constexpr quint32 Version = 1;
+
+    QByteArray save(const std::vector<Vertex> &vertices, const std::vector<Face> &faces,
+                    quint64 contentHash, quint32 settingsHash);
+    bool load(const QByteArray &data, std::vector<Vertex> &vertices, std::vector<Face> &faces);
+    // Только заголовок — проверить, что cooked собран из того же источника с теми же настройками
+    bool readStamp(const QByteArray &header, quint64 &contentHash, quint32 &settingsHash);
+    constexpr int StampBytes = 4 + 4 + 8 + 4;
+}
+
+// База ассетов проекта (.simplecascade/assets.json). Живёт в GUI-потоке;
+// чтение источников и сборка cooked — в AssetPipeline.
+//
+//   {"version": 1, "assets": [{guid, source, cooked, hash (hex), mtime, size, settings{scale, centerPivot}}]}
+class AssetDatabase {
+public:
+    static constexpr int Version = 1;
+
+    void clear();
+    size_t size() const { return m_records.size(); }
+    const std::vector<AssetRecord> &records() const { return m_records; }
+    // Указатели живут до следующего add/fromJson
+    AssetRecord *find(const QString &guid);
+    const AssetRecord *find(const QString &guid) const;
+    AssetRecord *findBySource(const QString &source);
+    // Новая запись: новый GUID, cooked — в cookedDir/<guid>.mesh
+    AssetRecord &add(const QString &source, const QString &cookedDir);
+
+    QJsonObject toJson() const;
+    // false — не база ассетов или другой версии; содержимое тогда не меняется.
+    // Записи с GUID, не разбираемым как QUuid, пропускаются; cooked строится
+    // из GUID (cookedDir/<guid>.mesh), сохранённому пути не доверяем
+    bool fromJson(const QJsonObject &root, const QString &cookedDir);
+
+private:
+    void index();
+
+    std::vector<AssetRecord> m_records;
+    QHash<QString, size_t> m_byGuid;
+    QHash<QString, size_t> m_bySource;
+};
@@ -1 +1,52 @@
-// Будет выполнено в следующей версии
+// src/core/Engine3D.cpp
+#include "Engine3D.hpp"
+#include <QSurfaceFormat>
+#include <QVector4D>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void configureDefaultSurfaceFormat() {
+    QSurfaceFormat fmt;
+    fmt.setVersion(3, 3);
+    fmt.setProfile(QSurfaceFormat::CoreProfile);
+    fmt.setDepthBufferSize(24);
+    fmt.setSwapInterval(1); // vsync: Player рисует непрерывно и темп кадров задаёт экран
+    QSurfaceFormat::setDefaultFormat(fmt);
+}
+
+QMatrix4x4 makePerspective(float fovYDeg, float aspect, float zNear, float zFar) {
+    float f = 1.0f / std::tan((fovYDeg * M_PI / 180.0f) / 2.0f);
+    float top = zNear / f;
+    float right = top * aspect;
+    QMatrix4x4 m;
+    m.frustum(-right, right, -top, top, zNear, zFar);
+    return m;
+}
+
+bool aabbInFrustum(const QMatrix4x4 &viewProjection, const QVector3D &minV, const QVector3D &maxV) {
+    int outside[6] = {0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 8; ++i) {
+        const QVector4D c = viewProjection * QVector4D(i & 1 ? maxV.x() : minV.x(),
+                                                        i & 2 ? maxV.y() : minV.y(),
+                                                        i & 4 ? maxV.z() : minV.z(), 1.0f);
+        if (c.x() < -c.w()) ++outside[0];
+        if (c.x() >  c.w()) ++outside[1];
+        if (c.y() < -c.w()) ++outside[2];
+        if (c.y() >  c.w()) ++outside[3];
+        if (c.z() < -c.w()) ++outside[4];
+        if (c.z() >  c.w()) ++outside[5];
+    }
+    for (int n : outside) if (n == 8) return false;
+    return true;
+}
+
+QMatrix4x4 makeOrbitView(float rotXDeg, float rotYDeg, float tx, float ty, float tz) {
+    QMatrix4x4 m;
+    m.rotate(-rotXDeg, 1.0f, 0.0f, 0.0f);
+    m.rotate(-rotYDeg, 0.0f, 1.0f, 0.0f);
+    m.translate(tx, ty, tz);
+    return m;
+}
@@ -0,0 +1,20 @@
+// src/core/Engine3D.hpp
+#pragma once
+#include <QMatrix4x4>
+#include <QVector3D>
+
+// Общая математика камеры для редактора, редактора моделей и Player.
+
+// Core profile 3.3 для всех окон: рендерер работает только через GLSL/VAO/UBO.
+// Вызывать до создания QApplication.
+void configureDefaultSurfaceFormat();
+
+// Перспектива через gluPerspective-подобную математику (эквивалент glFrustum по FOV).
+QMatrix4x4 makePerspective(float fovYDeg, float aspect, float zNear, float zFar);
+
+// Грубый тест AABB против усечённой пирамиды: false, только если все 8 углов
+// лежат за одной и той же плоскостью отсечения.
+bool aabbInFrustum(const QMatrix4x4 &viewProjection, const QVector3D &minV, const QVector3D &maxV);
+
+// Вид «орбитальной» камеры: поворот по X, затем по Y, затем сдвиг (как glRotatef/glTranslatef раньше).
+QMatrix4x4 makeOrbitView(float rotXDeg, float rotYDeg, float tx, float ty, float tz);
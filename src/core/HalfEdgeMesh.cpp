@@ -0,0 +1,87 @@
+// src/core/HalfEdgeMesh.cpp
+#include "HalfEdgeMesh.hpp"
+#include <unordered_map>
+
+namespace {
+uint64_t undirectedKey(uint32_t a, uint32_t b) {
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+}
+
+void HalfEdgeMesh::clear() {
+    m_halfEdges.clear();
+    m_edges.clear();
+    m_faceHalfEdge.clear();
+    m_vertexEdgeStart.clear();
+    m_vertexEdges.clear();
+}
+
+void HalfEdgeMesh::build(size_t vertexCount, const std::vector<Face> &faces) {
+    clear();
+    size_t corners = 0;
+    for (const Face &f : faces) corners += f.indices.size();
+    m_halfEdges.reserve(corners);
+    m_edges.reserve(corners / 2 + 1);
+    m_faceHalfEdge.assign(faces.size(), None);
+
+    // Ребро -> первое полуребро, которое его создало
+    std::unordered_map<uint64_t, uint32_t> firstHalfEdge;
+    firstHalfEdge.reserve(corners);
+
+    for (size_t fi = 0; fi < faces.size(); ++fi) {
+        const std::vector<int> &idx = faces[fi].indices;
+        if (idx.size() < 3) continue;
+        bool valid = true;
+        for (int v : idx) valid = valid && v >= 0 && size_t(v) < vertexCount;
+        if (!valid) continue;
+
+        const uint32_t base = static_cast<uint32_t>(m_halfEdges.size());
+        const uint32_t n = static_cast<uint32_t>(idx.size());
+        m_faceHalfEdge[fi] = base;
+        for (uint32_t k = 0; k < n; ++k) {
+            const uint32_t from = static_cast<uint32_t>(idx[k]);
+            const uint32_t to = static_cast<uint32_t>(idx[(k + 1) % n]);
+            const uint32_t he = base + k;
+            HalfEdge h{from, to, base + (k + 1) % n, None, static_cast<uint32_t>(fi), None};
+
+            auto [it, inserted] = firstHalfEdge.emplace(undirectedKey(from, to), he);
+            if (inserted) {
+                h.edge = static_cast<uint32_t>(m_edges.size());
+                m_edges.push_back({from, to});
+            } else {
+                HalfEdge &first = m_halfEdges[it->second];
+                h.edge = first.edge;
+                // Встречное и ещё свободное — пара; иначе ребро неманифолдное
+                if (first.twin == None && first.from == to) {
+                    first.twin = he;
+                    h.twin = it->second;
+                }
+            }
+            m_halfEdges.push_back(h);
+        }
+    }
+
+    // CSR вершина -> рёбра: подсчёт, префиксная сумма, раскладка
+    m_vertexEdgeStart.assign(vertexCount + 1, 0);
+    for (const Edge &e : m_edges) {
+        ++m_vertexEdgeStart[e.a + 1];
+        ++m_vertexEdgeStart[e.b + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) m_vertexEdgeStart[v + 1] += m_vertexEdgeStart[v];
+    m_vertexEdges.resize(m_edges.size() * 2);
+    std::vector<uint32_t> fill(m_vertexEdgeStart.begin(), m_vertexEdgeStart.end() - 1);
+    for (uint32_t e = 0; e < m_edges.size(); ++e) {
+        m_vertexEdges[fill[m_edges[e].a]++] = e;
+        m_vertexEdges[fill[m_edges[e].b]++] = e;
+    }
+}
+
+std::vector<uint32_t> HalfEdgeMesh::edgeIndexPairs() const {
+    std::vector<uint32_t> pairs;
+    pairs.reserve(m_edges.size() * 2);
+    for (const Edge &e : m_edges) {
+        pairs.push_back(e.a);
+        pairs.push_back(e.b);
+    }
+    return pairs;
+}
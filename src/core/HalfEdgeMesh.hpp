@@ -0,0 +1,52 @@
+// src/core/HalfEdgeMesh.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Mesh.hpp"
+
+// Смежность полигонального меша для редактора. Строится по Vertex/Face за
+// один проход с хэш-таблицей рёбер; сами вершины не копируются.
+//
+// Полурёбра грани идут по кругу через next; twin — встречное полуребро
+// соседней грани (None на границе и у «лишних» граней неманифолдного ребра).
+// Каждое неориентированное ребро хранится один раз — из этого списка
+// строится оверлей рёбер, и общее ребро двух граней не рисуется дважды.
+class HalfEdgeMesh {
+public:
+    static constexpr uint32_t None = UINT32_MAX;
+
+    struct HalfEdge {
+        uint32_t from, to;
+        uint32_t next;
+        uint32_t twin;
+        uint32_t face;
+        uint32_t edge;
+    };
+    struct Edge { uint32_t a, b; };
+
+    // Грани с индексами вне диапазона и вырожденные (меньше 3 вершин) пропускаются
+    void build(size_t vertexCount, const std::vector<Face> &faces);
+    void clear();
+
+    size_t vertexCount() const { return m_vertexEdgeStart.empty() ? 0 : m_vertexEdgeStart.size() - 1; }
+    const std::vector<HalfEdge> &halfEdges() const { return m_halfEdges; }
+    const std::vector<Edge> &edges() const { return m_edges; }
+    // Первое полуребро грани; None — грань пропущена при построении
+    uint32_t faceHalfEdge(size_t face) const { return face < m_faceHalfEdge.size() ? m_faceHalfEdge[face] : None; }
+
+    // Рёбра, инцидентные вершине: [begin, end) в плотном массиве индексов рёбер
+    const uint32_t *vertexEdgesBegin(uint32_t v) const { return m_vertexEdges.data() + m_vertexEdgeStart[v]; }
+    const uint32_t *vertexEdgesEnd(uint32_t v) const { return m_vertexEdges.data() + m_vertexEdgeStart[v + 1]; }
+    uint32_t otherEnd(uint32_t edge, uint32_t v) const { return m_edges[edge].a == v ? m_edges[edge].b : m_edges[edge].a; }
+    bool isBoundary(uint32_t halfEdge) const { return m_halfEdges[halfEdge].twin == None; }
+
+    // Пары индексов вершин для GL_LINES — по одной на ребро
+    std::vector<uint32_t> edgeIndexPairs() const;
+
+private:
+    std::vector<HalfEdge> m_halfEdges;
+    std::vector<Edge> m_edges;
+    std::vector<uint32_t> m_faceHalfEdge;
+    std::vector<uint32_t> m_vertexEdgeStart; // CSR: vertexCount + 1
+    std::vector<uint32_t> m_vertexEdges;
+};
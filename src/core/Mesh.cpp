@@ -0,0 +1,138 @@
+// src/core/Mesh.cpp
+#include "Mesh.hpp"
+#include <sstream>
+
+namespace {
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline void skipSpaces(const char *&p, const char *end) {
+    while (p < end && isSpace(*p)) ++p;
+}
+
+// Разбор числа без strtof: тот зависит от LC_NUMERIC, а QApplication выставляет системную локаль.
+bool parseFloat(const char *&p, const char *end, float &out) {
+    const char *s = p;
+    bool neg = false;
+    if (s < end && (*s == '-' || *s == '+')) { neg = (*s == '-'); ++s; }
+    double value = 0.0;
+    bool digits = false;
+    while (s < end && *s >= '0' && *s <= '9') { value = value * 10.0 + (*s - '0'); ++s; digits = true; }
+    if (s < end && *s == '.') {
+        ++s;
+        double scale = 0.1;
+        while (s < end && *s >= '0' && *s <= '9') { value += (*s - '0') * scale; scale *= 0.1; ++s; digits = true; }
+    }
+    if (!digits) return false;
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char *e = s + 1;
+        bool eneg = false;
+        if (e < end && (*e == '-' || *e == '+')) { eneg = (*e == '-'); ++e; }
+        int exp = 0;
+        bool edigits = false;
+        while (e < end && *e >= '0' && *e <= '9') { exp = exp * 10 + (*e - '0'); ++e; edigits = true; }
+        if (edigits) {
+            double f = 1.0;
+            for (int i = 0; i < exp && i < 64; ++i) f *= 10.0;
+            value = eneg ? value / f : value * f;
+            s = e;
+        }
+    }
+    out = static_cast<float>(neg ? -value : value);
+    p = s;
+    return true;
+}
+
+bool parseInt(const char *&p, const char *end, int &out) {
+    const char *s = p;
+    bool neg = false;
+    if (s < end && (*s == '-' || *s == '+')) { neg = (*s == '-'); ++s; }
+    long long value = 0;
+    bool digits = false;
+    while (s < end && *s >= '0' && *s <= '9') { value = value * 10 + (*s - '0'); ++s; digits = true; if (value > 0x7fffffff) value = 0x7fffffff; }
+    if (!digits) return false;
+    out = static_cast<int>(neg ? -value : value);
+    p = s;
+    return true;
+}
+
+} // namespace
+
+ObjLineKind parseObjLine(const char *p, const char *end, size_t vertexCount, Vertex &vertex, std::vector<int> &face) {
+    skipSpaces(p, end);
+    if (end - p >= 2 && p[0] == 'v' && isSpace(p[1])) {
+        p += 2;
+        vertex = Vertex{0, 0, 0};
+        skipSpaces(p, end); parseFloat(p, end, vertex.x);
+        skipSpaces(p, end); parseFloat(p, end, vertex.y);
+        skipSpaces(p, end); parseFloat(p, end, vertex.z);
+        return ObjLineKind::Vertex;
+    }
+    if (end - p >= 2 && p[0] == 'f' && isSpace(p[1])) {
+        p += 2;
+        face.clear();
+        while (true) {
+            skipSpaces(p, end);
+            if (p >= end) break;
+            int idx = 0;
+            const bool ok = parseInt(p, end, idx);
+            // пропускаем /vt/vn и мусор до следующего пробела
+            while (p < end && !isSpace(*p)) ++p;
+            if (!ok) continue;
+            idx -= 1;
+            if (idx >= 0 && static_cast<size_t>(idx) < vertexCount) face.push_back(idx);
+        }
+        return face.size() >= 3 ? ObjLineKind::Face : ObjLineKind::Other;
+    }
+    return ObjLineKind::Other;
+}
+
+void parseObj(const char *data, size_t size, std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    vertices.clear();
+    faces.clear();
+    const char *p = data;
+    const char *end = data + size;
+    Vertex v{0, 0, 0};
+    std::vector<int> face;
+
+    while (p < end) {
+        const char *lineEnd = p;
+        while (lineEnd < end && *lineEnd != '\n') ++lineEnd;
+        switch (parseObjLine(p, lineEnd, vertices.size(), v, face)) {
+        case ObjLineKind::Vertex: vertices.push_back(v); break;
+        case ObjLineKind::Face: faces.push_back(Face{face}); break;
+        case ObjLineKind::Other: break;
+        }
+        p = lineEnd < end ? lineEnd + 1 : end;
+    }
+}
+
+std::string writeObj(const std::vector<Vertex> &vertices, const std::vector<Face> &faces) {
+    std::ostringstream out;
+    for (const auto &v : vertices) {
+        out << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
+    }
+    for (const auto &f : faces) {
+        if (f.indices.size() < 3) continue;
+        out << "f";
+        for (int idx : f.indices) out << ' ' << (idx + 1);
+        out << '\n';
+    }
+    return out.str();
+}
+
+std::string writeObjVertex(const Vertex &v) {
+    std::ostringstream out;
+    out << "v " << v.x << ' ' << v.y << ' ' << v.z;
+    return out.str();
+}
+
+void computeAABB(const std::vector<Vertex> &vertices, Vertex &minV, Vertex &maxV) {
+    if (vertices.empty()) { minV = {0,0,0}; maxV = {0,0,0}; return; }
+    minV = vertices[0];
+    maxV = minV;
+    for (const auto &v : vertices) {
+        if (v.x < minV.x) minV.x = v.x; if (v.y < minV.y) minV.y = v.y; if (v.z < minV.z) minV.z = v.z;
+        if (v.x > maxV.x) maxV.x = v.x; if (v.y > maxV.y) maxV.y = v.y; if (v.z > maxV.z) maxV.z = v.z;
+    }
+}
@@ -0,0 +1,29 @@
+// src/core/Mesh.hpp
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+
+struct Vertex { float x, y, z; };
+struct Face { std::vector<int> indices; };
+static_assert(sizeof(Vertex) == 3 * sizeof(float), "Vertex массивы передаются в GL как float[3]");
+
+// Разбор Wavefront OBJ (только v и f). Индексы граней проверяются по числу
+// уже прочитанных вершин; вершины с текстурой/нормалью (v/vt/vn) сводятся к v.
+void parseObj(const char *data, size_t size, std::vector<Vertex> &vertices, std::vector<Face> &faces);
+inline void parseObj(const std::string &data, std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    parseObj(data.data(), data.size(), vertices, faces);
+}
+
+// Разбор одной строки [p, end) без перевода строки. vertexCount — сколько вершин
+// объявлено выше: индексы грани проверяются по нему, как в parseObj
+// (SIZE_MAX — отсекаются только отрицательные).
+// Грань, в которой осталось меньше трёх индексов, считается прочей строкой.
+enum class ObjLineKind : unsigned char { Other, Vertex, Face };
+ObjLineKind parseObjLine(const char *p, const char *end, size_t vertexCount, Vertex &vertex, std::vector<int> &face);
+
+std::string writeObj(const std::vector<Vertex> &vertices, const std::vector<Face> &faces);
+// Строка "v x y z" в том же формате, что пишет writeObj
+std::string writeObjVertex(const Vertex &v);
+
+void computeAABB(const std::vector<Vertex> &vertices, Vertex &minV, Vertex &maxV);
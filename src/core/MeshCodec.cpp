@@ -0,0 +1,206 @@
+// src/core/MeshCodec.cpp
+#include "MeshCodec.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+constexpr int CacheSize = 16;
+constexpr uint8_t CodeNew = CacheSize;
+constexpr uint8_t CodeExplicit = CacheSize + 1;
+constexpr uint8_t SizeEscape = 255;
+// Меньше — второй поток дороже, чем сам разбор позиций
+constexpr uint32_t ParallelVertices = 1u << 16;
+
+struct Header {
+    quint32 magic, version, vertexCount, faceCount, indexCount;
+    float bounds[6];
+    quint32 rawSize;
+};
+
+inline uint32_t zigzag(int32_t v) { return (uint32_t(v) << 1) ^ uint32_t(v >> 31); }
+inline int32_t unzigzag(uint32_t v) { return int32_t(v >> 1) ^ -int32_t(v & 1); }
+
+void putVarint(std::vector<uint8_t> &out, uint32_t v) {
+    while (v >= 0x80) { out.push_back(uint8_t(v | 0x80)); v >>= 7; }
+    out.push_back(uint8_t(v));
+}
+
+bool getVarint(const uint8_t *&p, const uint8_t *end, uint32_t &v) {
+    v = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        const uint8_t b = *p++;
+        v |= uint32_t(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Кэш последних вершин: FIFO, попадание порядок не меняет — кодер и декодер
+// обновляют его одинаково
+class VertexCache {
+public:
+    VertexCache() { m_slots.fill(-1); }
+    int find(int v) const {
+        for (int i = 0; i < CacheSize; ++i) if (m_slots[i] == v) return i;
+        return -1;
+    }
+    int at(int slot) const { return m_slots[slot]; }
+    void push(int v) { m_slots[m_next] = v; m_next = (m_next + 1) % CacheSize; }
+private:
+    std::array<int, CacheSize> m_slots;
+    int m_next = 0;
+};
+
+void decodePositions(const uint8_t *planes, uint32_t count, const float *bounds, std::vector<Vertex> &vertices) {
+    vertices.resize(count);
+    for (int c = 0; c < 3; ++c) {
+        const uint8_t *lo = planes + size_t(2 * c) * count;
+        const uint8_t *hi = lo + count;
+        const float origin = bounds[c];
+        const float step = (bounds[3 + c] - bounds[c]) / 65535.0f;
+        uint16_t q = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            q = uint16_t(q + unzigzag(uint32_t(lo[i]) | (uint32_t(hi[i]) << 8)));
+            (&vertices[i].x)[c] = origin + q * step;
+        }
+    }
+}
+
+bool decodeFaces(const uint8_t *sizes, const uint8_t *codes, const uint8_t *extra, const uint8_t *end,
+                 const Header &h, std::vector<Face> &faces) {
+    faces.resize(h.faceCount);
+    VertexCache cache;
+    const uint8_t *codesEnd = codes + h.indexCount;
+    int next = 0, last = 0;
+    for (uint32_t f = 0; f < h.faceCount; ++f) {
+        uint32_t n = sizes[f];
+        if (n == SizeEscape && !getVarint(extra, end, n)) return false;
+        n += 3;
+        if (size_t(codesEnd - codes) < n) return false;
+        std::vector<int> &indices = faces[f].indices;
+        indices.resize(n);
+        for (uint32_t k = 0; k < n; ++k) {
+            const uint8_t code = *codes++;
+            int v;
+            if (code < CacheSize) {
+                v = cache.at(code);
+            } else if (code == CodeNew) {
+                v = next;
+            } else if (code == CodeExplicit) {
+                uint32_t d;
+                if (!getVarint(extra, end, d)) return false;
+                v = last + unzigzag(d);
+            } else {
+                return false;
+            }
+            if (v < 0 || uint32_t(v) >= h.vertexCount) return false;
+            if (code >= CacheSize) cache.push(v);
+            if (v == next) ++next;
+            last = v;
+            indices[k] = v;
+        }
+    }
+    return codes == codesEnd;
+}
+
+} // namespace
+
+QByteArray MeshCodec::encode(const std::vector<Vertex> &vertices, const std::vector<Face> &faces) {
+    Header h{};
+    h.magic = Magic;
+    h.version = Version;
+    h.vertexCount = static_cast<quint32>(vertices.size());
+    Vertex lo, hi;
+    computeAABB(vertices, lo, hi);
+    h.bounds[0] = lo.x; h.bounds[1] = lo.y; h.bounds[2] = lo.z;
+    h.bounds[3] = hi.x; h.bounds[4] = hi.y; h.bounds[5] = hi.z;
+
+    const size_t count = vertices.size();
+    std::vector<uint8_t> raw(count * 6);
+    for (int c = 0; c < 3; ++c) {
+        uint8_t *planeLo = raw.data() + size_t(2 * c) * count;
+        uint8_t *planeHi = planeLo + count;
+        const float extent = h.bounds[3 + c] - h.bounds[c];
+        const float scale = extent > 0.0f ? 65535.0f / extent : 0.0f;
+        uint16_t prev = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const float t = ((&vertices[i].x)[c] - h.bounds[c]) * scale;
+            const uint16_t q = uint16_t(std::clamp(std::lround(t), 0L, 65535L));
+            const uint32_t d = zigzag(int16_t(uint16_t(q - prev)));
+            planeLo[i] = uint8_t(d);
+            planeHi[i] = uint8_t(d >> 8);
+            prev = q;
+        }
+    }
+
+    // Грани с висячими индексами не пишутся: декодер такие отвергает.
+    // extra заполняется в порядке чтения декодером: размер грани, затем её индексы
+    std::vector<uint8_t> sizes, codes, extra;
+    sizes.reserve(faces.size());
+    codes.reserve(faces.size() * 3);
+    VertexCache cache;
+    int next = 0, last = 0;
+    for (const Face &f : faces) {
+        if (f.indices.size() < 3) continue;
+        if (std::any_of(f.indices.begin(), f.indices.end(), [count](int v){ return v < 0 || size_t(v) >= count; })) continue;
+        const size_t n = f.indices.size() - 3;
+        if (n < SizeEscape) {
+            sizes.push_back(uint8_t(n));
+        } else {
+            sizes.push_back(SizeEscape);
+            putVarint(extra, uint32_t(n));
+        }
+        for (int v : f.indices) {
+            const int slot = cache.find(v);
+            if (slot >= 0) {
+                codes.push_back(uint8_t(slot));
+            } else {
+                codes.push_back(v == next ? CodeNew : CodeExplicit);
+                if (v != next) putVarint(extra, zigzag(v - last));
+                cache.push(v);
+            }
+            if (v == next) ++next;
+            last = v;
+        }
+    }
+    h.faceCount = static_cast<quint32>(sizes.size());
+    h.indexCount = static_cast<quint32>(codes.size());
+
+    raw.insert(raw.end(), sizes.begin(), sizes.end());
+    raw.insert(raw.end(), codes.begin(), codes.end());
+    raw.insert(raw.end(), extra.begin(), extra.end());
+    h.rawSize = static_cast<quint32>(raw.size());
+
+    QByteArray out(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.append(qCompress(reinterpret_cast<const uchar*>(raw.data()), static_cast<qsizetype>(raw.size())));
+    return out;
+}
+
+bool MeshCodec::decode(const QByteArray &data, std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    Header h;
+    if (data.size() < qsizetype(sizeof(h))) return false;
+    std::memcpy(&h, data.constData(), sizeof(h));
+    if (h.magic != Magic || h.version < 1 || h.version > Version) return false;
+    const QByteArray raw = qUncompress(reinterpret_cast<const uchar*>(data.constData() + sizeof(h)), data.size() - qsizetype(sizeof(h)));
+    const size_t planes = size_t(h.vertexCount) * 6;
+    if (size_t(raw.size()) != h.rawSize || size_t(raw.size()) < planes + size_t(h.faceCount) + size_t(h.indexCount)) return false;
+
+    const uint8_t *p = reinterpret_cast<const uint8_t*>(raw.constData());
+    const uint8_t *end = p + raw.size();
+    const uint8_t *sizes = p + planes;
+    const uint8_t *codes = sizes + h.faceCount;
+    const uint8_t *extra = codes + h.indexCount;
+    if (h.vertexCount >= ParallelVertices) {
+        // Потоки независимы: позиции — во втором потоке, пока этот разбирает грани
+        std::thread positions([&]{ decodePositions(p, h.vertexCount, h.bounds, vertices); });
+        const bool ok = decodeFaces(sizes, codes, extra, end, h, faces);
+        positions.join();
+        return ok;
+    }
+    decodePositions(p, h.vertexCount, h.bounds, vertices);
+    return decodeFaces(sizes, codes, extra, end, h, faces);
+}
@@ -0,0 +1,28 @@
+// src/core/MeshCodec.hpp
+#pragma once
+#include <QByteArray>
+#include <vector>
+#include "Mesh.hpp"
+
+// Как меш хранится в .scene: текстом OBJ (без потерь) или сжатым (MeshCodec)
+enum class MeshEncoding { Obj, Quantized };
+
+// Сжатый меш (поле mesh_q в .scene, base64). Позиции теряют точность:
+// квантуются в 16 бит на компоненту по AABB меша.
+//
+//   u32 magic 'SCMQ', u32 version, u32 vertexCount, u32 faceCount, u32 indexCount,
+//   f32[6] AABB, u32 rawSize, qCompress(потоки)
+//   потоки: 6 байтовых плоскостей разностей позиций (x lo, x hi, y lo, ...),
+//           байт на грань (вершин - 3, 255 — число в extra),
+//           байт на индекс (0..15 — слот кэша последних вершин, 16 — следующая
+//           новая вершина, 17 — разность с прошлым индексом в extra),
+//           extra — varint'ы
+// Байтовые плоскости и коды кэша почти однородны, и zlib сжимает их в разы лучше текста.
+namespace MeshCodec {
+    constexpr quint32 Magic = 0x514D4353; // "SCMQ"
+    constexpr quint32 Version = 1;
+
+    QByteArray encode(const std::vector<Vertex> &vertices, const std::vector<Face> &faces);
+    // Большие меши разбирают позиции и индексы в двух потоках
+    bool decode(const QByteArray &data, std::vector<Vertex> &vertices, std::vector<Face> &faces);
+}
@@ -0,0 +1,89 @@
+// src/core/ObjLineMap.cpp
+#include "ObjLineMap.hpp"
+#include <algorithm>
+#include <cstdint>
+
+void ObjLineMap::reset(const char *data, size_t size, std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    vertices.clear();
+    faces.clear();
+    m_vertexLines.clear();
+    m_faceLines.clear();
+    const char *p = data;
+    const char *end = data + size;
+    Vertex v{0, 0, 0};
+    std::vector<int> face;
+    uint32_t line = 0;
+    // Строк на одну больше, чем переводов строки, — как блоков в QTextDocument
+    while (true) {
+        const char *lineEnd = p;
+        while (lineEnd < end && *lineEnd != '\n') ++lineEnd;
+        switch (parseObjLine(p, lineEnd, SIZE_MAX, v, face)) {
+        case ObjLineKind::Vertex: vertices.push_back(v); m_vertexLines.push_back(line); break;
+        case ObjLineKind::Face: faces.push_back(Face{face}); m_faceLines.push_back(line); break;
+        case ObjLineKind::Other: break;
+        }
+        ++line;
+        if (lineEnd >= end) break;
+        p = lineEnd + 1;
+    }
+    m_lineCount = line;
+}
+
+ObjLineMap::Patch ObjLineMap::replaceLines(size_t first, size_t removed, const std::vector<std::string> &lines,
+                                           std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    Patch patch;
+    const auto lineBound = [](std::vector<uint32_t> &list, size_t line) {
+        return static_cast<size_t>(std::lower_bound(list.begin(), list.end(), line) - list.begin());
+    };
+    const size_t vb = lineBound(m_vertexLines, first), ve = lineBound(m_vertexLines, first + removed);
+    const size_t fb = lineBound(m_faceLines, first), fe = lineBound(m_faceLines, first + removed);
+
+    // Разбираются только новые строки
+    std::vector<Vertex> newVertices;
+    std::vector<uint32_t> newVertexLines;
+    std::vector<Face> newFaces;
+    std::vector<uint32_t> newFaceLines;
+    Vertex v{0, 0, 0};
+    std::vector<int> face;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const std::string &text = lines[i];
+        const uint32_t line = static_cast<uint32_t>(first + i);
+        switch (parseObjLine(text.data(), text.data() + text.size(), SIZE_MAX, v, face)) {
+        case ObjLineKind::Vertex: newVertices.push_back(v); newVertexLines.push_back(line); break;
+        case ObjLineKind::Face: newFaces.push_back(Face{face}); newFaceLines.push_back(line); break;
+        case ObjLineKind::Other: break;
+        }
+    }
+
+    if (ve - vb == newVertices.size() && fb == fe && newFaces.empty()) {
+        // Те же вершины на месте: только координаты
+        for (size_t i = 0; i < newVertices.size(); ++i) {
+            Vertex &old = vertices[vb + i];
+            const Vertex &nv = newVertices[i];
+            if (old.x != nv.x || old.y != nv.y || old.z != nv.z) {
+                old = nv;
+                patch.moved.push_back(static_cast<uint32_t>(vb + i));
+            }
+            m_vertexLines[vb + i] = newVertexLines[i];
+        }
+    } else {
+        patch.structural = true;
+        vertices.erase(vertices.begin() + vb, vertices.begin() + ve);
+        vertices.insert(vertices.begin() + vb, newVertices.begin(), newVertices.end());
+        m_vertexLines.erase(m_vertexLines.begin() + vb, m_vertexLines.begin() + ve);
+        m_vertexLines.insert(m_vertexLines.begin() + vb, newVertexLines.begin(), newVertexLines.end());
+        faces.erase(faces.begin() + fb, faces.begin() + fe);
+        faces.insert(faces.begin() + fb, newFaces.begin(), newFaces.end());
+        m_faceLines.erase(m_faceLines.begin() + fb, m_faceLines.begin() + fe);
+        m_faceLines.insert(m_faceLines.begin() + fb, newFaceLines.begin(), newFaceLines.end());
+    }
+
+    // Элементы ниже правки съезжают на разницу в числе строк
+    const int64_t delta = int64_t(lines.size()) - int64_t(removed);
+    if (delta != 0) {
+        for (size_t i = vb + newVertices.size(); i < m_vertexLines.size(); ++i) m_vertexLines[i] = uint32_t(m_vertexLines[i] + delta);
+        for (size_t i = fb + newFaces.size(); i < m_faceLines.size(); ++i) m_faceLines[i] = uint32_t(m_faceLines[i] + delta);
+    }
+    m_lineCount = size_t(int64_t(m_lineCount) + delta);
+    return patch;
+}
@@ -0,0 +1,41 @@
+// src/core/ObjLineMap.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Mesh.hpp"
+
+// Соответствие строк OBJ-текста вершинам и граням — для правок без полного
+// разбора. Вершина i объявлена в строке vertexLine(i), грань j — в faceLine(j);
+// оба списка отсортированы, так что строка -> элемент ищется бинарным поиском.
+//
+// replaceLines() разбирает только новые строки и вклеивает результат в
+// массивы вершин/граней. Правка, не меняющая число вершин и не задевающая
+// грани, сводится к списку сдвинутых вершин; иначе патч структурный.
+//
+// Индексы граней здесь не проверяются по числу вершин: иначе вставка вершины
+// меняла бы допустимость граней ниже правки, и их пришлось бы разбирать
+// заново. Ссылки за пределы массива отбрасывают потребители
+// (Renderer::ensureMesh, HalfEdgeMesh).
+class ObjLineMap {
+public:
+    struct Patch {
+        bool structural = false;        // изменился состав вершин или грани
+        std::vector<uint32_t> moved;    // вершины с новыми координатами (если не structural)
+    };
+
+    // Полный разбор текста; массивы перезаписываются
+    void reset(const char *data, size_t size, std::vector<Vertex> &vertices, std::vector<Face> &faces);
+    // Строки [first, first + removed) заменены на lines
+    Patch replaceLines(size_t first, size_t removed, const std::vector<std::string> &lines,
+                       std::vector<Vertex> &vertices, std::vector<Face> &faces);
+
+    size_t lineCount() const { return m_lineCount; }
+    size_t vertexLine(uint32_t v) const { return m_vertexLines[v]; }
+    size_t faceLine(uint32_t f) const { return m_faceLines[f]; }
+
+private:
+    size_t m_lineCount = 0;
+    std::vector<uint32_t> m_vertexLines;
+    std::vector<uint32_t> m_faceLines;
+};
@@ -0,0 +1,134 @@
+// src/core/OffscreenRenderer.cpp
+#include "OffscreenRenderer.hpp"
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+#include "Engine3D.hpp"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+OffscreenRenderer::OffscreenRenderer() {
+    m_lights = {
+        {QVector3D(5.0f, 10.0f, 5.0f)},
+        {QVector3D(-5.0f, 3.0f, -5.0f)},
+    };
+}
+
+OffscreenRenderer::~OffscreenRenderer() {
+    if (!m_context || !m_context->makeCurrent(m_surface.get())) return;
+    m_fbo.reset();
+    m_renderer.cleanup();
+    m_context->doneCurrent();
+}
+
+bool OffscreenRenderer::initialize(QString *error) {
+    if (isInitialized()) return true;
+    auto fail = [error](const QString &message) {
+        if (error) *error = message;
+        return false;
+    };
+    m_context = std::make_unique<QOpenGLContext>();
+    m_context->setFormat(QSurfaceFormat::defaultFormat());
+    if (!m_context->create()) return fail("Не удалось создать GL-контекст");
+    m_surface = std::make_unique<QOffscreenSurface>();
+    m_surface->setFormat(m_context->format());
+    m_surface->create();
+    if (!m_surface->isValid() || !m_context->makeCurrent(m_surface.get())) return fail("Нет offscreen-поверхности");
+
+    m_renderer.initialize();
+    // Тайл упирается в меньший из пределов: рендербуфер, текстура, вьюпорт
+    QOpenGLFunctions *gl = m_context->functions();
+    GLint renderbuffer = 0, texture = 0, viewport[2] = {0, 0};
+    gl->glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &renderbuffer);
+    gl->glGetIntegerv(GL_MAX_TEXTURE_SIZE, &texture);
+    gl->glGetIntegerv(GL_MAX_VIEWPORT_DIMS, viewport);
+    m_driverMaxSize = std::max(1, std::min({renderbuffer, texture, viewport[0], viewport[1]}));
+    m_context->doneCurrent();
+    return isInitialized() ? true : fail("Рендерер не инициализирован");
+}
+
+int OffscreenRenderer::tileSize() const {
+    return std::max(1, m_driverMaxSize > 0 ? std::min(m_maxTileSize, m_driverMaxSize) : m_maxTileSize);
+}
+
+QImage OffscreenRenderer::render(const QSize &size, const QMatrix4x4 &view, const QMatrix4x4 &projection, const DrawFn &draw) {
+    if (!isInitialized() || size.isEmpty() || !m_context->makeCurrent(m_surface.get())) return QImage();
+    m_renderer.setLights(m_lights);
+
+    const int tile = tileSize();
+    QImage image;
+    if (size.width() <= tile && size.height() <= tile) {
+        drawTile(size, view, projection, draw);
+        image = m_fbo->toImage();
+    } else {
+        image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        const float w = float(size.width()), h = float(size.height());
+        for (int y0 = 0; y0 < size.height(); y0 += tile) {
+            for (int x0 = 0; x0 < size.width(); x0 += tile) {
+                const int tw = std::min(tile, size.width() - x0);
+                const int th = std::min(tile, size.height() - y0);
+                // Кусок NDC под тайлом (y в NDC — вверх, в картинке — вниз)
+                const float left = 2.0f * x0 / w - 1.0f, right = 2.0f * (x0 + tw) / w - 1.0f;
+                const float top = 1.0f - 2.0f * y0 / h, bottom = 1.0f - 2.0f * (y0 + th) / h;
+                const QMatrix4x4 crop(2.0f / (right - left), 0.0f, 0.0f, -(right + left) / (right - left),
+                                      0.0f, 2.0f / (top - bottom), 0.0f, -(top + bottom) / (top - bottom),
+                                      0.0f, 0.0f, 1.0f, 0.0f,
+                                      0.0f, 0.0f, 0.0f, 1.0f);
+                drawTile(QSize(tw, th), view, crop * projection, draw);
+                painter.drawImage(x0, y0, m_fbo->toImage());
+            }
+        }
+    }
+    m_context->doneCurrent();
+    return image;
+}
+
+void OffscreenRenderer::drawTile(const QSize &size, const QMatrix4x4 &view, const QMatrix4x4 &projection, const DrawFn &draw) {
+    if (!m_fbo || m_fbo->size() != size) {
+        QOpenGLFramebufferObjectFormat format;
+        format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+        format.setSamples(m_samples);
+        m_fbo = std::make_unique<QOpenGLFramebufferObject>(size, format);
+    }
+    m_fbo->bind();
+    QOpenGLFunctions *gl = m_context->functions();
+    gl->glViewport(0, 0, size.width(), size.height());
+    gl->glClearColor(m_background.redF(), m_background.greenF(), m_background.blueF(), m_background.alphaF());
+    gl->glEnable(GL_DEPTH_TEST);
+    gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    m_renderer.beginFrame(view, projection);
+    draw(m_renderer);
+    m_renderer.flush();
+    m_fbo->release();
+}
+
+void OffscreenRenderer::releaseMeshes(const std::vector<uint64_t> &keys) {
+    if (!isInitialized() || !m_context->makeCurrent(m_surface.get())) return;
+    for (uint64_t key : keys) m_renderer.releaseMesh(key);
+    m_context->doneCurrent();
+}
+
+void OffscreenRenderer::frameBounds(const QVector3D &lo, const QVector3D &hi, float aspect, QMatrix4x4 &view, QMatrix4x4 &projection) {
+    const float fovY = 40.0f;
+    const QVector3D center = (lo + hi) * 0.5f;
+    const float radius = std::max((hi - lo).length() * 0.5f, 1e-3f);
+    // Сфера границ вписывается в более узкий из углов обзора
+    const float halfY = float(fovY * M_PI / 360.0);
+    const float halfX = std::atan(std::tan(halfY) * std::max(aspect, 1e-3f));
+    const float distance = radius / std::sin(std::min(halfX, halfY));
+    // Центр границ — в центр кадра; взгляд сверху под 30° и сбоку под 45°
+    view.setToIdentity();
+    view.translate(0.0f, 0.0f, -distance);
+    view.rotate(30.0f, 1.0f, 0.0f, 0.0f);
+    view.rotate(-45.0f, 0.0f, 1.0f, 0.0f);
+    view.translate(-center);
+    projection = makePerspective(fovY, aspect, std::max(distance - radius * 1.5f, distance * 0.01f), distance + radius * 1.5f);
+}
@@ -0,0 +1,62 @@
+// src/core/OffscreenRenderer.hpp
+#pragma once
+#include <QColor>
+#include <QImage>
+#include <QMatrix4x4>
+#include <QSize>
+#include <QString>
+#include <QVector3D>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Renderer.hpp"
+
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
+
+// Отрисовка без окна: свой GL-контекст на QOffscreenSurface, свой Renderer,
+// кадр — в FBO. Размер кадра не ограничен пределами драйвера: больший кадр
+// режется на тайлы, проекция тайла — проекция кадра, растянутая на его кусок
+// NDC, поэтому швов на стыках нет.
+//
+// Живёт в потоке, который его создал (QOffscreenSurface — только GUI-поток).
+class OffscreenRenderer {
+public:
+    // Заполняет очередь renderer (beginFrame уже вызван, flush — после);
+    // при тайлах вызывается на каждый тайл
+    using DrawFn = std::function<void(Renderer &renderer)>;
+
+    OffscreenRenderer();
+    ~OffscreenRenderer();
+
+    bool initialize(QString *error = nullptr);
+    bool isInitialized() const { return m_renderer.isInitialized(); }
+
+    void setBackground(const QColor &color) { m_background = color; }
+    void setLights(const std::vector<RenderLight> &lights) { m_lights = lights; }
+    void setSamples(int samples) { m_samples = samples; }
+    // Сторона тайла не больше этой и не больше предела драйвера
+    void setMaxTileSize(int px) { m_maxTileSize = px; }
+    int tileSize() const;
+
+    QImage render(const QSize &size, const QMatrix4x4 &view, const QMatrix4x4 &projection, const DrawFn &draw);
+    // Меши, отрисованные однажды (превью), — освободить сразу
+    void releaseMeshes(const std::vector<uint64_t> &keys);
+
+    // Камера, в кадр которой целиком попадает AABB
+    static void frameBounds(const QVector3D &lo, const QVector3D &hi, float aspect, QMatrix4x4 &view, QMatrix4x4 &projection);
+
+private:
+    void drawTile(const QSize &size, const QMatrix4x4 &view, const QMatrix4x4 &projection, const DrawFn &draw);
+
+    std::unique_ptr<QOffscreenSurface> m_surface;
+    std::unique_ptr<QOpenGLContext> m_context;
+    std::unique_ptr<QOpenGLFramebufferObject> m_fbo; // пересоздаётся при смене размера тайла
+    Renderer m_renderer;
+    QColor m_background = QColor::fromRgbF(0.1f, 0.12f, 0.16f);
+    std::vector<RenderLight> m_lights;
+    int m_samples = 4;
+    int m_maxTileSize = 4096;
+    int m_driverMaxSize = 0;
+};
@@ -0,0 +1,520 @@
+// src/core/Renderer.cpp
+#include "Renderer.hpp"
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+
+namespace {
+
+// Раскладка std140 — должна совпадать с блоками в шейдерах ниже.
+struct CameraBlock {
+    float view[16];
+    float projection[16];
+    float viewProjection[16];
+    float eye[4];
+};
+
+struct LightsBlock {
+    int32_t count[4];
+    struct { float position[4]; float color[4]; } lights[Renderer::MaxLights];
+};
+
+constexpr GLuint CameraBinding = 0;
+constexpr GLuint LightsBinding = 1;
+
+// Сколько кадров меш может не использоваться, прежде чем его буферы освободят.
+constexpr uint64_t MeshEvictFrames = 300;
+
+const char *kBlocks = R"(
+layout(std140) uniform Camera {
+    mat4 uView;
+    mat4 uProjection;
+    mat4 uViewProjection;
+    vec4 uEye;
+};
+)";
+
+const char *kMeshVertex = R"(
+layout(location = 0) in vec3 aPos;
+uniform mat4 uModel;
+out vec3 vWorldPos;
+void main() {
+    vec4 wp = uModel * vec4(aPos, 1.0);
+    vWorldPos = wp.xyz;
+    gl_Position = uViewProjection * wp;
+}
+)";
+
+const char *kLitFragment = R"(
+struct Light { vec4 position; vec4 color; };
+layout(std140) uniform Lights {
+    ivec4 uLightCount;
+    Light uLights[32];
+};
+in vec3 vWorldPos;
+uniform vec3 uColor;
+out vec4 fragColor;
+void main() {
+    // Плоская нормаль грани из производных — нормали не хранятся в VBO.
+    vec3 n = normalize(cross(dFdx(vWorldPos), dFdy(vWorldPos)));
+    if (dot(n, uEye.xyz - vWorldPos) < 0.0) n = -n;
+    // Рассеянный свет — один на сцену, иначе яркость росла бы с числом источников
+    float ambient = 0.0;
+    vec3 diffuse = vec3(0.0);
+    for (int i = 0; i < uLightCount.x; ++i) {
+        vec3 l = normalize(uLights[i].position.xyz - vWorldPos);
+        ambient = max(ambient, uLights[i].color.w);
+        diffuse += uLights[i].color.rgb * max(dot(n, l), 0.0);
+    }
+    fragColor = vec4(min(uColor * (ambient + diffuse), vec3(1.0)), 1.0);
+}
+)";
+
+const char *kUnlitFragment = R"(
+in vec3 vWorldPos;
+uniform vec3 uColor;
+out vec4 fragColor;
+void main() { fragColor = vec4(uColor, 1.0); }
+)";
+
+const char *kColorVertex = R"(
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aColor;
+uniform mat4 uModel;
+uniform vec4 uTint;
+out vec3 vColor;
+void main() {
+    vColor = mix(aColor, uTint.rgb, uTint.a);
+    gl_Position = uViewProjection * uModel * vec4(aPos, 1.0);
+}
+)";
+
+const char *kColorFragment = R"(
+in vec3 vColor;
+out vec4 fragColor;
+void main() { fragColor = vec4(vColor, 1.0); }
+)";
+
+// Ближняя и дальняя точки луча через пиксель; для фиксированной глубины
+// обратная проекция аффинна по экрану, так что интерполяция точна.
+const char *kGridVertex = R"(
+uniform mat4 uInvViewProjection;
+out vec3 vNear;
+out vec3 vFar;
+vec3 unproject(vec2 xy, float z) {
+    vec4 p = uInvViewProjection * vec4(xy, z, 1.0);
+    return p.xyz / p.w;
+}
+void main() {
+    vec2 xy = vec2((gl_VertexID == 1) ? 3.0 : -1.0, (gl_VertexID == 2) ? 3.0 : -1.0);
+    vNear = unproject(xy, -1.0);
+    vFar = unproject(xy, 1.0);
+    gl_Position = vec4(xy, 0.0, 1.0);
+}
+)";
+
+const char *kGridFragment = R"(
+in vec3 vNear;
+in vec3 vFar;
+uniform float uCell;
+uniform float uFade;
+uniform vec3 uGridColor;
+uniform vec3 uAxisX;
+uniform vec3 uAxisZ;
+out vec4 fragColor;
+float lines(vec2 p, float cell) {
+    vec2 c = p / cell;
+    vec2 d = fwidth(c);
+    vec2 g = abs(fract(c - 0.5) - 0.5) / d;
+    return 1.0 - min(min(g.x, g.y), 1.0);
+}
+void main() {
+    float dy = vFar.y - vNear.y;
+    if (abs(dy) < 1e-6) discard;
+    float t = -vNear.y / dy;
+    if (t <= 0.0) discard;
+    vec3 p = vNear + t * (vFar - vNear);
+    vec4 clip = uViewProjection * vec4(p, 1.0);
+    gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+
+    float a = max(lines(p.xz, uCell) * 0.6, lines(p.xz, uCell * 10.0));
+    vec3 color = uGridColor;
+    vec2 d = fwidth(p.xz);
+    if (abs(p.z) < d.y) { color = uAxisX; a = 1.0; }
+    if (abs(p.x) < d.x) { color = uAxisZ; a = 1.0; }
+    a *= 1.0 - smoothstep(uFade * 0.5, uFade, distance(p, uEye.xyz));
+    if (a <= 0.0) discard;
+    fragColor = vec4(color, a);
+}
+)";
+
+std::unique_ptr<QOpenGLShaderProgram> buildProgram(const char *vs, const char *fs) {
+    const QByteArray header = QByteArray("#version 330 core\n") + kBlocks;
+    const QByteArray vsSrc = header + vs;
+    const QByteArray fsSrc = header + fs;
+    auto program = std::make_unique<QOpenGLShaderProgram>();
+    if (!program->addShaderFromSourceCode(QOpenGLShader::Vertex, vsSrc) ||
+        !program->addShaderFromSourceCode(QOpenGLShader::Fragment, fsSrc) ||
+        !program->link()) {
+        qWarning() << "Renderer: shader build failed:" << program->log();
+    }
+    return program;
+}
+
+} // namespace
+
+Renderer::Renderer() = default;
+
+Renderer::~Renderer() = default;
+
+uint64_t Renderer::newMeshKey() {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Renderer::initialize() {
+    initializeOpenGLFunctions();
+    m_programs[static_cast<int>(RenderProgram::Lit)] = buildProgram(kMeshVertex, kLitFragment);
+    m_programs[static_cast<int>(RenderProgram::Unlit)] = buildProgram(kMeshVertex, kUnlitFragment);
+    m_colorProgram = buildProgram(kColorVertex, kColorFragment);
+    m_gridProgram = buildProgram(kGridVertex, kGridFragment);
+    createUniformBuffers();
+    for (auto &p : m_programs) bindProgramBlocks(*p);
+    bindProgramBlocks(*m_colorProgram);
+    bindProgramBlocks(*m_gridProgram);
+    glGenVertexArrays(1, &m_emptyVao);
+
+    glGenVertexArrays(1, &m_streamVao);
+    glGenBuffers(1, &m_streamVbo);
+    glBindVertexArray(m_streamVao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_streamVbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ColorVertex), reinterpret_cast<void*>(0));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ColorVertex), reinterpret_cast<void*>(3 * sizeof(float)));
+    glBindVertexArray(0);
+
+    setLights({});
+    m_initialized = true;
+}
+
+void Renderer::cleanup() {
+    if (!m_initialized) return;
+    for (auto &kv : m_meshes) destroyMesh(kv.second);
+    m_meshes.clear();
+    for (auto &kv : m_colorBuffers) destroyColorBuffer(kv.second);
+    m_colorBuffers.clear();
+    glDeleteVertexArrays(1, &m_emptyVao);
+    m_emptyVao = 0;
+    glDeleteBuffers(1, &m_cameraUbo);
+    glDeleteBuffers(1, &m_lightsUbo);
+    glDeleteBuffers(1, &m_streamVbo);
+    glDeleteVertexArrays(1, &m_streamVao);
+    m_cameraUbo = m_lightsUbo = m_streamVbo = m_streamVao = 0;
+    for (auto &p : m_programs) p.reset();
+    m_colorProgram.reset();
+    m_gridProgram.reset();
+    m_initialized = false;
+}
+
+void Renderer::createUniformBuffers() {
+    glGenBuffers(1, &m_cameraUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_cameraUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, CameraBinding, m_cameraUbo);
+
+    glGenBuffers(1, &m_lightsUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(LightsBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LightsBinding, m_lightsUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void Renderer::bindProgramBlocks(QOpenGLShaderProgram &program) {
+    const GLuint id = program.programId();
+    GLuint camera = glGetUniformBlockIndex(id, "Camera");
+    if (camera != GL_INVALID_INDEX) glUniformBlockBinding(id, camera, CameraBinding);
+    GLuint lights = glGetUniformBlockIndex(id, "Lights");
+    if (lights != GL_INVALID_INDEX) glUniformBlockBinding(id, lights, LightsBinding);
+}
+
+void Renderer::setLights(const std::vector<RenderLight> &lights) {
+    LightsBlock block{};
+    const int count = std::min<int>(static_cast<int>(lights.size()), MaxLights);
+    block.count[0] = count;
+    for (int i = 0; i < count; ++i) {
+        const auto &l = lights[i];
+        block.lights[i].position[0] = l.position.x();
+        block.lights[i].position[1] = l.position.y();
+        block.lights[i].position[2] = l.position.z();
+        block.lights[i].position[3] = 1.0f;
+        block.lights[i].color[0] = l.color.x();
+        block.lights[i].color[1] = l.color.y();
+        block.lights[i].color[2] = l.color.z();
+        block.lights[i].color[3] = l.ambient;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightsBlock), &block);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void Renderer::beginFrame(const QMatrix4x4 &view, const QMatrix4x4 &projection) {
+    ++m_frame;
+    m_view = view;
+    m_projection = projection;
+    m_queue.clear();
+    m_stats = Stats{};
+
+    CameraBlock block{};
+    const QMatrix4x4 viewProjection = projection * view;
+    const QVector3D eye = view.inverted().map(QVector3D(0, 0, 0));
+    std::copy(view.constData(), view.constData() + 16, block.view);
+    std::copy(projection.constData(), projection.constData() + 16, block.projection);
+    std::copy(viewProjection.constData(), viewProjection.constData() + 16, block.viewProjection);
+    block.eye[0] = eye.x(); block.eye[1] = eye.y(); block.eye[2] = eye.z(); block.eye[3] = 1.0f;
+    glBindBuffer(GL_UNIFORM_BUFFER, m_cameraUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &block);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    if (m_frame % 60 == 0) evictUnusedMeshes();
+}
+
+void Renderer::uploadMesh(uint64_t key, const float *positions, size_t floatCount, const uint32_t *indices, size_t indexCount) {
+    GpuMesh &mesh = m_meshes[key];
+    if (!mesh.vao) {
+        glGenVertexArrays(1, &mesh.vao);
+        glGenBuffers(1, &mesh.vbo);
+        glGenBuffers(1, &mesh.ibo);
+    }
+    glBindVertexArray(mesh.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(floatCount * sizeof(float)), positions, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void*>(0));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexCount * sizeof(uint32_t)), indices, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    mesh.indexCount = static_cast<GLsizei>(indexCount);
+    mesh.lastFrame = m_frame;
+}
+
+void Renderer::updateMeshPositions(uint64_t key, size_t firstVertex, const float *positions, size_t vertexCount) {
+    auto it = m_meshes.find(key);
+    if (it == m_meshes.end() || vertexCount == 0) return;
+    glBindBuffer(GL_ARRAY_BUFFER, it->second.vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(firstVertex * 3 * sizeof(float)),
+                    static_cast<GLsizeiptr>(vertexCount * 3 * sizeof(float)), positions);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::submit(uint64_t meshKey, const QMatrix4x4 &model, const RenderMaterial &material) {
+    m_queue.push_back({material.program, material.color, meshKey, model});
+}
+
+void Renderer::flush() {
+    // Сортировка программа → материал → меш, чтобы менять состояние как можно реже.
+    std::sort(m_queue.begin(), m_queue.end(), [](const DrawItem &a, const DrawItem &b) {
+        return std::make_tuple(a.program, a.color.x(), a.color.y(), a.color.z(), a.meshKey)
+             < std::make_tuple(b.program, b.color.x(), b.color.y(), b.color.z(), b.meshKey);
+    });
+
+    glPolygonMode(GL_FRONT_AND_BACK, m_wireframe ? GL_LINE : GL_FILL);
+    QOpenGLShaderProgram *program = nullptr;
+    int programIndex = -1;
+    QVector3D color(-1, -1, -1);
+    uint64_t boundMesh = 0;
+    for (const auto &item : m_queue) {
+        auto it = m_meshes.find(item.meshKey);
+        if (it == m_meshes.end() || it->second.indexCount == 0) continue;
+        GpuMesh &mesh = it->second;
+        mesh.lastFrame = m_frame;
+
+        if (static_cast<int>(item.program) != programIndex) {
+            programIndex = static_cast<int>(item.program);
+            program = m_programs[programIndex].get();
+            program->bind();
+            color = QVector3D(-1, -1, -1);
+            ++m_stats.programBinds;
+        }
+        if (item.color != color) {
+            color = item.color;
+            program->setUniformValue("uColor", color);
+            ++m_stats.materialChanges;
+        }
+        if (item.meshKey != boundMesh) {
+            boundMesh = item.meshKey;
+            glBindVertexArray(mesh.vao);
+            ++m_stats.meshBinds;
+        }
+        program->setUniformValue("uModel", item.model);
+        glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, nullptr);
+        ++m_stats.drawCalls;
+    }
+    glBindVertexArray(0);
+    if (program) program->release();
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    m_queue.clear();
+    m_stats.residentMeshes = m_meshes.size();
+}
+
+void Renderer::streamColorVertices(const std::vector<ColorVertex> &vertices) {
+    glBindVertexArray(m_streamVao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_streamVbo);
+    // Переразмечаем буфер, чтобы драйвер не ждал предыдущий кадр.
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(ColorVertex)), vertices.data(), GL_STREAM_DRAW);
+}
+
+void Renderer::drawLines(const std::vector<ColorVertex> &vertices, const QMatrix4x4 &model, float width) {
+    if (vertices.empty()) return;
+    m_colorProgram->bind();
+    m_colorProgram->setUniformValue("uModel", model);
+    m_colorProgram->setUniformValue("uTint", QVector4D());
+    streamColorVertices(vertices);
+    glLineWidth(width);
+    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertices.size()));
+    glLineWidth(1.0f);
+    glBindVertexArray(0);
+    m_colorProgram->release();
+    ++m_stats.drawCalls;
+}
+
+void Renderer::drawPoints(const std::vector<ColorVertex> &vertices, float size) {
+    if (vertices.empty()) return;
+    m_colorProgram->bind();
+    m_colorProgram->setUniformValue("uModel", QMatrix4x4());
+    m_colorProgram->setUniformValue("uTint", QVector4D());
+    streamColorVertices(vertices);
+    glPointSize(size);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(vertices.size()));
+    glPointSize(1.0f);
+    glBindVertexArray(0);
+    m_colorProgram->release();
+    ++m_stats.drawCalls;
+}
+
+void Renderer::uploadColorBuffer(uint64_t key, const std::vector<ColorVertex> &vertices, const std::vector<uint32_t> &indices) {
+    GpuColorBuffer &buffer = m_colorBuffers[key];
+    if (!buffer.vao) {
+        glGenVertexArrays(1, &buffer.vao);
+        glGenBuffers(1, &buffer.vbo);
+        glBindVertexArray(buffer.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ColorVertex), reinterpret_cast<void*>(0));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ColorVertex), reinterpret_cast<void*>(3 * sizeof(float)));
+    } else {
+        glBindVertexArray(buffer.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+    }
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(ColorVertex)), vertices.data(), GL_STATIC_DRAW);
+    if (!indices.empty()) {
+        if (!buffer.ibo) glGenBuffers(1, &buffer.ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(uint32_t)), indices.data(), GL_STATIC_DRAW);
+    }
+    glBindVertexArray(0);
+    buffer.count = static_cast<GLsizei>(vertices.size());
+    buffer.indexCount = static_cast<GLsizei>(indices.size());
+}
+
+void Renderer::updateColorBuffer(uint64_t key, size_t first, const ColorVertex *vertices, size_t count) {
+    auto it = m_colorBuffers.find(key);
+    if (it == m_colorBuffers.end() || count == 0 || first + count > size_t(it->second.count)) return;
+    glBindBuffer(GL_ARRAY_BUFFER, it->second.vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first * sizeof(ColorVertex)),
+                    static_cast<GLsizeiptr>(count * sizeof(ColorVertex)), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::releaseMesh(uint64_t key) {
+    auto it = m_meshes.find(key);
+    if (it == m_meshes.end()) return;
+    destroyMesh(it->second);
+    m_meshes.erase(it);
+}
+
+void Renderer::releaseColorBuffer(uint64_t key) {
+    auto it = m_colorBuffers.find(key);
+    if (it == m_colorBuffers.end()) return;
+    destroyColorBuffer(it->second);
+    m_colorBuffers.erase(it);
+}
+
+void Renderer::drawLines(uint64_t key, const QMatrix4x4 &model, float width, const QVector4D &tint) {
+    auto it = m_colorBuffers.find(key);
+    if (it == m_colorBuffers.end() || it->second.count == 0) return;
+    const GpuColorBuffer &buffer = it->second;
+    m_colorProgram->bind();
+    m_colorProgram->setUniformValue("uModel", model);
+    m_colorProgram->setUniformValue("uTint", tint);
+    glBindVertexArray(buffer.vao);
+    glLineWidth(width);
+    if (buffer.indexCount > 0) glDrawElements(GL_LINES, buffer.indexCount, GL_UNSIGNED_INT, nullptr);
+    else glDrawArrays(GL_LINES, 0, buffer.count);
+    glLineWidth(1.0f);
+    glBindVertexArray(0);
+    m_colorProgram->release();
+    ++m_stats.drawCalls;
+}
+
+void Renderer::drawPoints(uint64_t key, float size) {
+    auto it = m_colorBuffers.find(key);
+    if (it == m_colorBuffers.end() || it->second.count == 0) return;
+    m_colorProgram->bind();
+    m_colorProgram->setUniformValue("uModel", QMatrix4x4());
+    m_colorProgram->setUniformValue("uTint", QVector4D());
+    glBindVertexArray(it->second.vao);
+    glPointSize(size);
+    glDrawArrays(GL_POINTS, 0, it->second.count);
+    glPointSize(1.0f);
+    glBindVertexArray(0);
+    m_colorProgram->release();
+    ++m_stats.drawCalls;
+}
+
+void Renderer::drawInfiniteGrid(const GridStyle &style) {
+    m_gridProgram->bind();
+    m_gridProgram->setUniformValue("uInvViewProjection", (m_projection * m_view).inverted());
+    m_gridProgram->setUniformValue("uCell", style.cell);
+    m_gridProgram->setUniformValue("uFade", style.fadeDistance);
+    m_gridProgram->setUniformValue("uGridColor", style.color);
+    m_gridProgram->setUniformValue("uAxisX", style.axisX);
+    m_gridProgram->setUniformValue("uAxisZ", style.axisZ);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(m_emptyVao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    m_gridProgram->release();
+    ++m_stats.drawCalls;
+}
+
+void Renderer::destroyMesh(GpuMesh &mesh) {
+    if (mesh.vao) glDeleteVertexArrays(1, &mesh.vao);
+    if (mesh.vbo) glDeleteBuffers(1, &mesh.vbo);
+    if (mesh.ibo) glDeleteBuffers(1, &mesh.ibo);
+    mesh = GpuMesh{};
+}
+
+void Renderer::destroyColorBuffer(GpuColorBuffer &buffer) {
+    if (buffer.vao) glDeleteVertexArrays(1, &buffer.vao);
+    if (buffer.vbo) glDeleteBuffers(1, &buffer.vbo);
+    if (buffer.ibo) glDeleteBuffers(1, &buffer.ibo);
+    buffer = GpuColorBuffer{};
+}
+
+void Renderer::evictUnusedMeshes() {
+    for (auto it = m_meshes.begin(); it != m_meshes.end();) {
+        if (m_frame - it->second.lastFrame > MeshEvictFrames) {
+            destroyMesh(it->second);
+            it = m_meshes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,173 @@
+// src/core/Renderer.hpp
+#pragma once
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLShaderProgram>
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <QVector4D>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Точечный источник света. ambient — доля рассеянного света (как GL_AMBIENT);
+// в сцену он входит один раз — наибольший среди источников, не сумма.
+struct RenderLight {
+    QVector3D position;
+    QVector3D color{0.85f, 0.85f, 0.85f};
+    float ambient = 0.15f;
+};
+
+// Программы упорядочены так, как их выгоднее всего переключать при сортировке.
+enum class RenderProgram : uint8_t { Lit = 0, Unlit = 1, Count };
+
+struct RenderMaterial {
+    RenderProgram program = RenderProgram::Lit;
+    QVector3D color{0.75f, 0.8f, 1.0f};
+};
+
+// Вершина для линий/точек оверлея (сетка, оси, рамки, вершины редактора).
+struct ColorVertex { float x, y, z; float r, g, b; };
+
+// Бесконечная сетка в плоскости y = 0: линии строит фрагментный шейдер.
+struct GridStyle {
+    float cell = 1.0f;          // шаг мелких линий; крупные — каждые 10
+    float fadeDistance = 80.0f; // на этом расстоянии от камеры сетка гаснет
+    QVector3D color{0.3f, 0.3f, 0.3f};
+    QVector3D axisX{1.0f, 0.0f, 0.0f};
+    QVector3D axisZ{0.0f, 0.0f, 1.0f};
+};
+
+// Core-profile рендерер: GLSL-программы, UBO камеры и света, очередь отрисовки,
+// отсортированная по программе/материалу/мешу. Один экземпляр на GL-контекст.
+class Renderer : protected QOpenGLFunctions_3_3_Core {
+public:
+    static constexpr int MaxLights = 32;
+
+    struct Stats {
+        int drawCalls = 0;
+        int programBinds = 0;
+        int materialChanges = 0;
+        int meshBinds = 0;
+        size_t residentMeshes = 0;
+    };
+
+    Renderer();
+    ~Renderer();
+
+    // Вызывать из initializeGL() при текущем контексте.
+    void initialize();
+    // Освобождает все GL-объекты; вызывать при текущем контексте (aboutToBeDestroyed).
+    void cleanup();
+    bool isInitialized() const { return m_initialized; }
+
+    void beginFrame(const QMatrix4x4 &view, const QMatrix4x4 &projection);
+    void setLights(const std::vector<RenderLight> &lights);
+    void setWireframe(bool on) { m_wireframe = on; }
+
+    // Ключ меша уникален для каждой версии геометрии: изменили вершины — взяли новый ключ.
+    static uint64_t newMeshKey();
+    bool hasMesh(uint64_t key) const { return m_meshes.count(key) != 0; }
+    void uploadMesh(uint64_t key, const std::vector<float> &positions, const std::vector<uint32_t> &indices) {
+        uploadMesh(key, positions.data(), positions.size(), indices.data(), indices.size());
+    }
+    void uploadMesh(uint64_t key, const float *positions, size_t floatCount, const uint32_t *indices, size_t indexCount);
+    // Перезаливка диапазона вершин уже загруженного меша (правка без смены ключа)
+    void updateMeshPositions(uint64_t key, size_t firstVertex, const float *positions, size_t vertexCount);
+    // Сразу, не дожидаясь вытеснения по возрасту (одноразовые меши превью)
+    void releaseMesh(uint64_t key);
+    template <class V, class F>
+    void ensureMesh(uint64_t key, const std::vector<V> &vertices, const std::vector<F> &faces);
+
+    void submit(uint64_t meshKey, const QMatrix4x4 &model, const RenderMaterial &material);
+    void flush();
+
+    void drawLines(const std::vector<ColorVertex> &vertices, const QMatrix4x4 &model = QMatrix4x4(), float width = 1.0f);
+    void drawPoints(const std::vector<ColorVertex> &vertices, float size = 1.0f);
+
+    // Удерживаемые цветные буферы: живут до releaseColorBuffer()/cleanup() и
+    // меняются только явно — целиком или диапазоном. indices — пары для
+    // GL_LINES поверх тех же вершин (рёбра меша), пусто — вершины идут подряд.
+    // Ключи — из newMeshKey().
+    bool hasColorBuffer(uint64_t key) const { return m_colorBuffers.count(key) != 0; }
+    void uploadColorBuffer(uint64_t key, const std::vector<ColorVertex> &vertices, const std::vector<uint32_t> &indices = {});
+    void updateColorBuffer(uint64_t key, size_t first, const ColorVertex *vertices, size_t count);
+    void releaseColorBuffer(uint64_t key);
+    // tint.w > 0 — линии одним цветом tint.xyz вместо цвета вершин
+    void drawLines(uint64_t key, const QMatrix4x4 &model = QMatrix4x4(), float width = 1.0f, const QVector4D &tint = QVector4D());
+    void drawPoints(uint64_t key, float size = 1.0f);
+
+    // Полноэкранный треугольник без вершинного буфера; пишет глубину плоскости
+    void drawInfiniteGrid(const GridStyle &style);
+
+    QMatrix4x4 view() const { return m_view; }
+    QMatrix4x4 projection() const { return m_projection; }
+    const Stats &stats() const { return m_stats; }
+
+private:
+    struct GpuMesh {
+        GLuint vao = 0, vbo = 0, ibo = 0;
+        GLsizei indexCount = 0;
+        uint64_t lastFrame = 0;
+    };
+    struct GpuColorBuffer {
+        GLuint vao = 0, vbo = 0, ibo = 0;
+        GLsizei count = 0;
+        GLsizei indexCount = 0;
+    };
+    struct DrawItem {
+        RenderProgram program;
+        QVector3D color;
+        uint64_t meshKey;
+        QMatrix4x4 model;
+    };
+
+    void createUniformBuffers();
+    void bindProgramBlocks(QOpenGLShaderProgram &program);
+    void streamColorVertices(const std::vector<ColorVertex> &vertices);
+    void destroyMesh(GpuMesh &mesh);
+    void destroyColorBuffer(GpuColorBuffer &buffer);
+    void evictUnusedMeshes();
+
+    bool m_initialized = false;
+    bool m_wireframe = false;
+    uint64_t m_frame = 0;
+
+    std::unique_ptr<QOpenGLShaderProgram> m_programs[static_cast<int>(RenderProgram::Count)];
+    std::unique_ptr<QOpenGLShaderProgram> m_colorProgram;
+    std::unique_ptr<QOpenGLShaderProgram> m_gridProgram;
+    GLuint m_cameraUbo = 0;
+    GLuint m_lightsUbo = 0;
+    GLuint m_streamVao = 0;
+    GLuint m_streamVbo = 0;
+    GLuint m_emptyVao = 0; // core profile не рисует без привязанного VAO
+
+    QMatrix4x4 m_view;
+    QMatrix4x4 m_projection;
+    std::unordered_map<uint64_t, GpuMesh> m_meshes;
+    std::unordered_map<uint64_t, GpuColorBuffer> m_colorBuffers;
+    std::vector<DrawItem> m_queue;
+    Stats m_stats;
+};
+
+template <class V, class F>
+void Renderer::ensureMesh(uint64_t key, const std::vector<V> &vertices, const std::vector<F> &faces) {
+    if (hasMesh(key)) return;
+    std::vector<float> positions;
+    positions.reserve(vertices.size() * 3);
+    for (const auto &v : vertices) { positions.push_back(v.x); positions.push_back(v.y); positions.push_back(v.z); }
+    std::vector<uint32_t> indices;
+    indices.reserve(faces.size() * 3);
+    const size_t count = vertices.size();
+    for (const auto &f : faces) {
+        if (f.indices.size() < 3) continue;
+        for (size_t i = 1; i + 1 < f.indices.size(); ++i) {
+            const size_t a = f.indices[0], b = f.indices[i], c = f.indices[i + 1];
+            if (a >= count || b >= count || c >= count) continue;
+            indices.push_back(static_cast<uint32_t>(a));
+            indices.push_back(static_cast<uint32_t>(b));
+            indices.push_back(static_cast<uint32_t>(c));
+        }
+    }
+    uploadMesh(key, positions, indices);
+}
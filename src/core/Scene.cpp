@@ -0,0 +1,232 @@
+// src/core/Scene.cpp
+#include "Scene.hpp"
+#include <QJsonArray>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+SceneObject::SceneObject(const std::string& objData, const std::string& objName)
+    : name(objName) {
+    loadFromObj(objData);
+}
+
+SceneObject::SceneObject(std::vector<Vertex> verts, std::vector<Face> fcs, const std::string& objName)
+    : name(objName), vertices(std::move(verts)), faces(std::move(fcs)), meshKey(Renderer::newMeshKey()) {
+}
+
+void SceneObject::loadFromObj(const std::string& objData) {
+    parseObj(objData, vertices, faces);
+    meshKey = Renderer::newMeshKey();
+}
+
+QMatrix4x4 SceneObject::modelMatrix() const {
+    // Поля открыты и правятся напрямую, поэтому актуальность проверяем по значениям
+    const std::array<float, 9> key{x, y, z, rx, ry, rz, sx, sy, sz};
+    if (m_matrixValid && key == m_matrixKey) return m_matrix;
+    QMatrix4x4 m;
+    m.translate(x, y, z);
+    m.rotate(rx, 1.0f, 0.0f, 0.0f);
+    m.rotate(ry, 0.0f, 1.0f, 0.0f);
+    m.rotate(rz, 0.0f, 0.0f, 1.0f);
+    m.scale(sx, sy, sz);
+    m_matrix = m;
+    m_matrixKey = key;
+    m_matrixValid = true;
+    return m;
+}
+
+bool SceneObject::setParent(SceneObject *p) {
+    for (const SceneObject *a = p; a; a = a->m_parent) {
+        if (a == this) return false;
+    }
+    m_parent = p;
+    return true;
+}
+
+QMatrix4x4 SceneObject::worldMatrix() const {
+    return m_parent ? m_parent->worldMatrix() * modelMatrix() : modelMatrix();
+}
+
+void SceneObject::draw(Renderer &renderer, const QMatrix4x4 &world) {
+    renderer.ensureMesh(meshKey, vertices, faces);
+    renderer.submit(meshKey, world, {RenderProgram::Lit, QVector3D(r, g, b)});
+}
+
+// Луч задан в мировых координатах; t — расстояние в параметре мирового луча.
+bool SceneObject::intersectRay(const QVector3D &origin, const QVector3D &dir, const QMatrix4x4 &world, float &t) const {
+    return intersectTriangles(vertices, faces, world, origin, dir, t);
+}
+
+bool intersectTriangles(const std::vector<Vertex> &vertices, const std::vector<Face> &faces, const QMatrix4x4 &world,
+                        const QVector3D &origin, const QVector3D &dir, float &t) {
+    bool invertible = false;
+    const QMatrix4x4 inv = world.inverted(&invertible);
+    if (!invertible) return false;
+    const QVector3D o = inv.map(origin);
+    const QVector3D d = inv.mapVector(dir);
+
+    bool hit = false;
+    float best = std::numeric_limits<float>::max();
+    for (const auto& face : faces) {
+        if (face.indices.size() < 3) continue;
+        for (size_t i = 1; i + 1 < face.indices.size(); ++i) {
+            // Möller–Trumbore
+            const Vertex &a = vertices[face.indices[0]];
+            const Vertex &b = vertices[face.indices[i]];
+            const Vertex &c = vertices[face.indices[i + 1]];
+            QVector3D e1(b.x - a.x, b.y - a.y, b.z - a.z);
+            QVector3D e2(c.x - a.x, c.y - a.y, c.z - a.z);
+            QVector3D p = QVector3D::crossProduct(d, e2);
+            float det = QVector3D::dotProduct(e1, p);
+            if (std::fabs(det) < 1e-9f) continue;
+            float invDet = 1.0f / det;
+            QVector3D s(o.x() - a.x, o.y() - a.y, o.z() - a.z);
+            float u = QVector3D::dotProduct(s, p) * invDet;
+            if (u < 0.0f || u > 1.0f) continue;
+            QVector3D q = QVector3D::crossProduct(s, e1);
+            float v = QVector3D::dotProduct(d, q) * invDet;
+            if (v < 0.0f || u + v > 1.0f) continue;
+            float dist = QVector3D::dotProduct(e2, q) * invDet;
+            if (dist > 0.0f && dist < best) { best = dist; hit = true; }
+        }
+    }
+    if (hit) t = best;
+    return hit;
+}
+
+std::string SceneObject::toObj() const {
+    return writeObj(vertices, faces);
+}
+
+void writeMeshJson(QJsonObject &jo, const std::vector<Vertex> &vertices, const std::vector<Face> &faces, MeshEncoding encoding) {
+    if (encoding == MeshEncoding::Quantized) {
+        jo["mesh_q"] = QString::fromLatin1(MeshCodec::encode(vertices, faces).toBase64());
+    } else {
+        jo["mesh_obj"] = QString::fromStdString(writeObj(vertices, faces));
+    }
+}
+
+QJsonObject sceneObjectToJson(const SceneObject &o, MeshEncoding encoding) {
+    QJsonObject jo;
+    jo["name"] = QString::fromStdString(o.name);
+    jo["transform"] = QJsonObject{{"pos", QJsonArray{o.x,o.y,o.z}}, {"rot", QJsonArray{o.rx,o.ry,o.rz}}, {"scl", QJsonArray{o.sx,o.sy,o.sz}}};
+    // Меш пишется и при ссылке на ассет: сцена открывается и без базы ассетов (Player, другой проект)
+    if (!o.asset.empty()) jo["asset"] = QString::fromStdString(o.asset);
+    writeMeshJson(jo, o.vertices, o.faces, encoding);
+    jo["color"] = QJsonArray{o.r, o.g, o.b};
+    jo["static"] = o.isStatic;
+    return jo;
+}
+
+namespace {
+// Всё, кроме меша: его разбирает вызывающий — сразу или пачкой в потоках
+std::unique_ptr<SceneObject> objectShellFromJson(const QJsonObject &jo) {
+    auto name = jo.value("name").toString("Object");
+    auto o = std::make_unique<SceneObject>(std::vector<Vertex>(), std::vector<Face>(), name.toStdString());
+    auto tr = jo.value("transform").toObject();
+    auto pos = tr.value("pos").toArray();
+    auto rot = tr.value("rot").toArray();
+    auto scl = tr.value("scl").toArray();
+    if (pos.size()==3){ o->x=pos[0].toDouble(); o->y=pos[1].toDouble(); o->z=pos[2].toDouble(); }
+    if (rot.size()==3){ o->rx=rot[0].toDouble(); o->ry=rot[1].toDouble(); o->rz=rot[2].toDouble(); }
+    if (scl.size()==3){ o->sx=scl[0].toDouble(); o->sy=scl[1].toDouble(); o->sz=scl[2].toDouble(); }
+    auto color = jo.value("color").toArray();
+    if (color.size()==3){ o->r=color[0].toDouble(); o->g=color[1].toDouble(); o->b=color[2].toDouble(); }
+    o->isStatic = jo.value("static").toBool(true);
+    o->asset = jo.value("asset").toString().toStdString();
+    return o;
+}
+
+} // namespace
+
+std::unique_ptr<SceneObject> sceneObjectFromJson(const QJsonObject &jo) {
+    auto o = objectShellFromJson(jo);
+    // Без загрузчика ассетов — встроенная копия меша, как в sceneFromJson
+    if (jo.contains("mesh_q")) MeshCodec::decode(QByteArray::fromBase64(jo.value("mesh_q").toString().toLatin1()), o->vertices, o->faces);
+    else o->loadFromObj(jo.value("mesh_obj").toString().toStdString());
+    return o;
+}
+
+QJsonObject sceneToJson(const SceneObjectList &objects, MeshEncoding encoding) {
+    std::unordered_map<const SceneObject*, int> indexOf;
+    for (size_t i = 0; i < objects.size(); ++i) indexOf[objects[i].get()] = static_cast<int>(i);
+    QJsonArray arr;
+    for (const auto &ptr : objects) {
+        QJsonObject jo = sceneObjectToJson(*ptr, encoding);
+        auto it = ptr->parent() ? indexOf.find(ptr->parent()) : indexOf.end();
+        if (it != indexOf.end()) jo["parent"] = it->second;
+        arr.push_back(jo);
+    }
+    return QJsonObject{{"objects", arr}};
+}
+
+SceneObjectList sceneFromJson(const QJsonObject &root, const AssetMeshLoader &assets, std::vector<std::string> *unresolved) {
+    SceneObjectList objects;
+    const auto arr = root.value("objects").toArray();
+    objects.reserve(arr.size());
+    // Оболочки — сразу, меши обоих видов — потом, по потоку на ядро. Строки
+    // QJson разделяемые: в задачу уходит копия без копирования данных
+    struct PendingMesh {
+        SceneObject *object;
+        QString source; // встроенный меш; пусто — его нет
+        bool packed;
+        bool asset;     // сначала — загрузчик ассетов, встроенный меш — запасной
+        bool resolved;
+    };
+    std::vector<PendingMesh> pending;
+    pending.reserve(arr.size());
+    for (const auto &it : arr) {
+        const QJsonObject jo = it.toObject();
+        objects.push_back(objectShellFromJson(jo));
+        SceneObject *o = objects.back().get();
+        const bool packed = jo.contains("mesh_q");
+        pending.push_back({o, jo.value(packed ? "mesh_q" : "mesh_obj").toString(), packed, !o->asset.empty(), true});
+    }
+    // Крупные — первыми: общий курсор раздаёт задачи свободным потокам, и
+    // хвост из одного большого меша не достаётся последним. Размер ассета
+    // заранее неизвестен — они идут впереди всех
+    std::sort(pending.begin(), pending.end(), [](const PendingMesh &a, const PendingMesh &b){
+        if (a.asset != b.asset) return a.asset;
+        return a.source.size() > b.source.size();
+    });
+    std::atomic<size_t> nextMesh{0};
+    const auto decodeMeshes = [&]{
+        for (size_t i = nextMesh++; i < pending.size(); i = nextMesh++) {
+            PendingMesh &m = pending[i];
+            SceneObject *o = m.object;
+            if (m.asset) {
+                if (assets && assets(o->asset, o->vertices, o->faces)) continue;
+                o->vertices.clear();
+                o->faces.clear();
+                // Нет ни ассета, ни встроенной копии (сцены первых версий с asset)
+                if (m.source.isEmpty()) { m.resolved = false; continue; }
+            }
+            if (m.packed) {
+                if (!MeshCodec::decode(QByteArray::fromBase64(m.source.toLatin1()), o->vertices, o->faces)) { o->vertices.clear(); o->faces.clear(); }
+            } else {
+                const QByteArray text = m.source.toUtf8();
+                parseObj(text.constData(), static_cast<size_t>(text.size()), o->vertices, o->faces);
+            }
+        }
+    };
+    const size_t threads = std::min<size_t>(pending.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) workers.emplace_back(decodeMeshes);
+    decodeMeshes();
+    for (auto &w : workers) w.join();
+    if (unresolved) {
+        for (const PendingMesh &m : pending) {
+            if (!m.resolved) unresolved->push_back(m.object->asset);
+        }
+    }
+
+    // Связи — вторым проходом, когда все объекты уже созданы
+    for (qsizetype i = 0; i < arr.size(); ++i) {
+        const int p = arr[i].toObject().value("parent").toInt(-1);
+        if (p >= 0 && p < static_cast<int>(objects.size()) && p != i) objects[i]->setParent(objects[p].get());
+    }
+    return objects;
+}
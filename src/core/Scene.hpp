@@ -0,0 +1,77 @@
+// src/core/Scene.hpp
+#pragma once
+#include <QJsonObject>
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Mesh.hpp"
+#include "MeshCodec.hpp"
+#include "Renderer.hpp"
+
+class SceneObject {
+public:
+    std::string name;
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    float rx = 0.0f, ry = 0.0f, rz = 0.0f;
+    float sx = 1.0f, sy = 1.0f, sz = 1.0f;
+    float r = 0.75f, g = 0.8f, b = 1.0f;
+    bool isStatic = true; // статические объекты запекаются в общие батчи при экспорте игры
+    std::vector<Vertex> vertices;
+    std::vector<Face> faces;
+    uint64_t meshKey = 0;
+    std::string asset; // GUID ассета проекта, из которого взят меш; пусто — меш хранится в сцене
+
+    SceneObject(const std::string& objData, const std::string& name = "Object");
+    SceneObject(std::vector<Vertex> vertices, std::vector<Face> faces, const std::string& name = "Object");
+    void loadFromObj(const std::string& objData);
+    // Локальное преобразование (относительно родителя). Кэшируется: пересчёт
+    // только если с прошлого вызова поменялось преобразование
+    QMatrix4x4 modelMatrix() const;
+    // Родитель в иерархии (не владеет). false — связь дала бы цикл.
+    SceneObject *parent() const { return m_parent; }
+    bool setParent(SceneObject *parent);
+    // Произведение по цепочке родителей; в кадре вьюпорта — TransformHierarchy
+    QMatrix4x4 worldMatrix() const;
+    void draw(Renderer &renderer) { draw(renderer, worldMatrix()); }
+    void draw(Renderer &renderer, const QMatrix4x4 &world);
+    bool intersectRay(const QVector3D &origin, const QVector3D &dir, float &t) const {
+        return intersectRay(origin, dir, worldMatrix(), t);
+    }
+    bool intersectRay(const QVector3D &origin, const QVector3D &dir, const QMatrix4x4 &world, float &t) const;
+    std::string toObj() const;
+    void getAABB(Vertex &minV, Vertex &maxV) const { computeAABB(vertices, minV, maxV); }
+
+private:
+    SceneObject *m_parent = nullptr;
+    mutable std::array<float, 9> m_matrixKey{};
+    mutable QMatrix4x4 m_matrix;
+    mutable bool m_matrixValid = false;
+};
+
+using SceneObjectList = std::vector<std::unique_ptr<SceneObject>>;
+
+// Пересечение мирового луча с гранями меша, заданного в локальных координатах world
+bool intersectTriangles(const std::vector<Vertex> &vertices, const std::vector<Face> &faces, const QMatrix4x4 &world,
+                        const QVector3D &origin, const QVector3D &dir, float &t);
+
+// Формат .scene: {"objects": [{name, transform{pos,rot,scl}, mesh_obj | mesh_q | asset, color, static, parent}]},
+// parent — индекс родителя в том же массиве (нет поля — корень),
+// mesh_q — меш MeshCodec в base64 вместо текста OBJ,
+// asset — GUID ассета проекта: меш берётся из базы ассетов, а встроенный
+// mesh_obj/mesh_q рядом — запасной, когда базы нет (Player, другой проект)
+void writeMeshJson(QJsonObject &jo, const std::vector<Vertex> &vertices, const std::vector<Face> &faces, MeshEncoding encoding);
+QJsonObject sceneObjectToJson(const SceneObject &object, MeshEncoding encoding = MeshEncoding::Obj);
+std::unique_ptr<SceneObject> sceneObjectFromJson(const QJsonObject &jo);
+QJsonObject sceneToJson(const SceneObjectList &objects, MeshEncoding encoding = MeshEncoding::Obj);
+// Меш ассета по GUID (см. AssetPipeline::meshLoader). Зовётся из потоков
+// разбора одновременно. false — ассет не найден, объект остаётся без меша
+using AssetMeshLoader = std::function<bool(const std::string &guid, std::vector<Vertex> &vertices, std::vector<Face> &faces)>;
+// Меши (OBJ, сжатые, ассеты) разбираются параллельно, по потоку на ядро.
+// Ассет, который не нашёлся и не имеет встроенной копии, остаётся без меша,
+// его GUID — в unresolved
+SceneObjectList sceneFromJson(const QJsonObject &root, const AssetMeshLoader &assets = {},
+                              std::vector<std::string> *unresolved = nullptr);
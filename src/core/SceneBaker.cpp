@@ -0,0 +1,88 @@
+// src/core/SceneBaker.cpp
+#include "SceneBaker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace {
+
+using BatchKey = std::tuple<float, float, float, int, int, int>;
+
+void growBounds(BakedBatch &batch, const Vertex &v) {
+    if (batch.vertices.empty()) { batch.boundsMin = v; batch.boundsMax = v; return; }
+    batch.boundsMin.x = std::min(batch.boundsMin.x, v.x); batch.boundsMax.x = std::max(batch.boundsMax.x, v.x);
+    batch.boundsMin.y = std::min(batch.boundsMin.y, v.y); batch.boundsMax.y = std::max(batch.boundsMax.y, v.y);
+    batch.boundsMin.z = std::min(batch.boundsMin.z, v.z); batch.boundsMax.z = std::max(batch.boundsMax.z, v.z);
+}
+
+} // namespace
+
+BakedScene bakeScene(const SceneObjectList &objects, const BakeOptions &options) {
+    BakedScene baked;
+    // Индекс текущего (незаполненного) батча для каждого ключа
+    std::map<BatchKey, size_t> open;
+    const float cell = std::max(options.clusterSize, 1e-3f);
+
+    for (const auto &ptr : objects) {
+        const SceneObject &o = *ptr;
+        if (!o.isStatic) {
+            auto copy = std::make_unique<SceneObject>(o.vertices, o.faces, o.name);
+            if (o.parent()) {
+                // Иерархия в Player не переносится: мировое преобразование вносим в вершины
+                const QMatrix4x4 world = o.worldMatrix();
+                for (Vertex &v : copy->vertices) {
+                    const QVector3D p = world.map(QVector3D(v.x, v.y, v.z));
+                    v = {p.x(), p.y(), p.z()};
+                }
+            } else {
+                copy->x = o.x; copy->y = o.y; copy->z = o.z;
+                copy->rx = o.rx; copy->ry = o.ry; copy->rz = o.rz;
+                copy->sx = o.sx; copy->sy = o.sy; copy->sz = o.sz;
+            }
+            copy->r = o.r; copy->g = o.g; copy->b = o.b;
+            copy->isStatic = false;
+            baked.dynamicObjects.push_back(std::move(copy));
+            continue;
+        }
+        if (o.vertices.empty() || o.faces.empty()) continue;
+
+        // Объект целиком попадает в кластер по центру своего мирового AABB
+        const QMatrix4x4 model = o.worldMatrix();
+        std::vector<Vertex> world(o.vertices.size());
+        for (size_t i = 0; i < o.vertices.size(); ++i) {
+            const QVector3D p = model.map(QVector3D(o.vertices[i].x, o.vertices[i].y, o.vertices[i].z));
+            world[i] = {p.x(), p.y(), p.z()};
+        }
+        Vertex minV, maxV;
+        computeAABB(world, minV, maxV);
+        const int cx = static_cast<int>(std::floor((minV.x + maxV.x) * 0.5f / cell));
+        const int cy = static_cast<int>(std::floor((minV.y + maxV.y) * 0.5f / cell));
+        const int cz = static_cast<int>(std::floor((minV.z + maxV.z) * 0.5f / cell));
+        const BatchKey key{o.r, o.g, o.b, cx, cy, cz};
+
+        auto it = open.find(key);
+        if (it == open.end() || baked.batches[it->second].vertices.size() + world.size() > options.maxBatchVertices) {
+            BakedBatch batch;
+            batch.color = QVector3D(o.r, o.g, o.b);
+            baked.batches.push_back(std::move(batch));
+            it = open.insert_or_assign(key, baked.batches.size() - 1).first;
+        }
+        BakedBatch &batch = baked.batches[it->second];
+
+        const uint32_t base = static_cast<uint32_t>(batch.vertices.size());
+        for (const auto &v : world) { growBounds(batch, v); batch.vertices.push_back(v); }
+        const size_t count = world.size();
+        for (const auto &f : o.faces) {
+            for (size_t i = 1; i + 1 < f.indices.size(); ++i) {
+                const size_t ia = f.indices[0], ib = f.indices[i], ic = f.indices[i + 1];
+                if (ia >= count || ib >= count || ic >= count) continue;
+                batch.indices.push_back(base + static_cast<uint32_t>(ia));
+                batch.indices.push_back(base + static_cast<uint32_t>(ib));
+                batch.indices.push_back(base + static_cast<uint32_t>(ic));
+            }
+        }
+    }
+    return baked;
+}
@@ -0,0 +1,29 @@
+// src/core/SceneBaker.hpp
+#pragma once
+#include <QVector3D>
+#include <vector>
+#include "Scene.hpp"
+
+// Запечённый батч: статическая геометрия одного материала из одного кластера,
+// вершины уже в мировых координатах — рисуется одним draw call без матрицы объекта.
+struct BakedBatch {
+    QVector3D color;
+    Vertex boundsMin{0, 0, 0};
+    Vertex boundsMax{0, 0, 0};
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    uint64_t meshKey = 0; // заполняется в рантайме
+};
+
+struct BakedScene {
+    std::vector<BakedBatch> batches;
+    SceneObjectList dynamicObjects;
+};
+
+struct BakeOptions {
+    float clusterSize = 32.0f;               // ребро ячейки пространственной сетки
+    size_t maxBatchVertices = 1u << 20;      // при переполнении батч делится
+};
+
+// Статические объекты сливаются по (материал, ячейка); динамические копируются как есть.
+BakedScene bakeScene(const SceneObjectList &objects, const BakeOptions &options = {});
@@ -0,0 +1,205 @@
+// src/core/SceneBinary.cpp
+#include "SceneBinary.hpp"
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "SceneBinary пишет массивы в порядке байт хоста");
+
+namespace {
+
+class Writer {
+public:
+    explicit Writer(QByteArray &out) : m_out(out) {}
+    void u32(quint32 v) { raw(&v, sizeof(v)); }
+    void f32(float v) { raw(&v, sizeof(v)); }
+    void raw(const void *p, size_t n) { m_out.append(static_cast<const char*>(p), static_cast<qsizetype>(n)); }
+private:
+    QByteArray &m_out;
+};
+
+class Reader {
+public:
+    explicit Reader(const QByteArray &in) : m_p(in.constData()), m_end(in.constData() + in.size()) {}
+    bool u32(quint32 &v) { return raw(&v, sizeof(v)); }
+    bool f32(float &v) { return raw(&v, sizeof(v)); }
+    bool raw(void *dst, size_t n) {
+        if (static_cast<size_t>(m_end - m_p) < n) return false;
+        std::memcpy(dst, m_p, n);
+        m_p += n;
+        return true;
+    }
+    size_t remaining() const { return static_cast<size_t>(m_end - m_p); }
+private:
+    const char *m_p;
+    const char *m_end;
+};
+
+// Раздел динамических объектов — общий для load() и readIndex()
+bool readObjects(Reader &r, SceneObjectList &objects) {
+    quint32 count = 0;
+    if (!r.u32(count)) return false;
+    objects.reserve(count);
+    std::vector<uint32_t> indices;
+    for (quint32 n = 0; n < count; ++n) {
+        quint32 nameLen = 0;
+        if (!r.u32(nameLen) || nameLen > r.remaining()) return false;
+        std::string name(nameLen, '\0');
+        r.raw(name.data(), nameLen);
+        float t[12];
+        if (!r.raw(t, sizeof(t))) return false;
+
+        quint32 vertexCount = 0;
+        if (!r.u32(vertexCount) || vertexCount > r.remaining() / sizeof(Vertex)) return false;
+        std::vector<Vertex> vertices(vertexCount);
+        r.raw(vertices.data(), vertexCount * sizeof(Vertex));
+
+        quint32 indexCount = 0;
+        if (!r.u32(indexCount) || indexCount > r.remaining() / sizeof(uint32_t) || indexCount % 3 != 0) return false;
+        indices.resize(indexCount);
+        r.raw(indices.data(), indexCount * sizeof(uint32_t));
+        std::vector<Face> faces;
+        faces.reserve(indexCount / 3);
+        for (quint32 i = 0; i < indexCount; i += 3) {
+            if (indices[i] >= vertexCount || indices[i+1] >= vertexCount || indices[i+2] >= vertexCount) continue;
+            faces.push_back(Face{{static_cast<int>(indices[i]), static_cast<int>(indices[i+1]), static_cast<int>(indices[i+2])}});
+        }
+
+        auto o = std::make_unique<SceneObject>(std::move(vertices), std::move(faces), name);
+        o->x = t[0]; o->y = t[1]; o->z = t[2];
+        o->rx = t[3]; o->ry = t[4]; o->rz = t[5];
+        o->sx = t[6]; o->sy = t[7]; o->sz = t[8];
+        o->r = t[9]; o->g = t[10]; o->b = t[11];
+        o->isStatic = false;
+        objects.push_back(std::move(o));
+    }
+    return true;
+}
+
+} // namespace
+
+QByteArray SceneBinary::save(const BakedScene &scene) {
+    QByteArray out;
+    Writer w(out);
+    w.u32(Magic);
+    w.u32(Version);
+
+    w.u32(static_cast<quint32>(scene.batches.size()));
+    for (const auto &b : scene.batches) {
+        for (float v : {b.color.x(), b.color.y(), b.color.z()}) w.f32(v);
+        w.raw(&b.boundsMin, sizeof(Vertex));
+        w.raw(&b.boundsMax, sizeof(Vertex));
+        w.u32(static_cast<quint32>(b.vertices.size()));
+        w.raw(b.vertices.data(), b.vertices.size() * sizeof(Vertex));
+        w.u32(static_cast<quint32>(b.indices.size()));
+        w.raw(b.indices.data(), b.indices.size() * sizeof(uint32_t));
+    }
+
+    w.u32(static_cast<quint32>(scene.dynamicObjects.size()));
+    std::vector<uint32_t> indices;
+    for (const auto &ptr : scene.dynamicObjects) {
+        const SceneObject &o = *ptr;
+        const QByteArray name = QByteArray::fromStdString(o.name);
+        w.u32(static_cast<quint32>(name.size()));
+        w.raw(name.constData(), name.size());
+        for (float v : {o.x, o.y, o.z, o.rx, o.ry, o.rz, o.sx, o.sy, o.sz, o.r, o.g, o.b}) w.f32(v);
+
+        w.u32(static_cast<quint32>(o.vertices.size()));
+        w.raw(o.vertices.data(), o.vertices.size() * sizeof(Vertex));
+
+        // Грани сразу триангулируются: Player рисует только треугольники.
+        indices.clear();
+        for (const auto &f : o.faces) {
+            for (size_t i = 1; i + 1 < f.indices.size(); ++i) {
+                indices.push_back(static_cast<uint32_t>(f.indices[0]));
+                indices.push_back(static_cast<uint32_t>(f.indices[i]));
+                indices.push_back(static_cast<uint32_t>(f.indices[i + 1]));
+            }
+        }
+        w.u32(static_cast<quint32>(indices.size()));
+        w.raw(indices.data(), indices.size() * sizeof(uint32_t));
+    }
+    return out;
+}
+
+bool SceneBinary::load(const QByteArray &data, BakedScene &scene) {
+    Reader r(data);
+    quint32 magic = 0, version = 0, count = 0;
+    if (!r.u32(magic) || magic != Magic) return false;
+    if (!r.u32(version) || version < 1 || version > Version) return false;
+
+    BakedScene result;
+    if (version >= 2) {
+        if (!r.u32(count)) return false;
+        result.batches.reserve(count);
+        for (quint32 n = 0; n < count; ++n) {
+            BakedBatch b;
+            float color[3];
+            if (!r.raw(color, sizeof(color)) || !r.raw(&b.boundsMin, sizeof(Vertex)) || !r.raw(&b.boundsMax, sizeof(Vertex))) return false;
+            b.color = QVector3D(color[0], color[1], color[2]);
+            quint32 vertexCount = 0, indexCount = 0;
+            if (!r.u32(vertexCount) || vertexCount > r.remaining() / sizeof(Vertex)) return false;
+            b.vertices.resize(vertexCount);
+            r.raw(b.vertices.data(), vertexCount * sizeof(Vertex));
+            if (!r.u32(indexCount) || indexCount > r.remaining() / sizeof(uint32_t) || indexCount % 3 != 0) return false;
+            b.indices.resize(indexCount);
+            r.raw(b.indices.data(), indexCount * sizeof(uint32_t));
+            if (std::any_of(b.indices.begin(), b.indices.end(), [vertexCount](uint32_t i){ return i >= vertexCount; })) return false;
+            result.batches.push_back(std::move(b));
+        }
+    }
+
+    if (!readObjects(r, result.dynamicObjects)) return false;
+    scene = std::move(result);
+    return true;
+}
+
+bool SceneBinary::readIndex(QIODevice &file, std::vector<BatchRecord> &batches, SceneObjectList &dynamicObjects) {
+    batches.clear();
+    dynamicObjects.clear();
+    const auto readRaw = [&file](void *dst, qint64 n) { return file.read(static_cast<char*>(dst), n) == n; };
+    quint32 magic = 0, version = 0, count = 0;
+    if (!readRaw(&magic, 4) || magic != Magic) return false;
+    if (!readRaw(&version, 4) || version < 1 || version > Version) return false;
+
+    if (version >= 2) {
+        if (!readRaw(&count, 4)) return false;
+        batches.reserve(count);
+        for (quint32 n = 0; n < count; ++n) {
+            BatchRecord b;
+            float color[3];
+            if (!readRaw(color, sizeof(color)) || !readRaw(&b.boundsMin, sizeof(Vertex)) || !readRaw(&b.boundsMax, sizeof(Vertex))) return false;
+            b.color = QVector3D(color[0], color[1], color[2]);
+            if (!readRaw(&b.vertexCount, 4)) return false;
+            b.offset = file.pos();
+            // Геометрия пропускается: грузится потом, по запросу
+            const qint64 indexAt = b.offset + qint64(b.vertexCount) * qint64(sizeof(Vertex));
+            if (indexAt + 4 > file.size() || !file.seek(indexAt) || !readRaw(&b.indexCount, 4)) return false;
+            const qint64 next = file.pos() + qint64(b.indexCount) * qint64(sizeof(uint32_t));
+            if (b.indexCount % 3 != 0 || next > file.size() || !file.seek(next)) return false;
+            batches.push_back(b);
+        }
+    }
+
+    // Динамические объекты малы и двигаются — читаются сразу
+    const QByteArray rest = file.readAll();
+    Reader r(rest);
+    return readObjects(r, dynamicObjects);
+}
+
+bool SceneBinary::readBatch(QIODevice &file, const BatchRecord &record, BakedBatch &batch) {
+    batch.color = record.color;
+    batch.boundsMin = record.boundsMin;
+    batch.boundsMax = record.boundsMax;
+    batch.vertices.resize(record.vertexCount);
+    batch.indices.resize(record.indexCount);
+    const qint64 vertexBytes = qint64(record.vertexCount) * qint64(sizeof(Vertex));
+    const qint64 indexBytes = qint64(record.indexCount) * qint64(sizeof(uint32_t));
+    quint32 indexCount = 0;
+    if (!file.seek(record.offset)) return false;
+    if (file.read(reinterpret_cast<char*>(batch.vertices.data()), vertexBytes) != vertexBytes) return false;
+    if (file.read(reinterpret_cast<char*>(&indexCount), 4) != 4 || indexCount != record.indexCount) return false;
+    if (file.read(reinterpret_cast<char*>(batch.indices.data()), indexBytes) != indexBytes) return false;
+    const quint32 vertexCount = record.vertexCount;
+    return std::none_of(batch.indices.begin(), batch.indices.end(), [vertexCount](uint32_t i){ return i >= vertexCount; });
+}
@@ -0,0 +1,40 @@
+// src/core/SceneBinary.hpp
+#pragma once
+#include <QByteArray>
+#include <QIODevice>
+#include <vector>
+#include "SceneBaker.hpp"
+
+// Бинарный формат сцены для Player (.scbin): без JSON и текстового OBJ,
+// массивы вершин/индексов пишутся как есть (little-endian), читаются одним memcpy.
+//
+//   u32 magic 'SCBN', u32 version, [v2+] u32 batchCount, батчи, u32 objectCount, объекты
+//   батч:   f32[3] color, f32[6] bounds, u32 vertexCount, f32[3*vertexCount], u32 indexCount, u32[indexCount]
+//   объект: u32 nameLen, name utf8, f32[9] transform, f32[3] color,
+//           u32 vertexCount, f32[3*vertexCount], u32 indexCount, u32[indexCount] (треугольники)
+namespace SceneBinary {
+    constexpr quint32 Magic = 0x4E424353; // "SCBN"
+    constexpr quint32 Version = 2;
+
+    QByteArray save(const BakedScene &scene);
+    bool load(const QByteArray &data, BakedScene &scene);
+
+    // Оглавление батча для потоковой загрузки: всё, кроме геометрии,
+    // и смещение её начала (массива вершин) в файле.
+    struct BatchRecord {
+        QVector3D color;
+        Vertex boundsMin{0, 0, 0};
+        Vertex boundsMax{0, 0, 0};
+        qint64 offset = 0;
+        quint32 vertexCount = 0;
+        quint32 indexCount = 0;
+        size_t bytes() const { return size_t(vertexCount) * sizeof(Vertex) + size_t(indexCount) * sizeof(uint32_t); }
+    };
+    // Читает заголовки батчей, пропуская геометрию, и целиком — динамические объекты
+    bool readIndex(QIODevice &file, std::vector<BatchRecord> &batches, SceneObjectList &dynamicObjects);
+    // Геометрия одного батча по оглавлению; file — своё устройство на поток
+    bool readBatch(QIODevice &file, const BatchRecord &record, BakedBatch &batch);
+    inline bool isBinary(const QByteArray &data) {
+        return data.size() >= 4 && *reinterpret_cast<const quint32*>(data.constData()) == Magic;
+    }
+}
@@ -0,0 +1,327 @@
+// src/core/SceneStore.cpp
+#include "SceneStore.hpp"
+#include "TransformHierarchy.hpp"
+#include <QJsonArray>
+#include <QMatrix4x4>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+// Порядок как в SceneObject::modelMatrix и TransformHierarchy: T * Rx * Ry * Rz * S
+QMatrix4x4 localMatrix(const TransformComponent &t) {
+    QMatrix4x4 m;
+    m.translate(t.x, t.y, t.z);
+    m.rotate(t.rx, 1.0f, 0.0f, 0.0f);
+    m.rotate(t.ry, 0.0f, 1.0f, 0.0f);
+    m.rotate(t.rz, 0.0f, 0.0f, 1.0f);
+    m.scale(t.sx, t.sy, t.sz);
+    return m;
+}
+
+// Обратно в TRS. Сдвиг (неравномерный масштаб родителя при повёрнутом
+// ребёнке) в TRS не выражается и отбрасывается
+TransformComponent fromMatrix(const QMatrix4x4 &m) {
+    TransformComponent t;
+    t.x = m(0, 3);
+    t.y = m(1, 3);
+    t.z = m(2, 3);
+    QVector3D axis[3];
+    float scale[3];
+    for (int c = 0; c < 3; ++c) {
+        axis[c] = QVector3D(m(0, c), m(1, c), m(2, c));
+        scale[c] = axis[c].length();
+    }
+    // Отражение — отрицательный масштаб по X
+    if (QVector3D::dotProduct(QVector3D::crossProduct(axis[0], axis[1]), axis[2]) < 0.0f) scale[0] = -scale[0];
+    for (int c = 0; c < 3; ++c) {
+        if (scale[c] != 0.0f) axis[c] /= scale[c];
+    }
+    t.sx = scale[0];
+    t.sy = scale[1];
+    t.sz = scale[2];
+    // R = Rx(a) * Ry(b) * Rz(c): R02 = sin b, R12 = -sin a cos b, R22 = cos a cos b,
+    // R01 = -cos b sin c, R00 = cos b cos c
+    const auto r = [&](int row, int col) { return axis[col][row]; };
+    const float sb = std::clamp(r(0, 2), -1.0f, 1.0f);
+    float a, c;
+    if (std::abs(sb) < 0.99999f) {
+        a = std::atan2(-r(1, 2), r(2, 2));
+        c = std::atan2(-r(0, 1), r(0, 0));
+    } else {
+        // Шарнирный замок: поворот вокруг X и Z неразличимы, весь он — в X
+        a = std::atan2(r(2, 1), r(1, 1));
+        c = 0.0f;
+    }
+    t.rx = qRadiansToDegrees(a);
+    t.ry = qRadiansToDegrees(std::asin(sb));
+    t.rz = qRadiansToDegrees(c);
+    return t;
+}
+
+} // namespace
+
+size_t SceneStore::slotOf(Entity e) const {
+    if (e.index >= m_handles.size()) return npos;
+    const Handle &h = m_handles[e.index];
+    return h.generation == e.generation && h.slot != UINT32_MAX ? h.slot : npos;
+}
+
+Entity SceneStore::create(SceneObject &&o) {
+    Entity e;
+    if (!m_free.empty()) {
+        e.index = m_free.back();
+        m_free.pop_back();
+    } else {
+        e.index = static_cast<uint32_t>(m_handles.size());
+        m_handles.push_back({});
+    }
+    Handle &h = m_handles[e.index];
+    h.slot = static_cast<uint32_t>(m_entities.size());
+    e.generation = h.generation;
+
+    m_entities.push_back(e);
+    m_transforms.push_back({o.x, o.y, o.z, o.rx, o.ry, o.rz, o.sx, o.sy, o.sz});
+    m_renders.push_back({o.meshKey, o.r, o.g, o.b, o.isStatic});
+    MeshComponent mesh;
+    mesh.vertices = std::move(o.vertices);
+    mesh.faces = std::move(o.faces);
+    if (!mesh.vertices.empty()) computeAABB(mesh.vertices, mesh.boundsMin, mesh.boundsMax);
+    mesh.asset = std::move(o.asset);
+    m_meshes.push_back(std::move(mesh));
+    m_names.push_back(std::move(o.name));
+    m_parents.push_back(Entity{});
+    ++m_structureVersion;
+    logChange(StructureChange::Created, e);
+    return e;
+}
+
+std::vector<Entity> SceneStore::adopt(SceneObjectList &&objects) {
+    std::unordered_map<const SceneObject*, Entity> entityOf;
+    std::vector<Entity> created;
+    created.reserve(objects.size());
+    for (auto &o : objects) {
+        const Entity e = create(std::move(*o));
+        entityOf[o.get()] = e;
+        created.push_back(e);
+    }
+    for (size_t i = 0; i < objects.size(); ++i) {
+        auto it = objects[i]->parent() ? entityOf.find(objects[i]->parent()) : entityOf.end();
+        if (it != entityOf.end()) setParent(created[i], it->second);
+    }
+    objects.clear();
+    return created;
+}
+
+bool SceneStore::destroy(Entity e) {
+    const size_t slot = slotOf(e);
+    if (slot == npos) return false;
+    // Поиск детей — проход по плотному массиву связей. Мир ребёнка был
+    // W(дед) * L(e) * L(ребёнок): новая локальная — L(e) * L(ребёнок), и он не сдвигается
+    const Entity grandParent = m_parents[slot];
+    const QMatrix4x4 removed = localMatrix(m_transforms[slot]);
+    for (size_t i = 0; i < m_parents.size(); ++i) {
+        if (m_parents[i] != e) continue;
+        m_parents[i] = grandParent;
+        m_transforms[i] = fromMatrix(removed * localMatrix(m_transforms[i]));
+        logChange(StructureChange::Reparented, m_entities[i], grandParent);
+    }
+
+    const size_t last = m_entities.size() - 1;
+    if (slot != last) {
+        m_entities[slot] = m_entities[last];
+        m_transforms[slot] = m_transforms[last];
+        m_renders[slot] = m_renders[last];
+        m_meshes[slot] = std::move(m_meshes[last]);
+        m_names[slot] = std::move(m_names[last]);
+        m_parents[slot] = m_parents[last];
+        m_handles[m_entities[slot].index].slot = static_cast<uint32_t>(slot);
+    }
+    m_entities.pop_back();
+    m_transforms.pop_back();
+    m_renders.pop_back();
+    m_meshes.pop_back();
+    m_names.pop_back();
+    m_parents.pop_back();
+
+    Handle &h = m_handles[e.index];
+    h.slot = UINT32_MAX;
+    ++h.generation;
+    m_free.push_back(e.index);
+    ++m_structureVersion;
+    logChange(StructureChange::Destroyed, e);
+    return true;
+}
+
+void SceneStore::clear() {
+    for (const Entity &e : m_entities) {
+        Handle &h = m_handles[e.index];
+        h.slot = UINT32_MAX;
+        ++h.generation;
+        m_free.push_back(e.index);
+    }
+    m_entities.clear();
+    m_transforms.clear();
+    m_renders.clear();
+    m_meshes.clear();
+    m_names.clear();
+    m_parents.clear();
+    ++m_structureVersion;
+    // Всё, что было до очистки, наблюдателю уже не нужно
+    if (m_logChanges) m_changes.clear();
+    logChange(StructureChange::Cleared, Entity{});
+}
+
+bool SceneStore::isDescendant(Entity e, Entity ancestor) const {
+    for (Entity a = e; alive(a); a = parent(a)) {
+        if (a == ancestor) return true;
+    }
+    return false;
+}
+
+bool SceneStore::setParent(Entity child, Entity p) {
+    const size_t slot = slotOf(child);
+    if (slot == npos) return false;
+    if (p && (!alive(p) || isDescendant(p, child))) return false;
+    m_parents[slot] = p;
+    ++m_structureVersion;
+    logChange(StructureChange::Reparented, child, p);
+    return true;
+}
+
+float &SceneStore::field(Entity e, SceneField f) {
+    const size_t slot = slotOf(e);
+    TransformComponent &t = m_transforms[slot];
+    RenderComponent &r = m_renders[slot];
+    switch (f) {
+    case SceneField::PosX: return t.x;
+    case SceneField::PosY: return t.y;
+    case SceneField::PosZ: return t.z;
+    case SceneField::RotX: return t.rx;
+    case SceneField::RotY: return t.ry;
+    case SceneField::RotZ: return t.rz;
+    case SceneField::SclX: return t.sx;
+    case SceneField::SclY: return t.sy;
+    case SceneField::SclZ: return t.sz;
+    case SceneField::ColorR: return r.r;
+    case SceneField::ColorG: return r.g;
+    case SceneField::ColorB: return r.b;
+    }
+    return t.x;
+}
+
+void SceneStore::draw(Renderer &renderer, const TransformHierarchy &worlds) const {
+    for (size_t i = 0; i < m_entities.size(); ++i) {
+        const RenderComponent &r = m_renders[i];
+        renderer.ensureMesh(r.meshKey, m_meshes[i].vertices, m_meshes[i].faces);
+        renderer.submit(r.meshKey, worlds.world(i), {RenderProgram::Lit, QVector3D(r.r, r.g, r.b)});
+    }
+}
+
+namespace {
+// Луч против AABB (метод плит); tFar < 0 — коробка позади
+bool rayHitsBox(const QVector3D &o, const QVector3D &d, const Vertex &mn, const Vertex &mx) {
+    float tNear = -std::numeric_limits<float>::max();
+    float tFar = std::numeric_limits<float>::max();
+    const float lo[3] = {mn.x, mn.y, mn.z};
+    const float hi[3] = {mx.x, mx.y, mx.z};
+    for (int a = 0; a < 3; ++a) {
+        if (std::abs(d[a]) < 1e-12f) {
+            if (o[a] < lo[a] || o[a] > hi[a]) return false;
+            continue;
+        }
+        float t0 = (lo[a] - o[a]) / d[a];
+        float t1 = (hi[a] - o[a]) / d[a];
+        if (t0 > t1) std::swap(t0, t1);
+        tNear = std::max(tNear, t0);
+        tFar = std::min(tFar, t1);
+        if (tNear > tFar) return false;
+    }
+    return tFar >= 0.0f;
+}
+}
+
+Entity SceneStore::pick(const QVector3D &origin, const QVector3D &dir, const TransformHierarchy &worlds) const {
+    Entity best;
+    float bestT = std::numeric_limits<float>::max();
+    for (size_t i = 0; i < m_entities.size(); ++i) {
+        const MeshComponent &mesh = m_meshes[i];
+        if (mesh.faces.empty()) continue;
+        bool invertible = false;
+        const QMatrix4x4 inv = worlds.world(i).inverted(&invertible);
+        if (!invertible || !rayHitsBox(inv.map(origin), inv.mapVector(dir), mesh.boundsMin, mesh.boundsMax)) continue;
+        float t = 0.0f;
+        if (intersectTriangles(mesh.vertices, mesh.faces, worlds.world(i), origin, dir, t) && t < bestT) {
+            bestT = t;
+            best = m_entities[i];
+        }
+    }
+    return best;
+}
+
+size_t SceneStore::setAssetMesh(const std::string &asset, const std::vector<Vertex> &vertices, const std::vector<Face> &faces) {
+    if (asset.empty()) return 0;
+    size_t updated = 0;
+    for (size_t i = 0; i < m_meshes.size(); ++i) {
+        MeshComponent &mesh = m_meshes[i];
+        if (mesh.asset != asset) continue;
+        mesh.vertices = vertices;
+        mesh.faces = faces;
+        mesh.boundsMin = mesh.boundsMax = Vertex{0, 0, 0};
+        if (!vertices.empty()) computeAABB(vertices, mesh.boundsMin, mesh.boundsMax);
+        m_renders[i].meshKey = Renderer::newMeshKey();
+        ++updated;
+    }
+    return updated;
+}
+
+SceneObject SceneStore::toObject(Entity e) const {
+    const size_t slot = slotOf(e);
+    SceneObject o(m_meshes[slot].vertices, m_meshes[slot].faces, m_names[slot]);
+    const TransformComponent &t = m_transforms[slot];
+    o.x = t.x; o.y = t.y; o.z = t.z;
+    o.rx = t.rx; o.ry = t.ry; o.rz = t.rz;
+    o.sx = t.sx; o.sy = t.sy; o.sz = t.sz;
+    const RenderComponent &r = m_renders[slot];
+    o.r = r.r; o.g = r.g; o.b = r.b;
+    o.isStatic = r.isStatic;
+    o.asset = m_meshes[slot].asset;
+    return o;
+}
+
+SceneObjectList SceneStore::toObjects() const {
+    SceneObjectList objects;
+    objects.reserve(m_entities.size());
+    for (const Entity &e : m_entities) objects.push_back(std::make_unique<SceneObject>(toObject(e)));
+    for (size_t i = 0; i < m_entities.size(); ++i) {
+        const size_t p = slotOf(m_parents[i]);
+        if (p != npos) objects[i]->setParent(objects[p].get());
+    }
+    return objects;
+}
+
+QJsonObject sceneToJson(const SceneStore &store, MeshEncoding encoding) {
+    const auto &transforms = store.transforms();
+    const auto &renders = store.renders();
+    const auto &meshes = store.meshes();
+    const auto &parents = store.parents();
+    QJsonArray arr;
+    for (size_t i = 0; i < store.size(); ++i) {
+        const TransformComponent &t = transforms[i];
+        const RenderComponent &r = renders[i];
+        QJsonObject jo;
+        jo["name"] = QString::fromStdString(store.name(store.entityAt(i)));
+        jo["transform"] = QJsonObject{{"pos", QJsonArray{t.x, t.y, t.z}}, {"rot", QJsonArray{t.rx, t.ry, t.rz}}, {"scl", QJsonArray{t.sx, t.sy, t.sz}}};
+        if (!meshes[i].asset.empty()) jo["asset"] = QString::fromStdString(meshes[i].asset);
+        writeMeshJson(jo, meshes[i].vertices, meshes[i].faces, encoding);
+        jo["color"] = QJsonArray{r.r, r.g, r.b};
+        jo["static"] = r.isStatic;
+        const size_t p = store.slotOf(parents[i]);
+        if (p != SceneStore::npos) jo["parent"] = static_cast<int>(p);
+        arr.push_back(jo);
+    }
+    return QJsonObject{{"objects", arr}};
+}
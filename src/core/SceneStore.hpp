@@ -0,0 +1,147 @@
+// src/core/SceneStore.hpp
+#pragma once
+#include <QJsonObject>
+#include <QVector3D>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Mesh.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+
+class TransformHierarchy;
+
+// Хэндл сущности: индекс в таблице хэндлов + поколение. После удаления
+// поколение растёт, и старый хэндл перестаёт быть живым, даже если индекс
+// занят новой сущностью.
+struct Entity {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == UINT32_MAX; }
+    explicit operator bool() const { return !isNull(); }
+    bool operator==(const Entity &o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Entity &o) const { return !(*this == o); }
+
+    // Упаковка в одно число — для QVariant и ключей хэшей
+    uint64_t id() const { return (uint64_t(generation) << 32) | index; }
+    static Entity fromId(uint64_t id) { return {uint32_t(id), uint32_t(id >> 32)}; }
+};
+
+struct TransformComponent {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    float rx = 0.0f, ry = 0.0f, rz = 0.0f;
+    float sx = 1.0f, sy = 1.0f, sz = 1.0f;
+};
+
+struct RenderComponent {
+    uint64_t meshKey = 0;
+    float r = 0.75f, g = 0.8f, b = 1.0f;
+    bool isStatic = true;
+};
+
+struct MeshComponent {
+    std::vector<Vertex> vertices;
+    std::vector<Face> faces;
+    Vertex boundsMin{0, 0, 0}; // локальный AABB — грубый отсев при выборе
+    Vertex boundsMax{0, 0, 0};
+    std::string asset; // GUID ассета-источника (SceneObject::asset)
+};
+
+// Запись журнала структурных изменений (см. SceneStore::setChangeLog)
+struct StructureChange {
+    enum Kind : uint8_t { Created, Destroyed, Reparented, Cleared };
+    Kind kind;
+    Entity entity;
+    Entity parent; // Reparented — новый родитель
+};
+
+// Редактируемые поля — для инспектора и программных правок
+enum class SceneField { PosX, PosY, PosZ, RotX, RotY, RotZ, SclX, SclY, SclZ, ColorR, ColorG, ColorB };
+
+// Сцена редактора: компоненты лежат плотными массивами, слот i каждого
+// массива — одна и та же сущность. Системы (отрисовка, выбор, сохранение,
+// иерархия) идут по массивам подряд. Удаление — swap-remove: последняя
+// сущность переезжает в освободившийся слот, хэндлы при этом не меняются.
+//
+// SceneObject остаётся форматом обмена (загрузка, запекание, Player):
+// adopt() забирает данные объектов, toObjects() отдаёт копию.
+class SceneStore {
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    Entity create(SceneObject &&object);
+    // Переносит список целиком, связи parent переводятся в хэндлы
+    std::vector<Entity> adopt(SceneObjectList &&objects);
+    // Дети удалённой сущности переходят к её родителю; локальные трансформы
+    // пересчитываются так, что мировое положение детей не меняется
+    bool destroy(Entity e);
+    void clear();
+
+    bool alive(Entity e) const { return slotOf(e) != npos; }
+    size_t size() const { return m_entities.size(); }
+    bool empty() const { return m_entities.empty(); }
+    size_t slotOf(Entity e) const;
+    Entity entityAt(size_t slot) const { return m_entities[slot]; }
+
+    // Плотные массивы, индекс — слот
+    const std::vector<TransformComponent> &transforms() const { return m_transforms; }
+    const std::vector<RenderComponent> &renders() const { return m_renders; }
+    const std::vector<MeshComponent> &meshes() const { return m_meshes; }
+    const std::vector<Entity> &parents() const { return m_parents; }
+
+    // Доступ по хэндлу; хэндл должен быть живым
+    TransformComponent &transform(Entity e) { return m_transforms[slotOf(e)]; }
+    RenderComponent &render(Entity e) { return m_renders[slotOf(e)]; }
+    const MeshComponent &mesh(Entity e) const { return m_meshes[slotOf(e)]; }
+    const std::string &name(Entity e) const { return m_names[slotOf(e)]; }
+    Entity parent(Entity e) const { return m_parents[slotOf(e)]; }
+    // false — связь дала бы цикл
+    bool setParent(Entity child, Entity parent);
+    bool isDescendant(Entity e, Entity ancestor) const;
+    float &field(Entity e, SceneField f);
+    // Новый меш всем сущностям ассета asset (переимпорт источника); сколько обновлено.
+    // Старые ключи мешей Renderer вытеснит сам
+    size_t setAssetMesh(const std::string &asset, const std::vector<Vertex> &vertices, const std::vector<Face> &faces);
+
+    // Растёт при любом изменении состава или связей
+    uint64_t structureVersion() const { return m_structureVersion; }
+    // Журнал изменений состава и связей — для наблюдателей, которым мало
+    // structureVersion (дерево иерархии обновляется по нему построчно).
+    // Выключен — не копится; включённый забирают takeChanges()
+    void setChangeLog(bool on) { m_logChanges = on; m_changes.clear(); }
+    std::vector<StructureChange> takeChanges() { std::vector<StructureChange> out; out.swap(m_changes); return out; }
+
+    // Системы
+    void draw(Renderer &renderer, const TransformHierarchy &worlds) const;
+    Entity pick(const QVector3D &origin, const QVector3D &dir, const TransformHierarchy &worlds) const;
+    SceneObject toObject(Entity e) const;
+    SceneObjectList toObjects() const;
+
+private:
+    // Таблица хэндлов: index -> слот; свободные индексы — в m_free
+    struct Handle {
+        uint32_t slot = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Handle> m_handles;
+    std::vector<uint32_t> m_free;
+
+    std::vector<Entity> m_entities; // слот -> хэндл
+    std::vector<TransformComponent> m_transforms;
+    std::vector<RenderComponent> m_renders;
+    std::vector<MeshComponent> m_meshes;
+    std::vector<std::string> m_names;
+    std::vector<Entity> m_parents;
+    uint64_t m_structureVersion = 0;
+
+    void logChange(StructureChange::Kind kind, Entity e, Entity parent = Entity{}) {
+        if (m_logChanges) m_changes.push_back({kind, e, parent});
+    }
+    bool m_logChanges = false;
+    std::vector<StructureChange> m_changes;
+};
+
+// Тот же формат .scene, что и sceneToJson для списка объектов
+QJsonObject sceneToJson(const SceneStore &store, MeshEncoding encoding = MeshEncoding::Obj);
@@ -0,0 +1,181 @@
+// src/core/ScreenPicker.cpp
+#include "ScreenPicker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+void eraseFrom(std::vector<uint32_t> &cell, uint32_t id) {
+    auto it = std::find(cell.begin(), cell.end(), id);
+    if (it == cell.end()) return;
+    *it = cell.back();
+    cell.pop_back();
+}
+
+float segmentDistance2(float px, float py, float ax, float ay, float bx, float by) {
+    const float dx = bx - ax, dy = by - ay;
+    const float len2 = dx * dx + dy * dy;
+    float t = len2 > 0.0f ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0f;
+    t = std::clamp(t, 0.0f, 1.0f);
+    const float cx = ax + t * dx - px, cy = ay + t * dy - py;
+    return cx * cx + cy * cy;
+}
+}
+
+bool ScreenPicker::setView(const QMatrix4x4 &viewProjection, int width, int height) {
+    if (m_valid && viewProjection == m_viewProjection && width == m_width && height == m_height) return false;
+    m_viewProjection = viewProjection;
+    m_width = std::max(1, width);
+    m_height = std::max(1, height);
+    m_valid = false;
+    return true;
+}
+
+ScreenPicker::Projected ScreenPicker::project(const Vertex &v) const {
+    // Столбцовый порядок QMatrix4x4; без QVector4D — это горячий цикл rebuild
+    const float *m = m_viewProjection.constData();
+    const float cx = m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12];
+    const float cy = m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13];
+    const float cz = m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14];
+    const float cw = m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15];
+    if (cw <= 1e-6f) return {0.0f, 0.0f, 0.0f, false};
+    const float inv = 1.0f / cw;
+    return {(cx * inv * 0.5f + 0.5f) * m_width, (0.5f - cy * inv * 0.5f) * m_height, cz * inv, true};
+}
+
+template <class Fn>
+void ScreenPicker::forEachEdgeCell(const Projected &a, const Projected &b, Fn fn) const {
+    if (!a.visible || !b.visible) return;
+    // Обрезка по экрану (Лян — Барски), чтобы длинные рёбра не гуляли за его пределами
+    float t0 = 0.0f, t1 = 1.0f;
+    const float dx = b.x - a.x, dy = b.y - a.y;
+    const float p[4] = {-dx, dx, -dy, dy};
+    const float q[4] = {a.x, float(m_width) - a.x, a.y, float(m_height) - a.y};
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0f) {
+            if (q[i] < 0.0f) return;
+            continue;
+        }
+        const float r = q[i] / p[i];
+        if (p[i] < 0.0f) t0 = std::max(t0, r);
+        else t1 = std::min(t1, r);
+        if (t0 > t1) return;
+    }
+    const float x0 = a.x + t0 * dx, y0 = a.y + t0 * dy;
+    const float x1 = a.x + t1 * dx, y1 = a.y + t1 * dy;
+    // Шаг в полъячейки; пропущенные на диагонали углы покрывает запас кольца в запросе
+    const float length = std::hypot(x1 - x0, y1 - y0);
+    const int steps = static_cast<int>(length / (CellPx * 0.5f)) + 1;
+    int last = -1;
+    for (int i = 0; i <= steps; ++i) {
+        const float t = float(i) / steps;
+        const int cx = std::clamp(static_cast<int>((x0 + t * (x1 - x0)) / CellPx), 0, m_cols - 1);
+        const int cy = std::clamp(static_cast<int>((y0 + t * (y1 - y0)) / CellPx), 0, m_rows - 1);
+        const int cell = cellIndex(cx, cy);
+        if (cell != last) fn(cell);
+        last = cell;
+    }
+}
+
+void ScreenPicker::insertEdge(uint32_t edge) {
+    const auto &e = m_edgeEnds[edge];
+    forEachEdgeCell(m_screen[e.a], m_screen[e.b], [&](int cell){ m_edgeCells[cell].push_back(edge); });
+}
+
+void ScreenPicker::removeEdge(uint32_t edge) {
+    const auto &e = m_edgeEnds[edge];
+    forEachEdgeCell(m_screen[e.a], m_screen[e.b], [&](int cell){ eraseFrom(m_edgeCells[cell], edge); });
+}
+
+void ScreenPicker::rebuild(const std::vector<Vertex> &vertices, const HalfEdgeMesh &topology) {
+    m_cols = (m_width + CellPx - 1) / CellPx;
+    m_rows = (m_height + CellPx - 1) / CellPx;
+    const size_t cells = size_t(m_cols) * m_rows;
+    // Ячейки сохраняют ёмкость между пересборками
+    m_vertexCells.resize(cells);
+    m_edgeCells.resize(cells);
+    for (auto &c : m_vertexCells) c.clear();
+    for (auto &c : m_edgeCells) c.clear();
+
+    m_screen.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Projected p = project(vertices[i]);
+        m_screen[i] = p;
+        if (!p.visible || p.x < 0.0f || p.y < 0.0f || p.x >= m_width || p.y >= m_height) continue;
+        m_vertexCells[cellIndex(int(p.x) / CellPx, int(p.y) / CellPx)].push_back(static_cast<uint32_t>(i));
+    }
+
+    m_edgeEnds = topology.edges();
+    for (uint32_t e = 0; e < m_edgeEnds.size(); ++e) insertEdge(e);
+    m_valid = true;
+}
+
+void ScreenPicker::moveVertex(uint32_t v, const Vertex &position, const HalfEdgeMesh &topology) {
+    if (!m_valid || v >= m_screen.size()) return;
+    // Рёбра снимаются по старым экранным точкам, ставятся по новым
+    for (auto e = topology.vertexEdgesBegin(v); e != topology.vertexEdgesEnd(v); ++e) removeEdge(*e);
+    const Projected old = m_screen[v];
+    if (old.visible && old.x >= 0.0f && old.y >= 0.0f && old.x < m_width && old.y < m_height) {
+        eraseFrom(m_vertexCells[cellIndex(int(old.x) / CellPx, int(old.y) / CellPx)], v);
+    }
+    const Projected p = project(position);
+    m_screen[v] = p;
+    if (p.visible && p.x >= 0.0f && p.y >= 0.0f && p.x < m_width && p.y < m_height) {
+        m_vertexCells[cellIndex(int(p.x) / CellPx, int(p.y) / CellPx)].push_back(v);
+    }
+    for (auto e = topology.vertexEdgesBegin(v); e != topology.vertexEdgesEnd(v); ++e) insertEdge(*e);
+}
+
+uint32_t ScreenPicker::pickVertex(const QPointF &pos, float radiusPx) const {
+    if (!m_valid) return None;
+    const float px = float(pos.x()), py = float(pos.y());
+    const int cx0 = std::max(0, int(std::floor((px - radiusPx) / CellPx)));
+    const int cx1 = std::min(m_cols - 1, int(std::floor((px + radiusPx) / CellPx)));
+    const int cy0 = std::max(0, int(std::floor((py - radiusPx) / CellPx)));
+    const int cy1 = std::min(m_rows - 1, int(std::floor((py + radiusPx) / CellPx)));
+
+    uint32_t best = None;
+    float bestD2 = radiusPx * radiusPx;
+    float bestDepth = std::numeric_limits<float>::max();
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            for (uint32_t v : m_vertexCells[cellIndex(cx, cy)]) {
+                const Projected &p = m_screen[v];
+                const float d2 = (p.x - px) * (p.x - px) + (p.y - py) * (p.y - py);
+                if (d2 < bestD2 || (d2 == bestD2 && p.depth < bestDepth)) {
+                    best = v;
+                    bestD2 = d2;
+                    bestDepth = p.depth;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+uint32_t ScreenPicker::pickEdge(const QPointF &pos, float radiusPx) const {
+    if (!m_valid) return None;
+    const float px = float(pos.x()), py = float(pos.y());
+    // Кольцо ячеек с запасом в одну: шаг растеризации может срезать угол
+    const int cx0 = std::max(0, int(std::floor((px - radiusPx) / CellPx)) - 1);
+    const int cx1 = std::min(m_cols - 1, int(std::floor((px + radiusPx) / CellPx)) + 1);
+    const int cy0 = std::max(0, int(std::floor((py - radiusPx) / CellPx)) - 1);
+    const int cy1 = std::min(m_rows - 1, int(std::floor((py + radiusPx) / CellPx)) + 1);
+
+    uint32_t best = None;
+    float bestD2 = radiusPx * radiusPx;
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            for (uint32_t e : m_edgeCells[cellIndex(cx, cy)]) {
+                const Projected &a = m_screen[m_edgeEnds[e].a];
+                const Projected &b = m_screen[m_edgeEnds[e].b];
+                const float d2 = segmentDistance2(px, py, a.x, a.y, b.x, b.y);
+                if (d2 < bestD2) {
+                    best = e;
+                    bestD2 = d2;
+                }
+            }
+        }
+    }
+    return best;
+}
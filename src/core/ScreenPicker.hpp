@@ -0,0 +1,58 @@
+// src/core/ScreenPicker.hpp
+#pragma once
+#include <QMatrix4x4>
+#include <QPointF>
+#include <cstdint>
+#include <vector>
+#include "HalfEdgeMesh.hpp"
+#include "Mesh.hpp"
+
+// Выбор вершин и рёбер под курсором через экранную сетку корзин.
+//
+// rebuild() проецирует все вершины один раз на ракурс и раскладывает их
+// по ячейкам CellPx x CellPx, рёбра — по ячейкам, которые пересекает их
+// экранный отрезок. Запрос смотрит только ячейки в радиусе курсора.
+// Сдвиг вершины (moveVertex) перекладывает её и инцидентные рёбра, не
+// трогая остальное; полная пересборка нужна только при смене ракурса.
+class ScreenPicker {
+public:
+    static constexpr int CellPx = 16;
+    static constexpr uint32_t None = UINT32_MAX;
+
+    // Возвращает true, если ракурс сменился и индекс устарел
+    bool setView(const QMatrix4x4 &viewProjection, int width, int height);
+    void invalidate() { m_valid = false; }
+    bool isValid() const { return m_valid; }
+    void rebuild(const std::vector<Vertex> &vertices, const HalfEdgeMesh &topology);
+    void moveVertex(uint32_t v, const Vertex &position, const HalfEdgeMesh &topology);
+
+    // Ближайшая к курсору в пределах радиуса; при равенстве — ближняя к камере
+    uint32_t pickVertex(const QPointF &pos, float radiusPx) const;
+    uint32_t pickEdge(const QPointF &pos, float radiusPx) const;
+
+    // Экранная точка вершины после последнего rebuild/moveVertex
+    QPointF screenPos(uint32_t v) const { return QPointF(m_screen[v].x, m_screen[v].y); }
+
+private:
+    struct Projected {
+        float x, y, depth;
+        bool visible; // перед камерой
+    };
+
+    Projected project(const Vertex &v) const;
+    int cellIndex(int cx, int cy) const { return cy * m_cols + cx; }
+    // Ячейки, которые пересекает отрезок (уже обрезанный по экрану)
+    template <class Fn> void forEachEdgeCell(const Projected &a, const Projected &b, Fn fn) const;
+    void insertEdge(uint32_t edge);
+    void removeEdge(uint32_t edge);
+
+    QMatrix4x4 m_viewProjection;
+    int m_width = 0, m_height = 0;
+    int m_cols = 0, m_rows = 0;
+    bool m_valid = false;
+
+    std::vector<Projected> m_screen;
+    std::vector<std::vector<uint32_t>> m_vertexCells;
+    std::vector<std::vector<uint32_t>> m_edgeCells;
+    std::vector<HalfEdgeMesh::Edge> m_edgeEnds; // копия концов рёбер из rebuild
+};
@@ -0,0 +1,93 @@
+// src/core/TransformHierarchy.cpp
+#include "TransformHierarchy.hpp"
+#include <algorithm>
+
+const QMatrix4x4 *TransformHierarchy::worldOf(const SceneStore &store, Entity e) const {
+    const size_t slot = store.slotOf(e);
+    return slot < m_orderOf.size() ? &world(slot) : nullptr;
+}
+
+void TransformHierarchy::rebuild(const SceneStore &store) {
+    const size_t n = store.size();
+    const auto &parents = store.parents();
+
+    std::vector<std::vector<size_t>> children(n);
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t p = store.slotOf(parents[i]);
+        if (p == SceneStore::npos) roots.push_back(i);
+        else children[p].push_back(i);
+    }
+
+    // Обход в глубину: позиция родителя всегда меньше позиций детей
+    m_slot.clear();
+    m_parentPos.clear();
+    m_orderOf.assign(n, 0);
+    std::vector<std::pair<size_t, int>> stack; // (слот, позиция родителя)
+    for (size_t r : roots) {
+        stack.push_back({r, -1});
+        while (!stack.empty()) {
+            const auto [slot, parentPos] = stack.back();
+            stack.pop_back();
+            const size_t pos = m_slot.size();
+            m_slot.push_back(slot);
+            m_parentPos.push_back(parentPos);
+            m_orderOf[slot] = pos;
+            for (auto c = children[slot].rbegin(); c != children[slot].rend(); ++c) stack.push_back({*c, int(pos)});
+        }
+    }
+
+    for (auto &c : m_trs) c.assign(n, 0.0f);
+    for (auto &c : m_incoming) c.assign(n, 0.0f);
+    m_localDirty.assign(n, 1);
+    m_worldDirty.assign(n, 1);
+    m_local.assign(n, QMatrix4x4());
+    m_world.assign(n, QMatrix4x4());
+    m_structureVersion = store.structureVersion();
+}
+
+void TransformHierarchy::update(const SceneStore &store) {
+    // SceneStore::setParent не даёт циклов, так что обход покрывает все слоты
+    if (store.structureVersion() != m_structureVersion) rebuild(store);
+    const size_t n = m_slot.size();
+    const auto &transforms = store.transforms();
+
+    // Сбор из плотного массива компонентов в SoA
+    for (size_t k = 0; k < n; ++k) {
+        const TransformComponent &t = transforms[m_slot[k]];
+        m_incoming[X][k] = t.x;   m_incoming[Y][k] = t.y;   m_incoming[Z][k] = t.z;
+        m_incoming[RX][k] = t.rx; m_incoming[RY][k] = t.ry; m_incoming[RZ][k] = t.rz;
+        m_incoming[SX][k] = t.sx; m_incoming[SY][k] = t.sy; m_incoming[SZ][k] = t.sz;
+    }
+    // Что поменялось с прошлого кадра: по компоненте за проход, без ветвлений
+    uint8_t *dirty = m_localDirty.data();
+    for (int c = 0; c < ComponentCount; ++c) {
+        const float *prev = m_trs[c].data();
+        const float *next = m_incoming[c].data();
+        for (size_t k = 0; k < n; ++k) dirty[k] |= uint8_t(prev[k] != next[k]);
+    }
+    std::swap(m_trs, m_incoming);
+
+    for (size_t k = 0; k < n; ++k) {
+        if (!dirty[k]) continue;
+        QMatrix4x4 &m = m_local[k];
+        m.setToIdentity();
+        m.translate(m_trs[X][k], m_trs[Y][k], m_trs[Z][k]);
+        m.rotate(m_trs[RX][k], 1.0f, 0.0f, 0.0f);
+        m.rotate(m_trs[RY][k], 0.0f, 1.0f, 0.0f);
+        m.rotate(m_trs[RZ][k], 0.0f, 0.0f, 1.0f);
+        m.scale(m_trs[SX][k], m_trs[SY][k], m_trs[SZ][k]);
+    }
+
+    // Родитель обработан раньше ребёнка, поэтому его флаг уже окончательный
+    m_lastUpdated = 0;
+    for (size_t k = 0; k < n; ++k) {
+        const int p = m_parentPos[k];
+        const bool d = dirty[k] || (p >= 0 && m_worldDirty[size_t(p)]);
+        m_worldDirty[k] = d;
+        if (!d) continue;
+        m_world[k] = p >= 0 ? m_world[size_t(p)] * m_local[k] : m_local[k];
+        ++m_lastUpdated;
+    }
+    std::fill(m_localDirty.begin(), m_localDirty.end(), uint8_t(0));
+}
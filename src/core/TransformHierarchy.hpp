@@ -0,0 +1,45 @@
+// src/core/TransformHierarchy.hpp
+#pragma once
+#include <QMatrix4x4>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "SceneStore.hpp"
+
+// Мировые матрицы сущностей SceneStore с учётом связей parent.
+//
+// update() вызывается раз перед кадром. Внутри сущности упорядочены обходом
+// (родитель раньше детей), локальные TRS — в SoA-массивах по компонентам:
+// сравнение с прошлым кадром идёт плотными циклами по float, которые
+// компилятор векторизует. Пересчитываются только изменившиеся локальные
+// матрицы, мировые — для них и всех их потомков (грязный флаг идёт вниз).
+class TransformHierarchy {
+public:
+    void update(const SceneStore &store);
+
+    // slot — слот SceneStore на момент последнего update()
+    const QMatrix4x4 &world(size_t slot) const { return m_world[m_orderOf[slot]]; }
+    const QMatrix4x4 *worldOf(const SceneStore &store, Entity e) const;
+
+    // Сколько мировых матриц пересчитал последний update()
+    size_t lastUpdated() const { return m_lastUpdated; }
+
+private:
+    enum Component { X, Y, Z, RX, RY, RZ, SX, SY, SZ, ComponentCount };
+
+    void rebuild(const SceneStore &store);
+
+    uint64_t m_structureVersion = UINT64_MAX;
+
+    // Всё ниже — по позициям в порядке обхода
+    std::vector<size_t> m_slot;      // позиция -> слот хранилища
+    std::vector<int> m_parentPos;    // -1 — корень
+    std::vector<size_t> m_orderOf;   // слот -> позиция
+    std::array<std::vector<float>, ComponentCount> m_trs;      // текущие значения
+    std::array<std::vector<float>, ComponentCount> m_incoming; // собранные в этом кадре
+    std::vector<uint8_t> m_localDirty;
+    std::vector<uint8_t> m_worldDirty;
+    std::vector<QMatrix4x4> m_local;
+    std::vector<QMatrix4x4> m_world;
+    size_t m_lastUpdated = 0;
+};
@@ -0,0 +1,99 @@
+// src/core/ViewportOverlay.cpp
+#include "ViewportOverlay.hpp"
+#include <cmath>
+#include <vector>
+
+ViewportOverlay::ViewportOverlay()
+    : m_gridKey(Renderer::newMeshKey()), m_axesKey(Renderer::newMeshKey()), m_boxKey(Renderer::newMeshKey()) {}
+
+void ViewportOverlay::setGrid(float halfExtent, float step, const QVector3D &color) {
+    if (halfExtent == m_gridHalfExtent && step == m_gridStep && color == m_gridColor) return;
+    m_gridHalfExtent = halfExtent;
+    m_gridStep = step;
+    m_gridColor = color;
+    m_gridDirty = true;
+}
+
+void ViewportOverlay::setAxesLength(float length) {
+    if (length == m_axesLength) return;
+    m_axesLength = length;
+    m_axesDirty = true;
+    m_gridDirty = true; // центральные линии сетки уступают место осям
+}
+
+void ViewportOverlay::setSelectionColor(const QVector3D &color) {
+    if (color == m_selectionColor) return;
+    m_selectionColor = color;
+    m_boxDirty = true;
+}
+
+void ViewportOverlay::ensureGrid(Renderer &renderer) {
+    if (!m_gridDirty && renderer.hasColorBuffer(m_gridKey)) return;
+    std::vector<ColorVertex> lines;
+    const float size = m_gridHalfExtent;
+    const float r = m_gridColor.x(), g = m_gridColor.y(), b = m_gridColor.z();
+    const int n = m_gridStep > 0.0f ? static_cast<int>(std::floor(size / m_gridStep)) : 0;
+    lines.reserve(static_cast<size_t>(2 * n + 1) * 4);
+    for (int k = -n; k <= n; ++k) {
+        if (k == 0 && m_axesLength > 0.0f) continue;
+        const float i = k * m_gridStep;
+        lines.push_back({i, 0, -size, r, g, b});
+        lines.push_back({i, 0, size, r, g, b});
+        lines.push_back({-size, 0, i, r, g, b});
+        lines.push_back({size, 0, i, r, g, b});
+    }
+    renderer.uploadColorBuffer(m_gridKey, lines);
+    m_gridDirty = false;
+}
+
+void ViewportOverlay::ensureAxes(Renderer &renderer) {
+    if (!m_axesDirty && renderer.hasColorBuffer(m_axesKey)) return;
+    const float l = m_axesLength;
+    renderer.uploadColorBuffer(m_axesKey, {
+        {0, 0, 0, 1.0f, 0.0f, 0.0f}, {l, 0, 0, 1.0f, 0.0f, 0.0f},
+        {0, 0, 0, 0.0f, 1.0f, 0.0f}, {0, l, 0, 0.0f, 1.0f, 0.0f},
+        {0, 0, 0, 0.0f, 0.0f, 1.0f}, {0, 0, l, 0.0f, 0.0f, 1.0f},
+    });
+    m_axesDirty = false;
+}
+
+void ViewportOverlay::ensureBox(Renderer &renderer) {
+    if (!m_boxDirty && renderer.hasColorBuffer(m_boxKey)) return;
+    const float cr = m_selectionColor.x(), cg = m_selectionColor.y(), cb = m_selectionColor.z();
+    auto v = [&](float x, float y, float z) { return ColorVertex{x, y, z, cr, cg, cb}; };
+    renderer.uploadColorBuffer(m_boxKey, {
+        // bottom rectangle
+        v(0,0,0), v(1,0,0), v(1,0,0), v(1,0,1),
+        v(1,0,1), v(0,0,1), v(0,0,1), v(0,0,0),
+        // top rectangle
+        v(0,1,0), v(1,1,0), v(1,1,0), v(1,1,1),
+        v(1,1,1), v(0,1,1), v(0,1,1), v(0,1,0),
+        // verticals
+        v(0,0,0), v(0,1,0), v(1,0,0), v(1,1,0),
+        v(1,0,1), v(1,1,1), v(0,0,1), v(0,1,1),
+    });
+    m_boxDirty = false;
+}
+
+void ViewportOverlay::drawGrid(Renderer &renderer) {
+    if (m_gridMode == GridMode::Infinite) {
+        renderer.drawInfiniteGrid(m_gridStyle);
+        return;
+    }
+    ensureGrid(renderer);
+    renderer.drawLines(m_gridKey);
+}
+
+void ViewportOverlay::drawAxes(Renderer &renderer) {
+    if (m_axesLength <= 0.0f) return;
+    ensureAxes(renderer);
+    renderer.drawLines(m_axesKey);
+}
+
+void ViewportOverlay::drawBox(Renderer &renderer, const Vertex &min, const Vertex &max, const QMatrix4x4 &world, float width) {
+    ensureBox(renderer);
+    QMatrix4x4 model = world;
+    model.translate(min.x, min.y, min.z);
+    model.scale(max.x - min.x, max.y - min.y, max.z - min.z);
+    renderer.drawLines(m_boxKey, model, width);
+}
@@ -0,0 +1,54 @@
+// src/core/ViewportOverlay.hpp
+#pragma once
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <cstdint>
+#include "Mesh.hpp"
+#include "Renderer.hpp"
+
+// Вспомогательная геометрия вьюпорта: сетка, оси, рамка выделения.
+// Всё лежит в удерживаемых буферах Renderer и перезаливается только при
+// смене параметров; в кадре — по вызову отрисовки на элемент, без сборки
+// вершин на CPU. Рамка — единичный куб, подгоняемый матрицей под AABB.
+// Новые гизмо добавляются так же: геометрия в локальных координатах
+// один раз, положение и размер — через model.
+class ViewportOverlay {
+public:
+    enum class GridMode { Lines, Infinite };
+
+    ViewportOverlay();
+
+    void setGridMode(GridMode mode) { m_gridMode = mode; }
+    GridMode gridMode() const { return m_gridMode; }
+    // Конечная сетка из линий: halfExtent — половина стороны, step — шаг
+    void setGrid(float halfExtent, float step, const QVector3D &color);
+    void setGridStyle(const GridStyle &style) { m_gridStyle = style; }
+    // 0 — без осей
+    void setAxesLength(float length);
+    void setSelectionColor(const QVector3D &color);
+
+    void drawGrid(Renderer &renderer);
+    void drawAxes(Renderer &renderer);
+    // AABB в локальных координатах объекта, world — его мировая матрица
+    void drawBox(Renderer &renderer, const Vertex &min, const Vertex &max, const QMatrix4x4 &world, float width = 2.0f);
+
+private:
+    void ensureGrid(Renderer &renderer);
+    void ensureAxes(Renderer &renderer);
+    void ensureBox(Renderer &renderer);
+
+    GridMode m_gridMode = GridMode::Lines;
+    GridStyle m_gridStyle;
+    float m_gridHalfExtent = 20.0f;
+    float m_gridStep = 1.0f;
+    QVector3D m_gridColor{0.3f, 0.3f, 0.3f};
+    float m_axesLength = 5.0f;
+    QVector3D m_selectionColor{1.0f, 0.9f, 0.2f};
+
+    // Ключи буферов; dirty — параметры поменялись после заливки.
+    // Буферы пропадают вместе с контекстом, поэтому наличие проверяется каждый кадр.
+    uint64_t m_gridKey, m_axesKey, m_boxKey;
+    bool m_gridDirty = true;
+    bool m_axesDirty = true;
+    bool m_boxDirty = true;
+};
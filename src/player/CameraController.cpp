@@ -0,0 +1,101 @@
+// src/player/CameraController.cpp
+#include "CameraController.hpp"
+#include "core/Engine3D.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float kDegToRad = 3.14159265358979323846f / 180.0f;
+constexpr float kMouseDegPerPixel = 0.25f;
+constexpr float kKeyDegPerSecond = 90.0f;
+
+float clampPitch(float pitch) { return std::clamp(pitch, -89.0f, 89.0f); }
+
+// Ось, собранная из пары клавиш: +1, -1 или 0.
+float axis(const InputSnapshot &input, int positive, int negative) {
+    return (input.isDown(positive) ? 1.0f : 0.0f) - (input.isDown(negative) ? 1.0f : 0.0f);
+}
+
+} // namespace
+
+QVector3D CameraState::forward() const {
+    const float y = yaw * kDegToRad, p = pitch * kDegToRad;
+    return QVector3D(-std::sin(y) * std::cos(p), std::sin(p), -std::cos(y) * std::cos(p));
+}
+
+QVector3D CameraState::right() const {
+    const float y = yaw * kDegToRad;
+    return QVector3D(std::cos(y), 0.0f, -std::sin(y));
+}
+
+QMatrix4x4 CameraState::viewMatrix() const {
+    return makeOrbitView(pitch, yaw, -eye.x(), -eye.y(), -eye.z());
+}
+
+CameraState CameraState::lerp(const CameraState &a, const CameraState &b, float t) {
+    CameraState s;
+    s.eye = a.eye + (b.eye - a.eye) * t;
+    s.yaw = a.yaw + (b.yaw - a.yaw) * t;
+    s.pitch = a.pitch + (b.pitch - a.pitch) * t;
+    return s;
+}
+
+// ================= Orbit =================
+void OrbitCameraController::update(const InputSnapshot &input, float dt) {
+    if (input.buttons & Qt::LeftButton) {
+        m_yaw -= float(input.mouseDelta.x()) * kMouseDegPerPixel;
+        m_pitch -= float(input.mouseDelta.y()) * kMouseDegPerPixel;
+    }
+    m_yaw += axis(input, Qt::Key_Left, Qt::Key_Right) * kKeyDegPerSecond * dt;
+    m_pitch += axis(input, Qt::Key_Up, Qt::Key_Down) * kKeyDegPerSecond * dt;
+    m_pitch = clampPitch(m_pitch);
+
+    float zoom = input.wheelSteps + axis(input, Qt::Key_Plus, Qt::Key_Minus) * 4.0f * dt;
+    if (input.isDown(Qt::Key_Equal)) zoom += 4.0f * dt;
+    m_distance = std::clamp(m_distance * std::pow(0.9f, zoom), 0.1f, 10000.0f);
+
+    // Сдвиг цели в плоскости земли, скорость пропорциональна дистанции
+    const CameraState s = state();
+    QVector3D flatForward(s.forward().x(), 0.0f, s.forward().z());
+    if (flatForward.lengthSquared() > 1e-6f) flatForward.normalize();
+    const float pan = m_distance * 0.75f * dt;
+    m_target += flatForward * (axis(input, Qt::Key_W, Qt::Key_S) * pan);
+    m_target += s.right() * (axis(input, Qt::Key_D, Qt::Key_A) * pan);
+}
+
+CameraState OrbitCameraController::state() const {
+    CameraState s;
+    s.yaw = m_yaw;
+    s.pitch = m_pitch;
+    s.eye = m_target - s.forward() * m_distance;
+    return s;
+}
+
+void OrbitCameraController::setState(const CameraState &state) {
+    m_yaw = state.yaw;
+    m_pitch = clampPitch(state.pitch);
+    m_target = state.eye + state.forward() * m_distance;
+}
+
+void OrbitCameraController::frame(const QVector3D &center, float radius, float fovYDeg) {
+    m_target = center;
+    const float halfFov = std::max(fovYDeg * 0.5f * kDegToRad, 0.1f);
+    m_distance = std::max(radius, 0.5f) / std::sin(halfFov) * 1.1f;
+}
+
+// ================= Fly =================
+void FlyCameraController::update(const InputSnapshot &input, float dt) {
+    if (input.buttons & Qt::RightButton) {
+        m_state.yaw -= float(input.mouseDelta.x()) * kMouseDegPerPixel;
+        m_state.pitch -= float(input.mouseDelta.y()) * kMouseDegPerPixel;
+    }
+    m_state.yaw += axis(input, Qt::Key_Left, Qt::Key_Right) * kKeyDegPerSecond * dt;
+    m_state.pitch = clampPitch(m_state.pitch + axis(input, Qt::Key_Up, Qt::Key_Down) * kKeyDegPerSecond * dt);
+
+    m_speed = std::clamp(m_speed * std::pow(1.2f, input.wheelSteps), 0.1f, 1000.0f);
+    const float step = m_speed * (input.isDown(Qt::Key_Shift) ? 4.0f : 1.0f) * dt;
+    m_state.eye += m_state.forward() * (axis(input, Qt::Key_W, Qt::Key_S) * step);
+    m_state.eye += m_state.right() * (axis(input, Qt::Key_D, Qt::Key_A) * step);
+    m_state.eye += QVector3D(0.0f, 1.0f, 0.0f) * (axis(input, Qt::Key_E, Qt::Key_Q) * step);
+}
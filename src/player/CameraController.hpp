@@ -0,0 +1,57 @@
+// src/player/CameraController.hpp
+#pragma once
+#include <QMatrix4x4>
+#include <QVector3D>
+#include "Input.hpp"
+
+// Положение и ориентация камеры. Углы в градусах: yaw — вокруг Y, pitch — вокруг X
+// (положительный — взгляд вверх). Состояния двух тиков интерполируются при отрисовке.
+struct CameraState {
+    QVector3D eye{0.0f, 0.0f, 8.0f};
+    float yaw = 0.0f;
+    float pitch = 0.0f;
+
+    QVector3D forward() const;
+    QVector3D right() const;
+    QMatrix4x4 viewMatrix() const;
+    static CameraState lerp(const CameraState &a, const CameraState &b, float t);
+};
+
+// Контроллер шагает с фиксированным dt в потоке симуляции.
+class CameraController {
+public:
+    virtual ~CameraController() = default;
+    virtual void update(const InputSnapshot &input, float dt) = 0;
+    virtual CameraState state() const = 0;
+    // Перехват камеры у другого контроллера без скачка изображения.
+    virtual void setState(const CameraState &state) = 0;
+};
+
+// Орбита вокруг точки: ЛКМ/стрелки — вращение, колесо/+/- — дистанция, WASD — сдвиг цели.
+class OrbitCameraController : public CameraController {
+public:
+    void update(const InputSnapshot &input, float dt) override;
+    CameraState state() const override;
+    void setState(const CameraState &state) override;
+    // Цель в центр сферы, дистанция — чтобы сфера целиком вошла в кадр.
+    void frame(const QVector3D &center, float radius, float fovYDeg);
+
+private:
+    QVector3D m_target;
+    float m_distance = 8.0f;
+    float m_yaw = 45.0f;
+    float m_pitch = -30.0f;
+};
+
+// Свободный полёт: WASD — движение, Q/E — вниз/вверх, Shift — быстрее, ПКМ/стрелки — обзор.
+class FlyCameraController : public CameraController {
+public:
+    void update(const InputSnapshot &input, float dt) override;
+    CameraState state() const override { return m_state; }
+    void setState(const CameraState &state) override { m_state = state; }
+    void setSpeed(float unitsPerSecond) { m_speed = unitsPerSecond; }
+
+private:
+    CameraState m_state;
+    float m_speed = 5.0f;
+};
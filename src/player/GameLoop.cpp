@@ -0,0 +1,120 @@
+// src/player/GameLoop.cpp
+#include "GameLoop.hpp"
+#include <algorithm>
+
+namespace {
+// Сколько тиков можно прогнать подряд, догоняя отставание; остальное выбрасывается
+constexpr int kMaxCatchUpTicks = 8;
+}
+
+GameLoop::GameLoop(double tickRate)
+    : m_tickRate(tickRate),
+      m_step(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate))) {
+    m_previous = m_current = m_active->state();
+    m_currentTime = Clock::now();
+}
+
+GameLoop::~GameLoop() {
+    stop();
+}
+
+void GameLoop::frameScene(const QVector3D &center, float radius, float fovYDeg) {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_orbit.frame(center, radius, fovYDeg);
+    m_fly.setSpeed(std::max(radius, 1.0f) * 0.5f);
+    m_previous = m_current = m_active->state();
+}
+
+void GameLoop::start() {
+    if (m_running.exchange(true)) return;
+    m_thread = std::thread([this]{ run(); });
+}
+
+void GameLoop::stop() {
+    if (!m_running.exchange(false)) return;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void GameLoop::run() {
+    const float dt = static_cast<float>(1.0 / m_tickRate);
+    Clock::time_point next = Clock::now();
+    while (m_running.load()) {
+        const Clock::time_point now = Clock::now();
+        int steps = 0;
+        while (next <= now && steps < kMaxCatchUpTicks) {
+            tick(dt, next);
+            next += m_step;
+            ++steps;
+        }
+        if (next <= now) {
+            // Слишком далеко отстали — не пытаемся догнать, иначе спираль смерти
+            m_dropped += static_cast<uint64_t>((now - next) / m_step) + 1;
+            next = now + m_step;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void GameLoop::tick(float dt, Clock::time_point t) {
+    const InputSnapshot input = m_input.take();
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    if (input.wasPressed(Qt::Key_C)) {
+        // Переключение орбита <-> полёт с сохранением текущего вида
+        CameraController *other = (m_active == &m_orbit) ? static_cast<CameraController*>(&m_fly) : &m_orbit;
+        other->setState(m_active->state());
+        m_active = other;
+    }
+    m_active->update(input, dt);
+    m_previous = m_current;
+    m_current = m_active->state();
+    m_currentTime = t;
+    ++m_ticks;
+}
+
+CameraState GameLoop::cameraAt(Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    const double alpha = std::chrono::duration<double>(now - m_currentTime).count() * m_tickRate;
+    return CameraState::lerp(m_previous, m_current, static_cast<float>(std::clamp(alpha, 0.0, 1.0)));
+}
+
+QVector3D GameLoop::cameraVelocity() const {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    return (m_current.eye - m_previous.eye) * static_cast<float>(m_tickRate);
+}
+
+// ================= FrameStats =================
+void FrameStats::frameSwapped(GameLoop::Clock::time_point t) {
+    if (m_hasLast) {
+        m_intervals[m_next] = std::chrono::duration<double, std::milli>(t - m_last).count();
+        m_next = (m_next + 1) % m_intervals.size();
+        m_count = std::min(m_count + 1, m_intervals.size());
+    }
+    m_last = t;
+    m_hasLast = true;
+}
+
+FrameStats::Summary FrameStats::summary() const {
+    Summary s;
+    s.frames = m_count;
+    if (m_count == 0) return s;
+    std::vector<double> sorted(m_intervals.begin(), m_intervals.begin() + m_count);
+    double total = 0.0;
+    const double period = 1000.0 / std::max(m_refreshRate, 1.0);
+    for (double ms : sorted) {
+        total += ms;
+        if (ms > period * 1.5) ++s.missed;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    s.avgMs = total / m_count;
+    s.fps = s.avgMs > 0.0 ? 1000.0 / s.avgMs : 0.0;
+    s.p99Ms = sorted[std::min(m_count - 1, m_count * 99 / 100)];
+    s.maxMs = sorted.back();
+    return s;
+}
+
+QString FrameStats::toString() const {
+    const Summary s = summary();
+    return QString("%1 fps | avg %2 ms | p99 %3 ms | max %4 ms | пропущено vsync: %5/%6 @ %7 Гц")
+        .arg(s.fps, 0, 'f', 1).arg(s.avgMs, 0, 'f', 2).arg(s.p99Ms, 0, 'f', 2).arg(s.maxMs, 0, 'f', 2)
+        .arg(s.missed).arg(s.frames).arg(m_refreshRate, 0, 'f', 0);
+}
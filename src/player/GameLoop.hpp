@@ -0,0 +1,91 @@
+// src/player/GameLoop.hpp
+#pragma once
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CameraController.hpp"
+#include "Input.hpp"
+
+// Фиксированный шаг симуляции в отдельном потоке. Отрисовка (vsync, GUI-поток)
+// берёт два последних состояния и интерполирует между ними, поэтому частота
+// кадров и частота тиков независимы, а поведение не зависит от fps.
+class GameLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit GameLoop(double tickRate = 120.0);
+    ~GameLoop();
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running.load(); }
+
+    InputSampler &input() { return m_input; }
+    // Вызывать до start(): начальный кадр орбитальной камеры.
+    void frameScene(const QVector3D &center, float radius, float fovYDeg);
+
+    // Интерполированная камера на момент now (отстаёт от симуляции на один тик).
+    CameraState cameraAt(Clock::time_point now) const;
+    // Скорость камеры за последний тик, ед./с — для упреждающей подгрузки мира.
+    QVector3D cameraVelocity() const;
+
+    double tickRate() const { return m_tickRate; }
+    uint64_t tickCount() const { return m_ticks.load(); }
+    // Тики, выброшенные из-за отставания (поток усыпляли или тик дольше шага).
+    uint64_t droppedTicks() const { return m_dropped.load(); }
+
+private:
+    void run();
+    void tick(float dt, Clock::time_point t);
+
+    const double m_tickRate;
+    const Clock::duration m_step;
+
+    InputSampler m_input;
+    OrbitCameraController m_orbit;
+    FlyCameraController m_fly;
+    CameraController *m_active = &m_orbit;
+
+    mutable std::mutex m_stateMutex;
+    CameraState m_previous;
+    CameraState m_current;
+    Clock::time_point m_currentTime;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_ticks{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
+
+// Статистика темпа кадров по меткам frameSwapped: средний/процентильный
+// интервал, число кадров, пропустивших vsync.
+class FrameStats {
+public:
+    explicit FrameStats(size_t window = 512) : m_intervals(window, 0.0) {}
+
+    void setRefreshRate(double hz) { m_refreshRate = hz; }
+    void frameSwapped(GameLoop::Clock::time_point t);
+
+    struct Summary {
+        double fps = 0.0;
+        double avgMs = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        size_t missed = 0; // интервалов длиннее 1.5 периода обновления экрана
+        size_t frames = 0;
+    };
+    Summary summary() const;
+    QString toString() const;
+
+private:
+    std::vector<double> m_intervals; // кольцевой буфер, мс
+    size_t m_next = 0;
+    size_t m_count = 0;
+    double m_refreshRate = 60.0;
+    GameLoop::Clock::time_point m_last;
+    bool m_hasLast = false;
+};
@@ -0,0 +1,44 @@
+// src/player/Input.cpp
+#include "Input.hpp"
+
+void InputSampler::keyPressed(int key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_state.held.insert(key).second) m_state.pressed.insert(key);
+}
+
+void InputSampler::keyReleased(int key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_state.held.erase(key);
+}
+
+void InputSampler::mouseButtons(Qt::MouseButtons buttons) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_state.buttons = buttons;
+}
+
+void InputSampler::mouseMoved(const QPointF &pos) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_hasMouse) m_state.mouseDelta += pos - m_lastMouse;
+    m_lastMouse = pos;
+    m_hasMouse = true;
+}
+
+void InputSampler::wheel(float steps) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_state.wheelSteps += steps;
+}
+
+void InputSampler::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_state = InputSnapshot();
+    m_hasMouse = false;
+}
+
+InputSnapshot InputSampler::take() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    InputSnapshot out = m_state;
+    m_state.pressed.clear();
+    m_state.mouseDelta = QPointF();
+    m_state.wheelSteps = 0.0f;
+    return out;
+}
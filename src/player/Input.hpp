@@ -0,0 +1,40 @@
+// src/player/Input.hpp
+#pragma once
+#include <QPointF>
+#include <Qt>
+#include <mutex>
+#include <unordered_set>
+
+// Состояние ввода на один тик симуляции: что зажато, что нажато с прошлого тика,
+// накопленные смещение мыши и прокрутка.
+struct InputSnapshot {
+    std::unordered_set<int> held;
+    std::unordered_set<int> pressed;
+    Qt::MouseButtons buttons = Qt::NoButton;
+    QPointF mouseDelta;
+    float wheelSteps = 0.0f;
+
+    bool isDown(int key) const { return held.count(key) != 0; }
+    bool wasPressed(int key) const { return pressed.count(key) != 0; }
+};
+
+// Собирает события ввода в GUI-потоке; поток симуляции забирает их раз в тик.
+class InputSampler {
+public:
+    void keyPressed(int key);
+    void keyReleased(int key);
+    void mouseButtons(Qt::MouseButtons buttons);
+    void mouseMoved(const QPointF &pos);
+    void wheel(float steps);
+    // Сбрасывает зажатые клавиши (окно потеряло фокус — release уже не придёт).
+    void clear();
+
+    // Забирает накопленное: pressed, смещение мыши и прокрутка обнуляются.
+    InputSnapshot take();
+
+private:
+    mutable std::mutex m_mutex;
+    InputSnapshot m_state;
+    QPointF m_lastMouse;
+    bool m_hasMouse = false;
+};
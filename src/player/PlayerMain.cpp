@@ -1,4 +1,5 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
 #include <QFile>
@@ -7,109 +8,63 @@
 #include <QJsonArray>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QScreen>
+#include <QDebug>
 #include <vector>
 #include <string>
 #include <cmath>
-
-struct Vertex { float x, y, z; };
-struct Face { std::vector<int> indices; };
-
-class RuntimeObject {
-public:
-    std::string name;
-    float x=0,y=0,z=0, rx=0,ry=0,rz=0, sx=1,sy=1,sz=1;
-    float r=0.75f,g=0.8f,b=1.0f;
-    std::vector<Vertex> vertices; std::vector<Face> faces;
-    void draw() const {
-        glPushMatrix();
-        glTranslatef(x,y,z);
-        glRotatef(rx,1,0,0); glRotatef(ry,0,1,0); glRotatef(rz,0,0,1);
-        glScalef(sx,sy,sz);
-        glDisable(GL_COLOR_MATERIAL);
-        glEnable(GL_LIGHTING);
-        glEnable(GL_NORMALIZE);
-        glColor3f(r,g,b);
-        glBegin(GL_TRIANGLES);
-        for (const auto &f : faces) {
-            if (f.indices.size() < 3) continue;
-            for (size_t i=1;i+1<f.indices.size();++i) {
-                int v0=f.indices[0], v1=f.indices[i], v2=f.indices[i+1];
-                float ax = vertices[v1].x - vertices[v0].x;
-                float ay = vertices[v1].y - vertices[v0].y;
-                float az = vertices[v1].z - vertices[v0].z;
-                float bx = vertices[v2].x - vertices[v0].x;
-                float by = vertices[v2].y - vertices[v0].y;
-                float bz = vertices[v2].z - vertices[v0].z;
-                float nx = ay*bz - az*by;
-                float ny = az*bx - ax*bz;
-                float nz = ax*by - ay*bx;
-                float len = std::sqrt(nx*nx+ny*ny+nz*nz);
-                if (len>1e-6f){ nx/=len; ny/=len; nz/=len; }
-                glNormal3f(nx,ny,nz);
-                glVertex3f(vertices[v0].x, vertices[v0].y, vertices[v0].z);
-                glVertex3f(vertices[v1].x, vertices[v1].y, vertices[v1].z);
-                glVertex3f(vertices[v2].x, vertices[v2].y, vertices[v2].z);
-            }
-        }
-        glEnd();
-        glPopMatrix();
-    }
-};
-
-static void loadObjText(const QString &objText, std::vector<Vertex> &verts, std::vector<Face> &faces) {
-    verts.clear(); faces.clear();
-    const auto lines = objText.split('\n');
-    for (const auto &line : lines) {
-        auto trimmed = line.trimmed();
-        if (trimmed.isEmpty()) continue;
-        auto parts = trimmed.split(' ', Qt::SkipEmptyParts);
-        if (parts.isEmpty()) continue;
-        if (parts[0] == "v" && parts.size() >= 4) {
-            verts.push_back({parts[1].toFloat(), parts[2].toFloat(), parts[3].toFloat()});
-        } else if (parts[0] == "f" && parts.size() >= 4) {
-            Face f; f.indices.reserve(parts.size()-1);
-            for (int i=1;i<parts.size();++i) {
-                auto token = parts[i].split('/')[0];
-                bool ok=false; int idx = token.toInt(&ok); if (!ok) continue;
-                idx -= 1; if (idx>=0 && idx < (int)verts.size()) f.indices.push_back(idx);
-            }
-            if (f.indices.size()>=3) faces.push_back(std::move(f));
-        }
-    }
-}
+#include "core/Engine3D.hpp"
+#include "core/Renderer.hpp"
+#include "core/Scene.hpp"
+#include "core/SceneBaker.hpp"
+#include "core/SceneBinary.hpp"
+#include "GameLoop.hpp"
+#include "WorldStreamer.hpp"
 
 class RuntimeView : public QOpenGLWidget, protected QOpenGLFunctions {
     Q_OBJECT
 public:
-    explicit RuntimeView(QWidget *parent=nullptr) : QOpenGLWidget(parent) {
+    explicit RuntimeView(const StreamingOptions &streaming = {}, QWidget *parent=nullptr)
+        : QOpenGLWidget(parent), m_streamer(streaming) {
         setFocusPolicy(Qt::StrongFocus);
+        setMouseTracking(true);
+        // Непрерывная отрисовка: следующий кадр заказывается сразу после swap, темп задаёт vsync
+        connect(this, &QOpenGLWidget::frameSwapped, this, [this]{
+            m_frameStats.frameSwapped(GameLoop::Clock::now());
+            update();
+        });
     }
+    ~RuntimeView() override { m_loop.stop(); }
+
     void loadSceneFile(const QString &path) {
         QFile f(path);
         if (!f.open(QIODevice::ReadOnly)) {
             QMessageBox::critical(this, "Error", "Cannot open scene file");
             return;
         }
-        auto doc = QJsonDocument::fromJson(f.readAll()); f.close();
-        if (!doc.isObject()) return;
-        m_objects.clear();
-        auto arr = doc.object().value("objects").toArray();
-        for (const auto &it : arr) {
-            auto jo = it.toObject();
-            RuntimeObject o; o.name = jo.value("name").toString("Object").toStdString();
-            auto tr = jo.value("transform").toObject();
-            auto pos = tr.value("pos").toArray();
-            auto rot = tr.value("rot").toArray();
-            auto scl = tr.value("scl").toArray();
-            if (pos.size()==3){ o.x=pos[0].toDouble(); o.y=pos[1].toDouble(); o.z=pos[2].toDouble(); }
-            if (rot.size()==3){ o.rx=rot[0].toDouble(); o.ry=rot[1].toDouble(); o.rz=rot[2].toDouble(); }
-            if (scl.size()==3){ o.sx=scl[0].toDouble(); o.sy=scl[1].toDouble(); o.sz=scl[2].toDouble(); }
-            auto color = jo.value("color").toArray();
-            if (color.size()==3){ o.r=color[0].toDouble(); o.g=color[1].toDouble(); o.b=color[2].toDouble(); }
-            auto mesh = jo.value("mesh_obj").toString();
-            loadObjText(mesh, o.vertices, o.faces);
-            m_objects.push_back(std::move(o));
+        if (SceneBinary::isBinary(f.peek(4))) {
+            // .scbin: статическая геометрия подгружается по ячейкам вокруг камеры
+            f.close();
+            m_scene = BakedScene();
+            if (!m_streamer.open(path, m_scene.dynamicObjects)) QMessageBox::critical(this, "Error", "Corrupted scene file");
+        } else {
+            const QByteArray data = f.readAll(); f.close();
+            // Старые .scene: запекаем при загрузке
+            auto doc = QJsonDocument::fromJson(data);
+            if (!doc.isObject()) return;
+            // Базы ассетов у Player нет: объекты-ссылки берут встроенную копию меша
+            std::vector<std::string> unresolved;
+            m_scene = bakeScene(sceneFromJson(doc.object(), {}, &unresolved));
+            if (!unresolved.empty()) qWarning() << "Scene objects without mesh (asset not embedded):" << unresolved.size();
         }
+        for (auto &batch : m_scene.batches) batch.meshKey = Renderer::newMeshKey();
+        frameScene();
+        m_loop.start();
         update();
     }
 protected:
@@ -117,35 +72,138 @@ protected:
         initializeOpenGLFunctions();
         glClearColor(0.1f, 0.12f, 0.16f, 1.0f);
         glEnable(GL_DEPTH_TEST);
-        glEnable(GL_LIGHTING);
-        glEnable(GL_LIGHT0);
-        glEnable(GL_COLOR_MATERIAL);
-        glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+        m_renderer.initialize();
+        connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, [this]{ makeCurrent(); m_renderer.cleanup(); doneCurrent(); });
+        m_renderer.setLights({{QVector3D(5.0f, 10.0f, 5.0f)}});
+        if (QScreen *s = screen()) m_frameStats.setRefreshRate(s->refreshRate());
+        m_statsTimer.start();
     }
     void resizeGL(int w, int h) override { glViewport(0,0,w,h); }
     void paintGL() override {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glMatrixMode(GL_PROJECTION);
-        glLoadIdentity();
         float aspect = float(std::max(1,width()))/std::max(1,height());
-        float zNear=0.1f, zFar=1000.0f; float fov=60.0f; float f = 1.0f/std::tan((fov*M_PI/180.0f)/2.0f);
-        float top = zNear / f; float right = top * aspect; glFrustum(-right, right, -top, top, zNear, zFar);
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
-        glRotatef(-30.0f,1,0,0); glRotatef(-45.0f,0,1,0); glTranslatef(0,0,-8.0f);
-        for (const auto &o : m_objects) o.draw();
+        const CameraState camera = m_loop.cameraAt(GameLoop::Clock::now());
+        const QMatrix4x4 view = camera.viewMatrix();
+        const QMatrix4x4 proj = makePerspective(kFovY, aspect, 0.1f, 1000.0f);
+        const QMatrix4x4 viewProj = proj * view;
+        m_renderer.beginFrame(view, proj);
+        if (m_streamer.isOpen()) {
+            m_streamer.update(camera.eye, m_loop.cameraVelocity());
+            m_streamer.forEachVisible(viewProj, [this](const BakedBatch &batch, uint64_t meshKey) {
+                if (!m_renderer.hasMesh(meshKey)) {
+                    m_renderer.uploadMesh(meshKey, &batch.vertices[0].x, batch.vertices.size() * 3, batch.indices.data(), batch.indices.size());
+                }
+                m_renderer.submit(meshKey, QMatrix4x4(), {RenderProgram::Lit, batch.color});
+            });
+        }
+        for (const auto &batch : m_scene.batches) {
+            const QVector3D bmin(batch.boundsMin.x, batch.boundsMin.y, batch.boundsMin.z);
+            const QVector3D bmax(batch.boundsMax.x, batch.boundsMax.y, batch.boundsMax.z);
+            if (batch.vertices.empty() || !aabbInFrustum(viewProj, bmin, bmax)) continue;
+            if (!m_renderer.hasMesh(batch.meshKey)) {
+                m_renderer.uploadMesh(batch.meshKey, &batch.vertices[0].x, batch.vertices.size() * 3, batch.indices.data(), batch.indices.size());
+            }
+            m_renderer.submit(batch.meshKey, QMatrix4x4(), {RenderProgram::Lit, batch.color});
+        }
+        for (const auto &o : m_scene.dynamicObjects) o->draw(m_renderer);
+        m_renderer.flush();
+
+        // Статистика темпа кадров — в заголовок раз в секунду, чтобы не мешать самому темпу
+        if (m_statsTimer.elapsed() >= 1000) {
+            m_statsTimer.restart();
+            window()->setWindowTitle(QString("SimpleCASCADE Player — %1 | тиков: %2 (%3 Гц), выброшено: %4")
+                .arg(m_frameStats.toString()).arg(m_loop.tickCount()).arg(m_loop.tickRate(), 0, 'f', 0)
+                .arg(m_loop.droppedTicks())
+                + (m_streamer.isOpen() ? " | " + m_streamer.metricsString() : QString()));
+        }
+    }
+
+    void keyPressEvent(QKeyEvent *e) override {
+        if (e->key() == Qt::Key_Escape) { window()->close(); return; }
+        if (!e->isAutoRepeat()) m_loop.input().keyPressed(e->key());
+    }
+    void keyReleaseEvent(QKeyEvent *e) override {
+        if (!e->isAutoRepeat()) m_loop.input().keyReleased(e->key());
+    }
+    void mousePressEvent(QMouseEvent *e) override {
+        m_loop.input().mouseMoved(e->position());
+        m_loop.input().mouseButtons(e->buttons());
     }
+    void mouseReleaseEvent(QMouseEvent *e) override { m_loop.input().mouseButtons(e->buttons()); }
+    void mouseMoveEvent(QMouseEvent *e) override { m_loop.input().mouseMoved(e->position()); }
+    void wheelEvent(QWheelEvent *e) override { m_loop.input().wheel(e->angleDelta().y() / 120.0f); }
+    void focusOutEvent(QFocusEvent *e) override {
+        m_loop.input().clear();
+        QOpenGLWidget::focusOutEvent(e);
+    }
+
 private:
-    std::vector<RuntimeObject> m_objects;
+    static constexpr float kFovY = 60.0f;
+
+    // Начальная орбита — вокруг ограничивающей сферы всей сцены
+    void frameScene() {
+        bool any = false;
+        QVector3D lo, hi;
+        auto grow = [&](const QVector3D &p) {
+            if (!any) { lo = hi = p; any = true; return; }
+            lo = QVector3D(std::min(lo.x(), p.x()), std::min(lo.y(), p.y()), std::min(lo.z(), p.z()));
+            hi = QVector3D(std::max(hi.x(), p.x()), std::max(hi.y(), p.y()), std::max(hi.z(), p.z()));
+        };
+        for (const auto &batch : m_scene.batches) {
+            if (batch.vertices.empty()) continue;
+            grow(QVector3D(batch.boundsMin.x, batch.boundsMin.y, batch.boundsMin.z));
+            grow(QVector3D(batch.boundsMax.x, batch.boundsMax.y, batch.boundsMax.z));
+        }
+        QVector3D streamedLo, streamedHi;
+        if (m_streamer.worldBounds(streamedLo, streamedHi)) { grow(streamedLo); grow(streamedHi); }
+        for (const auto &o : m_scene.dynamicObjects) {
+            Vertex mn, mx;
+            o->getAABB(mn, mx);
+            const QMatrix4x4 m = o->modelMatrix();
+            grow(m.map(QVector3D(mn.x, mn.y, mn.z)));
+            grow(m.map(QVector3D(mx.x, mx.y, mx.z)));
+        }
+        if (any) m_loop.frameScene((lo + hi) * 0.5f, (hi - lo).length() * 0.5f, kFovY);
+    }
+
+    Renderer m_renderer;
+    BakedScene m_scene;
+    WorldStreamer m_streamer;
+    GameLoop m_loop;
+    FrameStats m_frameStats;
+    QElapsedTimer m_statsTimer;
 };
 
 int main(int argc, char **argv) {
+    configureDefaultSurfaceFormat();
     QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("scene", "Файл сцены (.scbin или .scene)");
+    const QCommandLineOption budgetOption("stream-budget", "Бюджет потоковой геометрии в RAM, МБ", "mb");
+    const QCommandLineOption radiusOption("stream-radius", "Радиус подгрузки ячеек вокруг камеры", "units");
+    const QCommandLineOption prefetchOption("stream-prefetch", "Упреждение подгрузки по скорости камеры, с", "seconds");
+    parser.addOptions({budgetOption, radiusOption, prefetchOption});
+    parser.process(app);
+
+    StreamingOptions streaming;
+    if (parser.isSet(budgetOption)) streaming.memoryBudget = size_t(std::max(1, parser.value(budgetOption).toInt())) << 20;
+    if (parser.isSet(radiusOption)) streaming.loadRadius = std::max(1.0f, parser.value(radiusOption).toFloat());
+    if (parser.isSet(prefetchOption)) streaming.prefetchSeconds = std::max(0.0f, parser.value(prefetchOption).toFloat());
+
     QString scenePath;
-    if (argc >= 2) scenePath = QString::fromLocal8Bit(argv[1]);
+    if (!parser.positionalArguments().isEmpty()) scenePath = parser.positionalArguments().first();
+    if (scenePath.isEmpty()) {
+        // Экспортированная игра: сцена лежит рядом с бинарём
+        QDir appDir(QCoreApplication::applicationDirPath());
+        for (const char *name : {"game.scbin", "game.scene"}) {
+            if (QFile::exists(appDir.filePath(name))) { scenePath = appDir.filePath(name); break; }
+        }
+    }
     if (scenePath.isEmpty()) scenePath = QFileDialog::getOpenFileName(nullptr, "Open Scene", QString(), "SimpleCASCADE Scene (*.scene)");
     if (scenePath.isEmpty()) return 0;
-    RuntimeView view; view.resize(1024, 768); view.show();
+    RuntimeView view(streaming); view.resize(1024, 768); view.show();
     view.loadSceneFile(scenePath);
     return app.exec();
 }
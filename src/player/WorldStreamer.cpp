@@ -0,0 +1,212 @@
+// src/player/WorldStreamer.cpp
+#include "WorldStreamer.hpp"
+#include <QFile>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include "core/Renderer.hpp"
+
+WorldStreamer::WorldStreamer(const StreamingOptions &options) : m_options(options) {}
+
+WorldStreamer::~WorldStreamer() {
+    close();
+}
+
+bool WorldStreamer::open(const QString &path, SceneObjectList &dynamicObjects) {
+    close();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    if (!SceneBinary::readIndex(file, m_records, dynamicObjects)) {
+        m_records.clear();
+        return false;
+    }
+    m_path = path;
+
+    // Батчи одного кластера запекателя попадают в одну ячейку по центру границ
+    const float size = std::max(m_options.cellSize, 1e-3f);
+    std::map<std::tuple<int, int, int>, uint32_t> cellOf;
+    m_meshKeys.resize(m_records.size());
+    for (uint32_t i = 0; i < m_records.size(); ++i) {
+        const auto &r = m_records[i];
+        m_meshKeys[i] = Renderer::newMeshKey();
+        if (r.vertexCount == 0) continue;
+        const QVector3D lo(r.boundsMin.x, r.boundsMin.y, r.boundsMin.z);
+        const QVector3D hi(r.boundsMax.x, r.boundsMax.y, r.boundsMax.z);
+        const QVector3D c = (lo + hi) * 0.5f / size;
+        const auto key = std::make_tuple(int(std::floor(c.x())), int(std::floor(c.y())), int(std::floor(c.z())));
+        auto it = cellOf.find(key);
+        if (it == cellOf.end()) {
+            it = cellOf.emplace(key, static_cast<uint32_t>(m_cells.size())).first;
+            m_cells.emplace_back();
+            m_cells.back().boundsMin = lo;
+            m_cells.back().boundsMax = hi;
+        }
+        Cell &cell = m_cells[it->second];
+        cell.boundsMin = QVector3D(std::min(cell.boundsMin.x(), lo.x()), std::min(cell.boundsMin.y(), lo.y()), std::min(cell.boundsMin.z(), lo.z()));
+        cell.boundsMax = QVector3D(std::max(cell.boundsMax.x(), hi.x()), std::max(cell.boundsMax.y(), hi.y()), std::max(cell.boundsMax.z(), hi.z()));
+        cell.records.push_back(i);
+        cell.bytes += r.bytes();
+    }
+    m_metrics = Metrics();
+    m_metrics.cellCount = m_cells.size();
+    m_needed.assign(m_cells.size(), 0);
+    m_inFlight.assign(m_cells.size(), 0);
+
+    m_stopping = false;
+    for (int i = 0; i < std::max(1, m_options.workerThreads); ++i) m_workers.emplace_back([this]{ workerLoop(); });
+    return true;
+}
+
+void WorldStreamer::close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    for (auto &t : m_workers) t.join();
+    m_workers.clear();
+    m_loaded.clear();
+    m_inFlight.clear();
+    m_needed.clear();
+    m_cells.clear();
+    m_records.clear();
+    m_meshKeys.clear();
+    m_metrics = Metrics();
+}
+
+bool WorldStreamer::worldBounds(QVector3D &lo, QVector3D &hi) const {
+    if (m_cells.empty()) return false;
+    lo = m_cells[0].boundsMin;
+    hi = m_cells[0].boundsMax;
+    for (const Cell &c : m_cells) {
+        lo = QVector3D(std::min(lo.x(), c.boundsMin.x()), std::min(lo.y(), c.boundsMin.y()), std::min(lo.z(), c.boundsMin.z()));
+        hi = QVector3D(std::max(hi.x(), c.boundsMax.x()), std::max(hi.y(), c.boundsMax.y()), std::max(hi.z(), c.boundsMax.z()));
+    }
+    return true;
+}
+
+float WorldStreamer::distanceTo(const Cell &cell, const QVector3D &p) const {
+    const float dx = std::max({cell.boundsMin.x() - p.x(), 0.0f, p.x() - cell.boundsMax.x()});
+    const float dy = std::max({cell.boundsMin.y() - p.y(), 0.0f, p.y() - cell.boundsMax.y()});
+    const float dz = std::max({cell.boundsMin.z() - p.z(), 0.0f, p.z() - cell.boundsMax.z()});
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void WorldStreamer::workerLoop() {
+    // Свой QFile на поток: позиция чтения у каждого своя
+    QFile file(m_path);
+    const bool opened = file.open(QIODevice::ReadOnly);
+    while (true) {
+        uint32_t id = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]{ return m_stopping || !m_queue.empty(); });
+            if (m_stopping) return;
+            id = m_queue.front();
+            m_queue.pop_front();
+        }
+        // records неизменны после open(), читать их можно без блокировки
+        Loaded loaded{id, opened, {}};
+        const Cell &cell = m_cells[id];
+        loaded.batches.resize(cell.records.size());
+        for (size_t i = 0; i < cell.records.size() && loaded.ok; ++i) {
+            loaded.ok = SceneBinary::readBatch(file, m_records[cell.records[i]], loaded.batches[i]);
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loaded.push_back(std::move(loaded));
+    }
+}
+
+void WorldStreamer::acceptLoaded() {
+    std::vector<Loaded> loaded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        loaded.swap(m_loaded);
+        for (const Loaded &l : loaded) m_inFlight[l.cell] = 0;
+    }
+    for (Loaded &l : loaded) {
+        Cell &cell = m_cells[l.cell];
+        if (!l.ok) { cell.failed = true; continue; }
+        // Пока читали, камера могла уйти, а бюджет — заполниться: тогда ячейка не нужна
+        if (!m_needed[l.cell] && m_metrics.residentBytes + cell.bytes > m_options.memoryBudget) continue;
+        cell.batches = std::move(l.batches);
+        cell.resident = true;
+        m_metrics.residentBytes += cell.bytes;
+        ++m_metrics.residentCells;
+    }
+}
+
+void WorldStreamer::evict(size_t incomingBytes) {
+    if (m_metrics.residentBytes + incomingBytes <= m_options.memoryBudget) return;
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = 0; i < m_cells.size(); ++i) {
+        if (m_cells[i].resident && !m_needed[i]) candidates.push_back(i);
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b){ return m_cells[a].priority > m_cells[b].priority; });
+    for (uint32_t i : candidates) {
+        if (m_metrics.residentBytes + incomingBytes <= m_options.memoryBudget) break;
+        Cell &cell = m_cells[i];
+        // GPU-копию освободит сам Renderer, когда меш перестанет рисоваться
+        std::vector<BakedBatch>().swap(cell.batches);
+        cell.resident = false;
+        m_metrics.residentBytes -= cell.bytes;
+        --m_metrics.residentCells;
+    }
+}
+
+void WorldStreamer::update(const QVector3D &eye, const QVector3D &velocity) {
+    if (m_cells.empty()) return;
+    m_eye = eye;
+    acceptLoaded();
+
+    // Сначала всё в радиусе от камеры, потом — в радиусе от упреждённой точки
+    const float radius = m_options.loadRadius;
+    const QVector3D ahead = eye + velocity * m_options.prefetchSeconds;
+    std::vector<uint32_t> wanted;
+    for (uint32_t i = 0; i < m_cells.size(); ++i) {
+        Cell &cell = m_cells[i];
+        const float now = distanceTo(cell, eye);
+        const float later = distanceTo(cell, ahead);
+        cell.priority = now <= radius ? now : (later <= radius ? radius + later : 2.0f * radius + now);
+        if (cell.priority <= 2.0f * radius && !cell.failed) wanted.push_back(i);
+    }
+    std::sort(wanted.begin(), wanted.end(), [this](uint32_t a, uint32_t b){ return m_cells[a].priority < m_cells[b].priority; });
+
+    // Нужные — сколько влезает в бюджет, по убыванию нужности
+    std::fill(m_needed.begin(), m_needed.end(), 0);
+    size_t neededBytes = 0, incomingBytes = 0;
+    size_t fitted = 0;
+    for (; fitted < wanted.size(); ++fitted) {
+        const Cell &cell = m_cells[wanted[fitted]];
+        if (neededBytes + cell.bytes > m_options.memoryBudget) break;
+        neededBytes += cell.bytes;
+        if (!cell.resident) incomingBytes += cell.bytes;
+        m_needed[wanted[fitted]] = 1;
+    }
+    evict(incomingBytes);
+
+    // Очередь пересобирается целиком: незапущенные заказы, ставшие ненужными, снимаются
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (uint32_t id : m_queue) m_inFlight[id] = 0;
+        m_queue.clear();
+        for (size_t n = 0; n < fitted; ++n) {
+            const uint32_t id = wanted[n];
+            if (m_cells[id].resident || m_inFlight[id]) continue;
+            m_inFlight[id] = 1;
+            m_queue.push_back(id);
+        }
+        m_metrics.inFlightCells = static_cast<size_t>(std::count(m_inFlight.begin(), m_inFlight.end(), uint8_t(1)));
+    }
+    m_wake.notify_all();
+}
+
+QString WorldStreamer::metricsString() const {
+    const Metrics &m = m_metrics;
+    return QString("стриминг: %1/%2 МБ, ячеек %3/%4, в загрузке %5, простоев: %6 за кадр (кадров с простоем: %7)")
+        .arg(m.residentBytes / double(1 << 20), 0, 'f', 1).arg(m_options.memoryBudget / double(1 << 20), 0, 'f', 0)
+        .arg(m.residentCells).arg(m.cellCount).arg(m.inFlightCells)
+        .arg(m.frameStalls).arg(m.stalledFrames);
+}
@@ -0,0 +1,116 @@
+// src/player/WorldStreamer.hpp
+#pragma once
+#include <QMatrix4x4>
+#include <QString>
+#include <QVector3D>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/Engine3D.hpp"
+#include "core/SceneBinary.hpp"
+
+struct StreamingOptions {
+    float cellSize = 32.0f;              // как BakeOptions::clusterSize: ячейка = батчи одного кластера
+    float loadRadius = 128.0f;           // ячейки ближе — нужны сейчас
+    size_t memoryBudget = 512u << 20;    // байт геометрии в RAM
+    float prefetchSeconds = 2.0f;        // упреждение по скорости камеры
+    int workerThreads = 2;
+};
+
+// Потоковая загрузка статической геометрии .scbin по пространственным ячейкам.
+//
+// open() читает только оглавление батчей и группирует их в ячейки по сетке
+// cellSize. update() раз в кадр (GUI-поток) принимает загруженные ячейки,
+// ставит в очередь нужные — в радиусе от камеры, затем в радиусе от точки, куда
+// камера придёт через prefetchSeconds, — и вытесняет дальние, пока резидентная
+// геометрия не уложится в бюджет. Чтение файла — в рабочих потоках, у каждого
+// свой QFile; состояние ячеек меняет только GUI-поток.
+//
+// Простой — ячейка в радиусе и в кадре, которая к отрисовке ещё не загружена.
+class WorldStreamer {
+public:
+    struct Metrics {
+        size_t residentBytes = 0;
+        size_t residentCells = 0;
+        size_t cellCount = 0;
+        size_t inFlightCells = 0;      // в очереди и в чтении
+        int frameStalls = 0;           // за последний кадр
+        uint64_t stalledFrames = 0;    // кадров хотя бы с одним простоем
+        uint64_t totalStalls = 0;
+    };
+
+    explicit WorldStreamer(const StreamingOptions &options = {});
+    ~WorldStreamer();
+
+    bool open(const QString &path, SceneObjectList &dynamicObjects);
+    void close();
+    bool isOpen() const { return !m_cells.empty(); }
+    // Границы всей статической геометрии (по оглавлению)
+    bool worldBounds(QVector3D &lo, QVector3D &hi) const;
+
+    void update(const QVector3D &eye, const QVector3D &velocity);
+    // Резидентные батчи, видимые из viewProjection; заодно считает простои кадра
+    template <class Fn> void forEachVisible(const QMatrix4x4 &viewProjection, Fn fn);
+
+    const Metrics &metrics() const { return m_metrics; }
+    QString metricsString() const;
+
+private:
+    struct Cell {
+        QVector3D boundsMin, boundsMax;
+        std::vector<uint32_t> records;     // индексы в m_records
+        std::vector<BakedBatch> batches;   // геометрия, пока ячейка резидентна
+        size_t bytes = 0;
+        bool resident = false;
+        bool failed = false;               // файл повреждён — больше не запрашивать
+        float priority = 0.0f;             // меньше — нужнее; обновляется в update()
+    };
+    struct Loaded {
+        uint32_t cell;
+        bool ok;
+        std::vector<BakedBatch> batches;
+    };
+
+    void workerLoop();
+    void acceptLoaded();
+    // Вытесняет резидентные ячейки вне m_needed, начиная с дальних, пока incomingBytes не влезут в бюджет
+    void evict(size_t incomingBytes);
+    float distanceTo(const Cell &cell, const QVector3D &p) const;
+
+    StreamingOptions m_options;
+    QString m_path;
+    std::vector<SceneBinary::BatchRecord> m_records;
+    std::vector<uint64_t> m_meshKeys;      // по батчу, постоянны: повторная загрузка застаёт меш на GPU
+    std::vector<Cell> m_cells;
+    std::vector<uint8_t> m_needed;         // по ячейке: входит в бюджет этого кадра
+    QVector3D m_eye;
+    Metrics m_metrics;
+
+    // Общее с рабочими потоками — под m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<uint32_t> m_queue;          // по убыванию нужности; пересобирается каждый кадр
+    std::vector<uint8_t> m_inFlight;       // по ячейке: в очереди или читается
+    std::vector<Loaded> m_loaded;
+    bool m_stopping = false;
+    std::vector<std::thread> m_workers;
+};
+
+template <class Fn>
+void WorldStreamer::forEachVisible(const QMatrix4x4 &viewProjection, Fn fn) {
+    int stalls = 0;
+    for (const Cell &cell : m_cells) {
+        if (!aabbInFrustum(viewProjection, cell.boundsMin, cell.boundsMax)) continue;
+        if (cell.resident) {
+            for (size_t i = 0; i < cell.batches.size(); ++i) fn(cell.batches[i], m_meshKeys[cell.records[i]]);
+        } else if (!cell.failed && distanceTo(cell, m_eye) <= m_options.loadRadius) {
+            ++stalls;
+        }
+    }
+    m_metrics.frameStalls = stalls;
+    if (stalls > 0) ++m_metrics.stalledFrames;
+    m_metrics.totalStalls += static_cast<uint64_t>(stalls);
+}
@@ -2,30 +2,162 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QFileInfo>
+#include <QProcessEnvironment>
 
 AICompletion::AICompletion(QObject *parent) : QObject(parent) {}
 
-void AICompletion::request(const QString &content, int cursorOffset, const QString &language, const QString &filePath) {
-    if (m_proc) { m_proc->deleteLater(); m_proc=nullptr; }
-    m_proc = new QProcess(this);
-    connect(m_proc, &QProcess::finished, this, &AICompletion::onFinished);
-    connect(m_proc, &QProcess::readyReadStandardOutput, this, &AICompletion::onReadyStdout);
-    QJsonObject body{{"content", content}, {"cursor", cursorOffset}, {"language", language}, {"path", filePath}};
-    QJsonDocument doc(body);
-    QString prog = "python3";
-    QString script = QString::fromStdString(std::string(PYTHON_DIR) + "/ide_agent.py");
-    m_proc->start(prog, {script});
-    m_proc->write(doc.toJson(QJsonDocument::Compact));
+AICompletion::~AICompletion() {
+    if (!m_proc) return;
+    // Воркер завершается сам по EOF на stdin
+    m_proc->disconnect(this);
     m_proc->closeWriteChannel();
+    if (!m_proc->waitForFinished(500)) m_proc->kill();
+}
+
+void AICompletion::ensureWorker() {
+    if (m_proc && m_proc->state() != QProcess::NotRunning) return;
+    if (!m_proc) {
+        m_proc = new QProcess(this);
+        connect(m_proc, &QProcess::finished, this, &AICompletion::onFinished);
+        connect(m_proc, &QProcess::readyReadStandardOutput, this, &AICompletion::onReadyStdout);
+        connect(m_proc, &QProcess::errorOccurred, this, [this](QProcess::ProcessError err){
+            if (err == QProcess::FailedToStart) emit failed("не удалось запустить воркер автодополнения");
+        });
+        m_proc->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    }
+    m_buf.clear();
+    QStringList args{QString::fromStdString(std::string(PYTHON_DIR) + "/ide_agent.py"), "--serve"};
+    // Заглушка вместо сети — для проверки протокола и UI без API-ключа
+    if (QProcessEnvironment::systemEnvironment().contains("SIMPLECASCADE_COMPLETION_STUB")) args << "--stub";
+    m_proc->start("python3", args);
+}
+
+void AICompletion::warmUp() {
+    // Только первый запуск: упавший воркер перезапустит следующий request()
+    if (!m_proc) ensureWorker();
+}
+
+void AICompletion::send(const QJsonObject &message) {
+    QByteArray line = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    m_proc->write(line);
+}
+
+QString AICompletion::Stats::summary() const {
+    return QString("запросов: %1, из кэша: %2 (%3%), по префиксу: %4, задержка: %5 мс (средняя %6 мс)")
+        .arg(requests).arg(cacheHits).arg(hitRate() * 100.0, 0, 'f', 1).arg(prefixHits)
+        .arg(lastLatencyMs, 0, 'f', 0).arg(avgLatencyMs, 0, 'f', 0);
+}
+
+size_t AICompletion::contextKey(QStringView before, QStringView after, const QString &language, const QString &filePath) {
+    return qHashMulti(0, before, after, language, filePath);
+}
+
+void AICompletion::request(const QString &content, int cursorOffset, const QString &language, const QString &filePath) {
+    cancel();
+    m_suggestion.clear();
+    m_consumed.clear();
+    ++m_stats.requests;
+
+    // Окно вокруг курсора, по границам строк — чтобы не резать токен пополам
+    const int cursor = qBound(0, cursorOffset, int(content.size()));
+    int from = qMax(0, cursor - WindowBefore);
+    if (from > 0) { const int nl = content.indexOf('\n', from); if (nl >= 0 && nl < cursor) from = nl + 1; }
+    int to = qMin(int(content.size()), cursor + WindowAfter);
+    if (to < content.size()) { const int nl = content.lastIndexOf('\n', to); if (nl > cursor) to = nl; }
+    m_before = content.mid(from, cursor - from);
+    m_after = content.mid(cursor, to - cursor);
+    m_language = language;
+    m_path = filePath;
+
+    m_activeKey = contextKey(m_before, m_after, language, filePath);
+    if (const QString *cached = m_cache.object(m_activeKey)) {
+        ++m_stats.cacheHits;
+        m_suggestion = *cached;
+        emit suggestionReady(m_suggestion);
+        return;
+    }
+
+    ensureWorker();
+    m_activeId = m_nextId++;
+    m_latency.start();
+    send(QJsonObject{{"type", "complete"}, {"id", double(m_activeId)}, {"content", m_before + m_after},
+                     {"cursor", int(m_before.size())}, {"language", language}, {"path", filePath}});
+}
+
+void AICompletion::cancel() {
+    m_suggestion.clear();
+    m_consumed.clear();
+    if (!m_activeId) return;
+    if (m_proc && m_proc->state() != QProcess::NotRunning) send(QJsonObject{{"type", "cancel"}, {"id", double(m_activeId)}});
+    m_activeId = 0;
+}
+
+bool AICompletion::advance(const QString &typed) {
+    if (typed.isEmpty() || !remaining().startsWith(typed)) return false;
+    ++m_stats.prefixHits;
+    m_consumed += typed;
+    m_before += typed;
+    // Новый контекст получает уже обрезанную подсказку — возврат к нему тоже попадёт в кэш
+    if (!m_activeId && !remaining().isEmpty()) {
+        m_cache.insert(contextKey(m_before, m_after, m_language, m_path), new QString(remaining()));
+    }
+    return true;
 }
 
 void AICompletion::onReadyStdout() {
     m_buf += m_proc->readAllStandardOutput();
+    qsizetype start = 0;
+    for (qsizetype nl = m_buf.indexOf('\n'); nl >= 0; nl = m_buf.indexOf('\n', start)) {
+        const QByteArray line = m_buf.mid(start, nl - start).trimmed();
+        start = nl + 1;
+        if (line.isEmpty()) continue;
+        const QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (doc.isObject()) handleMessage(doc.object());
+    }
+    m_buf.remove(0, start);
+}
+
+void AICompletion::handleMessage(const QJsonObject &message) {
+    const quint64 id = static_cast<quint64>(message.value("id").toDouble());
+    if (!m_activeId || id != m_activeId) return; // ответ на отменённый/устаревший запрос
+    const QString type = message.value("type").toString();
+    if (type == "partial" || type == "done") {
+        const QString text = message.value("text").toString();
+        // Пока ответ шёл, пользователь мог набрать другое — такая подсказка уже мимо
+        if (!text.startsWith(m_consumed) && !m_consumed.startsWith(text)) {
+            cancel();
+            emit failed("stale");
+            return;
+        }
+        m_suggestion = text;
+        if (type == "partial") {
+            emit suggestionPartial(remaining());
+            return;
+        }
+        m_activeId = 0;
+        const double ms = double(m_latency.nsecsElapsed()) / 1e6;
+        ++m_stats.completed;
+        m_stats.lastLatencyMs = ms;
+        m_stats.avgLatencyMs += (ms - m_stats.avgLatencyMs) / m_stats.completed;
+        while (!m_suggestion.isEmpty() && m_suggestion.back().isSpace()) m_suggestion.chop(1);
+        if (m_suggestion.isEmpty()) { emit failed("empty"); return; }
+        m_cache.insert(m_activeKey, new QString(m_suggestion));
+        if (!m_consumed.isEmpty() && !remaining().isEmpty()) {
+            m_cache.insert(contextKey(m_before, m_after, m_language, m_path), new QString(remaining()));
+        }
+        if (remaining().isEmpty()) emit failed("consumed"); else emit suggestionReady(remaining());
+    } else if (type == "error") {
+        m_activeId = 0;
+        emit failed(message.value("error").toString());
+    }
 }
 
 void AICompletion::onFinished(int exitCode, QProcess::ExitStatus status) {
     Q_UNUSED(exitCode); Q_UNUSED(status);
-    auto text = QString::fromUtf8(m_buf).trimmed();
-    if (text.isEmpty()) emit failed("empty"); else emit suggestionReady(text);
+    // Воркер упал — текущий запрос потерян; следующий request() поднимет его заново
+    if (m_activeId) {
+        m_activeId = 0;
+        emit failed("воркер автодополнения завершился");
+    }
 }
-
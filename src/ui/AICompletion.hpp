@@ -1,23 +1,78 @@
 #pragma once
 #include <QObject>
 #include <QProcess>
+#include <QJsonObject>
+#include <QCache>
+#include <QElapsedTimer>
 
+// Клиент долгоживущего воркера автодополнения (python/ide_agent.py --serve).
+// Протокол — JSON Lines через stdin/stdout, одна строка на сообщение:
+//   -> {"type":"complete","id":N,"content":...,"cursor":...,"language":...,"path":...}
+//   -> {"type":"cancel","id":N}
+//   <- {"type":"partial","id":N,"text":...}   накопленный текст по мере стриминга
+//   <- {"type":"done","id":N,"text":...} / {"type":"error","id":N,"error":...}
+// Ответы на устаревшие id отбрасываются: значим только последний запрос.
+//
+// В воркер уходит не весь буфер, а окно вокруг курсора; по хэшу окна готовые
+// подсказки кэшируются. Сигналы отдают ещё не набранный хвост подсказки:
+// если пользователь печатает ровно то, что предложено, advance() обрезает её локально.
 class AICompletion : public QObject {
     Q_OBJECT
 public:
+    struct Stats {
+        int requests = 0;     // запросов от редактора
+        int cacheHits = 0;    // ответ из кэша, без воркера
+        int prefixHits = 0;   // набранный символ совпал с подсказкой
+        int completed = 0;    // ответов воркера
+        double lastLatencyMs = 0.0;
+        double avgLatencyMs = 0.0;
+        double hitRate() const { return requests ? double(cacheHits) / requests : 0.0; }
+        QString summary() const;
+    };
+
+    static constexpr int WindowBefore = 4000; // символов контекста до курсора
+    static constexpr int WindowAfter = 1000;  // и после
+
     explicit AICompletion(QObject *parent=nullptr);
+    ~AICompletion() override;
     void request(const QString &content,
                  int cursorOffset,
                  const QString &language,
                  const QString &filePath);
+    // Отменить текущий запрос (текст изменился — ответ уже не нужен).
+    void cancel();
+    // Пользователь набрал typed сразу за курсором. true — набранное продолжает
+    // текущую подсказку, она обрезана (remaining()), запрос не отменяется.
+    bool advance(const QString &typed);
+    QString remaining() const { return m_suggestion.mid(m_consumed.size()); }
+    const Stats &stats() const { return m_stats; }
+    // Поднять воркер заранее, чтобы первый запрос не платил за старт интерпретатора.
+    void warmUp();
 signals:
+    void suggestionPartial(const QString &text);
     void suggestionReady(const QString &text);
     void failed(const QString &error);
 private slots:
     void onFinished(int exitCode, QProcess::ExitStatus status);
     void onReadyStdout();
 private:
+    void ensureWorker();
+    void send(const QJsonObject &message);
+    void handleMessage(const QJsonObject &message);
+    static size_t contextKey(QStringView before, QStringView after, const QString &language, const QString &filePath);
+
     QProcess *m_proc=nullptr;
     QByteArray m_buf;
-};
+    quint64 m_nextId = 1;
+    quint64 m_activeId = 0; // 0 — ничего не ждём
 
+    QCache<size_t, QString> m_cache{256};
+    size_t m_activeKey = 0;
+    QElapsedTimer m_latency;
+    // Подсказка к последнему запросу (целиком) и набранная с тех пор её часть
+    QString m_suggestion;
+    QString m_consumed;
+    // Контекст последнего запроса — чтобы положить в кэш и обрезанную подсказку
+    QString m_before, m_after, m_language, m_path;
+    Stats m_stats;
+};
@@ -0,0 +1,101 @@
+#include "AssetBrowser.hpp"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QIcon>
+#include <QPixmap>
+#include <QScrollBar>
+#include <QTreeWidget>
+#include "ThumbnailCache.hpp"
+
+namespace {
+// Прокрутка идёт рывками — превью запрашиваем, когда она замерла
+constexpr int kVisibleDelayMs = 80;
+}
+
+AssetBrowser::AssetBrowser(QTreeWidget *tree, QTreeWidgetItem *scenes, QTreeWidgetItem *models, ThumbnailCache *cache,
+                           QObject *parent)
+    : QObject(parent), m_tree(tree), m_scenes(scenes), m_models(models), m_cache(cache) {
+    m_pool.setMaxThreadCount(1);
+    m_visibleTimer.setSingleShot(true);
+    m_visibleTimer.setInterval(kVisibleDelayMs);
+    connect(&m_visibleTimer, &QTimer::timeout, this, &AssetBrowser::requestVisible);
+    connect(m_tree->verticalScrollBar(), &QScrollBar::valueChanged, &m_visibleTimer, qOverload<>(&QTimer::start));
+    connect(m_tree, &QTreeWidget::itemExpanded, &m_visibleTimer, qOverload<>(&QTimer::start));
+    connect(m_cache, &ThumbnailCache::thumbnailReady, this, &AssetBrowser::onThumbnail);
+    connect(m_tree, &QTreeWidget::itemDoubleClicked, this, [this](QTreeWidgetItem *item, int){
+        const QString path = item->data(0, PathRole).toString();
+        if (path.isEmpty()) return;
+        if (item->parent() == m_scenes) emit sceneActivated(path);
+        else emit modelActivated(path);
+    });
+}
+
+AssetBrowser::~AssetBrowser() {
+    // Обход пишет в this через очередь событий — дожидаемся его до удаления
+    m_generation.fetch_add(1);
+    m_pool.waitForDone();
+}
+
+void AssetBrowser::setRoot(const QString &root) {
+    m_root = QDir(root).absolutePath();
+    const quint64 generation = m_generation.fetch_add(1) + 1;
+    m_pool.start([this, root = m_root, generation]{
+        QStringList scenes, models;
+        // Скрытые каталоги (.git, кэш превью) QDirIterator без QDir::Hidden не обходит
+        QDirIterator it(root, {"*.scene", "*.obj"}, QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+        while (it.hasNext() && m_generation.load() == generation) {
+            const QString path = it.next();
+            if (path.endsWith(".scene", Qt::CaseInsensitive)) scenes.append(path);
+            else models.append(path);
+        }
+        scenes.sort(Qt::CaseInsensitive);
+        models.sort(Qt::CaseInsensitive);
+        QMetaObject::invokeMethod(this, [this, generation, scenes, models]{ populate(generation, scenes, models); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void AssetBrowser::populate(quint64 generation, const QStringList &scenes, const QStringList &models) {
+    if (generation != m_generation.load()) return;
+    m_tree->setUpdatesEnabled(false);
+    m_items.clear();
+    fill(m_scenes, scenes);
+    fill(m_models, models);
+    m_tree->setUpdatesEnabled(true);
+    m_visibleTimer.start();
+}
+
+void AssetBrowser::fill(QTreeWidgetItem *node, const QStringList &paths) {
+    qDeleteAll(node->takeChildren());
+    // Строки собираются отдельно и вставляются одним addChildren
+    QList<QTreeWidgetItem*> items;
+    items.reserve(paths.size());
+    const QDir root(m_root);
+    for (const QString &path : paths) {
+        auto item = new QTreeWidgetItem(QStringList(QFileInfo(path).fileName()));
+        item->setToolTip(0, root.relativeFilePath(path));
+        item->setData(0, PathRole, path);
+        m_items.insert(path, item);
+        items.append(item);
+    }
+    node->addChildren(items);
+    node->setText(0, QString("%1 (%2)").arg(node == m_scenes ? "Scenes" : "Models").arg(paths.size()));
+}
+
+void AssetBrowser::requestVisible() {
+    const int bottom = m_tree->viewport()->height();
+    for (QTreeWidgetItem *item = m_tree->itemAt(0, 0); item; item = m_tree->itemBelow(item)) {
+        if (m_tree->visualItemRect(item).top() > bottom) break;
+        const QString path = item->data(0, PathRole).toString();
+        if (path.isEmpty() || item->data(0, RequestedRole).toBool()) continue;
+        item->setData(0, RequestedRole, true);
+        // Попадание в атлас отдаётся сразу, промах придёт в onThumbnail
+        const QImage image = m_cache->thumbnail(path);
+        if (!image.isNull()) item->setIcon(0, QIcon(QPixmap::fromImage(image)));
+    }
+}
+
+void AssetBrowser::onThumbnail(const QString &path, const QImage &image) {
+    if (QTreeWidgetItem *item = m_items.value(path)) item->setIcon(0, QIcon(QPixmap::fromImage(image)));
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+
+class QTreeWidget;
+class QTreeWidgetItem;
+class ThumbnailCache;
+
+// Узлы Assets/Scenes и Assets/Models дерева проекта: файлы .scene и .obj
+// под корнем проекта с превью из ThumbnailCache.
+//
+// Обход каталогов — в фоне. Превью запрашиваются только для строк, видимых
+// в дереве (после прокрутки и раскрытия, с задержкой), поэтому листание
+// тысяч моделей не ставит в очередь отрисовку всех сразу.
+class AssetBrowser : public QObject {
+    Q_OBJECT
+public:
+    AssetBrowser(QTreeWidget *tree, QTreeWidgetItem *scenes, QTreeWidgetItem *models, ThumbnailCache *cache,
+                 QObject *parent=nullptr);
+    ~AssetBrowser() override;
+
+    void setRoot(const QString &root);
+    QString root() const { return m_root; }
+
+signals:
+    // Двойной щелчок по строке ассета
+    void modelActivated(const QString &path);
+    void sceneActivated(const QString &path);
+
+private:
+    enum Role { PathRole = Qt::UserRole, RequestedRole };
+
+    void populate(quint64 generation, const QStringList &scenes, const QStringList &models);
+    void fill(QTreeWidgetItem *node, const QStringList &paths);
+    void requestVisible();
+    void onThumbnail(const QString &path, const QImage &image);
+
+    QTreeWidget *m_tree;
+    QTreeWidgetItem *m_scenes;
+    QTreeWidgetItem *m_models;
+    ThumbnailCache *m_cache;
+    QString m_root;
+    QHash<QString, QTreeWidgetItem*> m_items; // абсолютный путь -> строка
+
+    QThreadPool m_pool; // один поток: обходы идут по очереди
+    std::atomic<quint64> m_generation{0};
+    QTimer m_visibleTimer;
+};
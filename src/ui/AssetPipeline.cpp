@@ -0,0 +1,310 @@
+#include "AssetPipeline.hpp"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QReadWriteLock>
+#include <QSaveFile>
+#include <cstring>
+#include <utility>
+
+// Что нужно потокам разбора сцен, чтобы достать меш по GUID
+struct AssetTable {
+    struct Entry {
+        QString cooked; // абсолютные пути
+        QString source;
+        ImportSettings settings;
+        // Штамп, с которым cooked годится; 0 — cooked ещё не записан
+        quint64 contentHash = 0;
+        quint32 settingsHash = 0;
+    };
+    QReadWriteLock lock;
+    QHash<QString, Entry> entries;
+};
+
+struct AssetPipeline::Result {
+    quint64 contentHash = 0;
+    qint64 mtime = 0;
+    qint64 size = 0;
+    bool cooked = false; // источник разобран, cooked записан заново
+    qint64 elapsedMs = 0;
+    std::shared_ptr<SceneObject> object;
+    QString error;
+};
+
+namespace {
+// Редакторы сохраняют файл в несколько приёмов — ждём, пока запись закончится
+constexpr int kChangeDelayMs = 300;
+constexpr int kSaveDelayMs = 1000;
+
+quint64 contentHashOf(const QByteArray &data) {
+    const QByteArray digest = QCryptographicHash::hash(data, QCryptographicHash::Md5);
+    quint64 v = 0;
+    std::memcpy(&v, digest.constData(), sizeof(v));
+    // 0 зарезервирован за «ещё не импортирован»
+    return v ? v : 1;
+}
+
+bool parseSource(const QByteArray &data, const ImportSettings &settings, std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    parseObj(data.constData(), size_t(data.size()), vertices, faces);
+    applyImportSettings(settings, vertices);
+    return !vertices.empty();
+}
+
+// cooked годится, если собран из содержимого с хэшем contentHash с теми же настройками
+bool readCooked(const QString &path, quint64 contentHash, quint32 settingsHash, std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    QFile f(path);
+    if (contentHash == 0 || !f.open(QIODevice::ReadOnly)) return false;
+    const QByteArray data = f.readAll();
+    quint64 hash = 0;
+    quint32 settings = 0;
+    return CookedMesh::readStamp(data, hash, settings) && hash == contentHash && settings == settingsHash
+        && CookedMesh::load(data, vertices, faces);
+}
+
+bool loadAssetMesh(AssetTable &table, const std::string &guid, std::vector<Vertex> &vertices, std::vector<Face> &faces) {
+    AssetTable::Entry e;
+    {
+        QReadLocker locker(&table.lock);
+        auto it = table.entries.constFind(QString::fromStdString(guid));
+        if (it == table.entries.cend()) return false;
+        e = *it;
+    }
+    if (readCooked(e.cooked, e.contentHash, e.settingsHash, vertices, faces)) return true;
+    // cooked удалили, он битый или собран из другой версии источника — разбираем
+    // источник; cooked пересоберёт следующий импорт
+    vertices.clear();
+    faces.clear();
+    QFile source(e.source);
+    return source.open(QIODevice::ReadOnly) && parseSource(source.readAll(), e.settings, vertices, faces);
+}
+} // namespace
+
+AssetPipeline::AssetPipeline(QObject *parent) : QObject(parent), m_table(std::make_shared<AssetTable>()) {
+    m_pool.setMaxThreadCount(1);
+    m_changeTimer.setSingleShot(true);
+    m_changeTimer.setInterval(kChangeDelayMs);
+    connect(&m_changeTimer, &QTimer::timeout, this, &AssetPipeline::flushChanges);
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(kSaveDelayMs);
+    connect(&m_saveTimer, &QTimer::timeout, this, &AssetPipeline::save);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &path){
+        m_changed.insert(path);
+        m_changeTimer.start();
+    });
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &AssetPipeline::onDirectoryChanged);
+}
+
+AssetPipeline::~AssetPipeline() {
+    // Задачи пула пишут в this через очередь событий — дожидаемся их до удаления
+    m_pool.waitForDone();
+    if (m_dirty) save();
+}
+
+void AssetPipeline::openProject(const QString &root) {
+    if (m_dirty) save();
+    m_root = QDir::cleanPath(QFileInfo(root).absoluteFilePath());
+    m_db.clear();
+    m_reimporting.clear();
+    m_reimportAgain.clear();
+    m_changed.clear();
+    {
+        QWriteLocker locker(&m_table->lock);
+        m_table->entries.clear();
+    }
+    if (!m_watcher.files().isEmpty()) m_watcher.removePaths(m_watcher.files());
+    if (!m_watcher.directories().isEmpty()) m_watcher.removePaths(m_watcher.directories());
+
+    QFile f(absolute(DatabaseFile));
+    if (f.open(QIODevice::ReadOnly)) {
+        const QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
+        if (!doc.isObject() || !m_db.fromJson(doc.object(), CookedDir)) emit log("[ASSET] База ассетов не прочитана, ассеты импортируются заново");
+    }
+    // Пропуск по stat: источник не менялся — cooked остаётся как есть
+    int stale = 0;
+    for (const AssetRecord &record : m_db.records()) {
+        publish(record);
+        const QString source = absolute(record.source);
+        watchSource(source);
+        const QFileInfo info(source);
+        if (!info.isFile() || (info.lastModified().toMSecsSinceEpoch() == record.mtime && info.size() == record.size)) continue;
+        enqueue(record, Job::Reimport);
+        ++stale;
+    }
+    emit log(QString("[ASSET] Проект %1: ассетов %2, к переимпорту %3").arg(m_root).arg(m_db.size()).arg(stale));
+}
+
+void AssetPipeline::instantiate(const QString &source) {
+    const QString path = QFileInfo(source).absoluteFilePath();
+    const QString key = sourceKey(path);
+    const AssetRecord *record = m_db.findBySource(key);
+    if (!record) {
+        record = &m_db.add(key, CookedDir);
+        publish(*record);
+        watchSource(path);
+        markDirty();
+    }
+    enqueue(*record, Job::Instantiate);
+}
+
+AssetMeshLoader AssetPipeline::meshLoader() const {
+    std::shared_ptr<AssetTable> table = m_table;
+    return [table](const std::string &guid, std::vector<Vertex> &vertices, std::vector<Face> &faces){
+        return loadAssetMesh(*table, guid, vertices, faces);
+    };
+}
+
+QString AssetPipeline::sourceKey(const QString &absolutePath) const {
+    const QString relative = QDir(m_root).relativeFilePath(absolutePath);
+    return relative.startsWith("../") ? absolutePath : relative;
+}
+
+QString AssetPipeline::absolute(const QString &path) const {
+    return QDir::cleanPath(QDir(m_root).absoluteFilePath(path));
+}
+
+void AssetPipeline::publish(const AssetRecord &record) {
+    QWriteLocker locker(&m_table->lock);
+    m_table->entries.insert(record.guid, {absolute(record.cooked), absolute(record.source), record.settings,
+                                          record.contentHash, record.settings.hash()});
+}
+
+void AssetPipeline::watchSource(const QString &absolutePath) {
+    // Каталог — тоже: редактор, сохраняющий через переименование, снимает файл с наблюдения
+    // Повторный addPath уже наблюдаемого пути QFileSystemWatcher пропускает сам
+    const QFileInfo info(absolutePath);
+    if (QFileInfo(info.absolutePath()).isDir()) m_watcher.addPath(info.absolutePath());
+    if (info.isFile()) m_watcher.addPath(absolutePath);
+}
+
+void AssetPipeline::enqueue(const AssetRecord &record, Job job) {
+    if (job == Job::Reimport) {
+        if (m_reimporting.contains(record.guid)) { m_reimportAgain.insert(record.guid); return; }
+        m_reimporting.insert(record.guid);
+    }
+    const QString guid = record.guid;
+    const QString source = absolute(record.source);
+    const QString cooked = absolute(record.cooked);
+    const AssetRecord known = record;
+    m_pool.start([this, job, guid, source, cooked, known]{
+        QElapsedTimer timer;
+        timer.start();
+        Result r;
+        auto object = std::make_shared<SceneObject>(std::vector<Vertex>(), std::vector<Face>(), QFileInfo(source).baseName().toStdString());
+        object->asset = guid.toStdString();
+        const quint32 settingsHash = known.settings.hash();
+        const QFileInfo info(source);
+        r.mtime = info.lastModified().toMSecsSinceEpoch();
+        r.size = info.size();
+        r.contentHash = known.contentHash;
+        if (!info.isFile()) {
+            // Источник пропал: ассет живёт, пока цел cooked
+            r.mtime = known.mtime;
+            r.size = known.size;
+            if (!readCooked(cooked, known.contentHash, settingsHash, object->vertices, object->faces)) r.error = "Источник не найден";
+        } else if (r.mtime != known.mtime || r.size != known.size
+                   || !readCooked(cooked, known.contentHash, settingsHash, object->vertices, object->faces)) {
+            QFile f(source);
+            if (!f.open(QIODevice::ReadOnly)) {
+                r.error = "Не удалось открыть файл";
+            } else {
+                const QByteArray data = f.readAll();
+                r.contentHash = contentHashOf(data);
+                object->vertices.clear();
+                object->faces.clear();
+                // Файл тронули, но содержимое прежнее — cooked годится
+                if (r.contentHash != known.contentHash
+                    || !readCooked(cooked, r.contentHash, settingsHash, object->vertices, object->faces)) {
+                    if (!parseSource(data, known.settings, object->vertices, object->faces)) {
+                        r.error = "В файле нет вершин";
+                    } else {
+                        QDir().mkpath(QFileInfo(cooked).absolutePath());
+                        QSaveFile out(cooked);
+                        const bool written = out.open(QIODevice::WriteOnly)
+                            && out.write(CookedMesh::save(object->vertices, object->faces, r.contentHash, settingsHash)) >= 0
+                            && out.commit();
+                        // Без cooked ассет всё равно пригоден: следующий раз источник разберётся снова
+                        if (!written) r.contentHash = 0;
+                        r.cooked = true;
+                    }
+                }
+            }
+        }
+        r.object = std::move(object);
+        r.elapsedMs = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, job, guid, r]{ finish(job, guid, r); }, Qt::QueuedConnection);
+    }, job == Job::Instantiate ? 1 : 0); // модель для сцены ждут сейчас — она обгоняет переимпорт
+}
+
+void AssetPipeline::finish(Job job, const QString &guid, const Result &r) {
+    if (job == Job::Reimport) m_reimporting.remove(guid);
+    AssetRecord *record = m_db.find(guid);
+    if (!record) return; // проект сменился
+    const QString source = record->source;
+    if (!r.error.isEmpty()) {
+        emit log("[ASSET] " + source + ": " + r.error);
+    } else {
+        if (r.contentHash != record->contentHash || r.mtime != record->mtime || r.size != record->size) {
+            record->contentHash = r.contentHash;
+            record->mtime = r.mtime;
+            record->size = r.size;
+            publish(*record);
+            markDirty();
+        }
+        if (r.cooked) {
+            emit log(QString("[ASSET] Импортирован %1: вершин %2, %3 мс").arg(source).arg(r.object->vertices.size()).arg(r.elapsedMs));
+        }
+        // Собранный заново меш нужен и объектам, уже стоящим в сцене
+        if (r.cooked) emit reimported(guid, r.object);
+        if (job == Job::Instantiate) emit instantiated(absolute(source), r.object);
+    }
+    // Изменение, пришедшее во время переимпорта: flushChanges сверит stat с обновлённой записью
+    if (m_reimportAgain.remove(guid)) {
+        m_changed.insert(absolute(source));
+        m_changeTimer.start();
+    }
+}
+
+void AssetPipeline::onDirectoryChanged(const QString &dir) {
+    // Файл, заменённый переименованием, заново ставится под наблюдение в flushChanges
+    const QStringList files = m_watcher.files();
+    const QSet<QString> watched(files.cbegin(), files.cend());
+    for (const AssetRecord &record : m_db.records()) {
+        const QString source = absolute(record.source);
+        if (QFileInfo(source).absolutePath() == dir && !watched.contains(source)) m_changed.insert(source);
+    }
+    if (!m_changed.isEmpty()) m_changeTimer.start();
+}
+
+void AssetPipeline::flushChanges() {
+    const QSet<QString> changed = std::exchange(m_changed, {});
+    for (const QString &path : changed) {
+        const QFileInfo info(path);
+        if (!info.isFile()) continue;
+        if (!m_watcher.files().contains(path)) m_watcher.addPath(path);
+        const AssetRecord *record = m_db.findBySource(sourceKey(path));
+        if (!record) continue;
+        if (info.lastModified().toMSecsSinceEpoch() == record->mtime && info.size() == record->size) continue;
+        enqueue(*record, Job::Reimport);
+    }
+}
+
+void AssetPipeline::markDirty() {
+    m_dirty = true;
+    m_saveTimer.start();
+}
+
+void AssetPipeline::save() {
+    if (m_root.isEmpty()) return;
+    const QString path = absolute(DatabaseFile);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile f(path);
+    if (f.open(QIODevice::WriteOnly) && f.write(QJsonDocument(m_db.toJson()).toJson()) >= 0 && f.commit()) {
+        m_dirty = false;
+    } else {
+        emit log("[ASSET] Не удалось записать " + path);
+    }
+}
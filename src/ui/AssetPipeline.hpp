@@ -0,0 +1,77 @@
+#pragma once
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+#include <memory>
+#include "core/AssetDatabase.hpp"
+#include "core/Scene.hpp"
+
+struct AssetTable;
+
+// Конвейер ассетов проекта: база (.simplecascade/assets.json), готовые меши
+// (.simplecascade/cooked/<guid>.mesh) и фоновая очередь импорта.
+//
+// Модель в сцену попадает через instantiate(): есть свежий cooked — он
+// читается одним куском, OBJ не разбирается; нет — источник импортируется в
+// очереди. Сцены ссылаются на ассеты по GUID, меши им отдаёт meshLoader().
+// Источники под наблюдением QFileSystemWatcher: изменившийся OBJ
+// переимпортируется в фоне, объекты сцены обновляются по reimported.
+class AssetPipeline : public QObject {
+    Q_OBJECT
+public:
+    static constexpr const char *DatabaseFile = ".simplecascade/assets.json";
+    static constexpr const char *CookedDir = ".simplecascade/cooked";
+
+    explicit AssetPipeline(QObject *parent=nullptr);
+    ~AssetPipeline() override;
+
+    // Источники, изменившиеся с прошлого импорта, переимпортируются в фоне;
+    // остальные до первого обращения не читаются
+    void openProject(const QString &root);
+    QString root() const { return m_root; }
+    const AssetDatabase &database() const { return m_db; }
+
+    // Объект с мешем OBJ-файла source, ответ — в instantiated. Нет записи — заводится
+    void instantiate(const QString &source);
+    // Меши по GUID для sceneFromJson: зовётся из любых потоков и видит
+    // ассеты, заведённые после вызова
+    AssetMeshLoader meshLoader() const;
+    // Запись базы на диск; сама вызывается через секунду после изменений
+    void save();
+
+signals:
+    void instantiated(const QString &source, std::shared_ptr<SceneObject> object);
+    // Источник изменился и собран заново: объектам сцены с этим GUID — новый меш
+    void reimported(const QString &guid, std::shared_ptr<SceneObject> object);
+    void log(const QString &line);
+
+private:
+    enum class Job { Instantiate, Reimport };
+    struct Result;
+
+    QString sourceKey(const QString &absolutePath) const;
+    QString absolute(const QString &path) const;
+    void publish(const AssetRecord &record);
+    void watchSource(const QString &absolutePath);
+    void enqueue(const AssetRecord &record, Job job);
+    void finish(Job job, const QString &guid, const Result &result);
+    void onDirectoryChanged(const QString &dir);
+    void flushChanges();
+    void markDirty();
+
+    QString m_root;
+    AssetDatabase m_db;
+    std::shared_ptr<AssetTable> m_table; // GUID -> файлы, для потоков разбора сцен
+
+    QThreadPool m_pool; // очередь импорта: один поток, instantiate — вне очереди
+    QSet<QString> m_reimporting;  // GUID в очереди на переимпорт
+    QSet<QString> m_reimportAgain; // источник снова изменился, пока шёл переимпорт
+
+    QFileSystemWatcher m_watcher;
+    QSet<QString> m_changed; // абсолютные пути источников
+    QTimer m_changeTimer;
+    QTimer m_saveTimer;
+    bool m_dirty = false;
+};
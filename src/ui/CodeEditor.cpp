@@ -2,83 +2,202 @@
 #include "CodeEditor.hpp"
 #include <QPainter>
 #include <QTextBlock>
+#include <QElapsedTimer>
+
+namespace {
+
+// Пометка блока, который пока только протянул состояние и ждёт раскраски
+struct HighlightBlockData : public QTextBlockUserData {
+    bool pending = false;
+};
+
+bool isPending(const QTextBlock &block) {
+    auto *data = static_cast<HighlightBlockData*>(block.userData());
+    return data && data->pending;
+}
+
+inline bool isIdentStart(QChar c) { return c.isLetter() || c == QLatin1Char('_'); }
+inline bool isIdentChar(QChar c) { return c.isLetterOrNumber() || c == QLatin1Char('_'); }
+
+// Запас вокруг видимой области, который раскрашивается сразу
+constexpr int kVisibleMargin = 50;
+// Бюджет одной порции ленивой раскраски
+constexpr int kIdleSliceMs = 8;
+
+} // namespace
 
 Highlighter::Highlighter(QTextDocument *parent) : QSyntaxHighlighter(parent) {
     keywordFormat.setForeground(Qt::darkBlue);
     keywordFormat.setFontWeight(QFont::Bold);
 
-    const QString keywordPatterns[] = {
-        "\\bchar\\b", "\\bclass\\b", "\\bconst\\b", "\\bdouble\\b",
-        "\\benum\\b", "\\bexplicit\\b", "\\bfriend\\b", "\\binline\\b",
-        "\\bint\\b", "\\blong\\b", "\\bnamespace\\b", "\\boperator\\b",
-        "\\bprivate\\b", "\\bprotected\\b", "\\bpublic\\b", "\\bshort\\b",
-        "\\bsignals\\b", "\\bsigned\\b", "\\bslots\\b", "\\bstatic\\b",
-        "\\bstruct\\b", "\\btemplate\\b", "\\btypedef\\b", "\\btypename\\b",
-        "\\bunion\\b", "\\bunsigned\\b", "\\bvirtual\\b", "\\bvoid\\b", "\\bvolatile\\b"
-    };
-    for (const QString &pattern : keywordPatterns) {
-        HighlightingRule rule;
-        rule.pattern = QRegularExpression(pattern);
-        rule.format = keywordFormat;
-        highlightingRules.append(rule);
+    m_trie.emplace_back();
+    for (const char *keyword : {
+        "char", "class", "const", "double",
+        "enum", "explicit", "friend", "inline",
+        "int", "long", "namespace", "operator",
+        "private", "protected", "public", "short",
+        "signals", "signed", "slots", "static",
+        "struct", "template", "typedef", "typename",
+        "union", "unsigned", "virtual", "void", "volatile" }) {
+        addKeyword(keyword);
     }
 
     classFormat.setForeground(Qt::darkMagenta);
     classFormat.setFontWeight(QFont::Bold);
-    HighlightingRule classRule;
-    classRule.pattern = QRegularExpression("\\bQ[A-Za-z]+\\b");
-    classRule.format = classFormat;
-    highlightingRules.append(classRule);
-
     commentFormat.setForeground(Qt::darkGreen);
-    HighlightingRule singleLineCommentRule;
-    singleLineCommentRule.pattern = QRegularExpression("//[^\n]*");
-    singleLineCommentRule.format = commentFormat;
-    highlightingRules.append(singleLineCommentRule);
-
     stringFormat.setForeground(Qt::darkYellow);
-    HighlightingRule stringRule;
-    stringRule.pattern = QRegularExpression("\".*\"");
-    stringRule.format = stringFormat;
-    highlightingRules.append(stringRule);
-
     numberFormat.setForeground(Qt::darkCyan);
-    HighlightingRule numberRule;
-    numberRule.pattern = QRegularExpression("\\b\\d+\\.?\\d*\\b");
-    numberRule.format = numberFormat;
-    highlightingRules.append(numberRule);
 
-    commentStart = QRegularExpression("/\\*");
-    commentEnd = QRegularExpression("\\*/");
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(0);
+    connect(&m_idleTimer, &QTimer::timeout, this, &Highlighter::highlightPending);
 }
 
-void Highlighter::highlightBlock(const QString &text) {
-    for (const HighlightingRule &rule : std::as_const(highlightingRules)) {
-        QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
-        while (matchIterator.hasNext()) {
-            QRegularExpressionMatch match = matchIterator.next();
-            setFormat(match.capturedStart(), match.capturedLength(), rule.format);
+void Highlighter::addKeyword(const char *word) {
+    int node = 0;
+    for (const char *c = word; *c; ++c) {
+        const int k = *c - 'a';
+        if (!m_trie[node].next[k]) {
+            m_trie[node].next[k] = static_cast<int>(m_trie.size());
+            m_trie.emplace_back();
+        }
+        node = m_trie[node].next[k];
+    }
+    m_trie[node].terminal = true;
+}
+
+bool Highlighter::isKeyword(const QChar *p, int length) const {
+    int node = 0;
+    for (int i = 0; i < length; ++i) {
+        const char16_t c = p[i].unicode();
+        if (c < u'a' || c > u'z') return false;
+        node = m_trie[node].next[c - u'a'];
+        if (!node) return false;
+    }
+    return m_trie[node].terminal;
+}
+
+void Highlighter::scan(const QString &text, bool applyFormats) {
+    const QChar *s = text.constData();
+    const int n = text.size();
+    int i = 0;
+    bool inComment = previousBlockState() == InComment;
+
+    if (inComment) {
+        const int end = text.indexOf(QLatin1String("*/"));
+        i = end < 0 ? n : end + 2;
+        if (applyFormats) setFormat(0, i, commentFormat);
+        inComment = end < 0;
+    }
+
+    while (i < n) {
+        const QChar c = s[i];
+        if (c == QLatin1Char('/') && i + 1 < n && s[i + 1] == QLatin1Char('/')) {
+            if (applyFormats) setFormat(i, n - i, commentFormat);
+            break;
+        }
+        if (c == QLatin1Char('/') && i + 1 < n && s[i + 1] == QLatin1Char('*')) {
+            const int end = text.indexOf(QLatin1String("*/"), i + 2);
+            const int stop = end < 0 ? n : end + 2;
+            if (applyFormats) setFormat(i, stop - i, commentFormat);
+            inComment = end < 0;
+            i = stop;
+            continue;
+        }
+        if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            // Строка/символ до парной кавычки с учётом экранирования; незакрытая — до конца строки
+            int j = i + 1;
+            while (j < n && s[j] != c) j += (s[j] == QLatin1Char('\\')) ? 2 : 1;
+            j = qMin(j + 1, n);
+            if (applyFormats) setFormat(i, j - i, stringFormat);
+            i = j;
+            continue;
+        }
+        if (isIdentStart(c)) {
+            int j = i + 1;
+            while (j < n && isIdentChar(s[j])) ++j;
+            if (applyFormats) {
+                if (isKeyword(s + i, j - i)) {
+                    setFormat(i, j - i, keywordFormat);
+                } else if (c == QLatin1Char('Q') && j - i > 1) {
+                    // Классы Qt: Q + только буквы
+                    bool letters = true;
+                    for (int k = i + 1; k < j && letters; ++k) letters = s[k].isLetter();
+                    if (letters) setFormat(i, j - i, classFormat);
+                }
+            }
+            i = j;
+            continue;
         }
+        if (c.isDigit()) {
+            // pp-number: 42, 3.14f, 0x1F, 1e-5
+            int j = i + 1;
+            while (j < n && (isIdentChar(s[j]) || s[j] == QLatin1Char('.')
+                             || ((s[j] == QLatin1Char('+') || s[j] == QLatin1Char('-'))
+                                 && (s[j - 1] == QLatin1Char('e') || s[j - 1] == QLatin1Char('E'))))) ++j;
+            if (applyFormats) setFormat(i, j - i, numberFormat);
+            i = j;
+            continue;
+        }
+        ++i;
     }
+    setCurrentBlockState(inComment ? InComment : Normal);
+}
 
-    setCurrentBlockState(0);
-    int startIndex = 0;
-    if (previousBlockState() != 1)
-        startIndex = text.indexOf(commentStart);
+void Highlighter::highlightBlock(const QString &text) {
+    auto *data = static_cast<HighlightBlockData*>(currentBlockUserData());
+    if (!data) {
+        data = new HighlightBlockData;
+        setCurrentBlockUserData(data);
+    }
+    const int number = currentBlock().blockNumber();
+    const bool visible = number >= m_visibleFirst - kVisibleMargin && number <= m_visibleLast + kVisibleMargin;
+    data->pending = !(visible || m_forceFormat);
+    scan(text, !data->pending);
+    if (data->pending && !m_idleTimer.isActive()) {
+        m_cleanRun = 0;
+        m_idleTimer.start();
+    }
+}
+
+void Highlighter::setVisibleBlocks(int first, int last) {
+    if (first == m_visibleFirst && last == m_visibleLast) return;
+    m_visibleFirst = first;
+    m_visibleLast = last;
+    // Раскраска не из обработчика изменения документа: QSyntaxHighlighter этого не любит
+    m_cleanRun = 0;
+    m_idleTimer.start();
+}
 
-    while (startIndex >= 0) {
-        QRegularExpressionMatch match = commentEnd.match(text, startIndex);
-        int endIndex = match.capturedStart();
-        int commentLength = 0;
-        if (endIndex == -1) {
-            setCurrentBlockState(1);
-            commentLength = text.length() - startIndex;
+void Highlighter::highlightPending() {
+    QTextDocument *doc = document();
+    if (!doc) return;
+    QElapsedTimer timer;
+    timer.start();
+    m_forceFormat = true;
+
+    // Сначала видимое
+    for (QTextBlock b = doc->findBlockByNumber(qMax(0, m_visibleFirst)); b.isValid() && b.blockNumber() <= m_visibleLast; b = b.next()) {
+        if (isPending(b)) rehighlightBlock(b);
+    }
+
+    // Затем остальное — по кругу, пока весь документ не окажется раскрашен
+    const int total = doc->blockCount();
+    QTextBlock b = doc->findBlockByNumber(m_idleBlock);
+    if (!b.isValid()) b = doc->begin();
+    while (m_cleanRun < total && timer.elapsed() < kIdleSliceMs) {
+        if (isPending(b)) {
+            rehighlightBlock(b);
+            m_cleanRun = 0;
         } else {
-            commentLength = endIndex - startIndex + match.capturedLength();
+            ++m_cleanRun;
         }
-        setFormat(startIndex, commentLength, commentFormat);
-        startIndex = text.indexOf(commentStart, startIndex + commentLength);
+        b = b.next();
+        if (!b.isValid()) b = doc->begin();
     }
+    m_idleBlock = b.blockNumber();
+    m_forceFormat = false;
+    if (m_cleanRun < total) m_idleTimer.start();
 }
 
 // === Реализация CodeEditor ===
@@ -96,10 +215,22 @@ CodeEditor::CodeEditor(QWidget *parent) : QPlainTextEdit(parent) {
 
     m_completion = new AICompletion(this);
     connect(m_completion, &AICompletion::suggestionReady, this, &CodeEditor::onSuggestionReady);
+    connect(m_completion, &AICompletion::suggestionReady, this, [this]{
+        emit completionStatsChanged(m_completion->stats().summary());
+    });
+    // Подсказка дорисовывается по мере стриминга от воркера
+    connect(m_completion, &AICompletion::suggestionPartial, this, &CodeEditor::onSuggestionReady);
     m_idleTimer.setSingleShot(true);
     m_idleTimer.setInterval(600);
     connect(&m_idleTimer, &QTimer::timeout, this, [this]{ triggerCompletion(); });
-    connect(this, &QPlainTextEdit::textChanged, this, [this]{ m_idleTimer.start(); });
+    connect(this, &QPlainTextEdit::textChanged, this, [this]{
+        if (m_typingIntoSuggestion) return;
+        // Ответ на прежний текст уже не нужен; воркер поднимается заранее, пока идёт пауза
+        m_completion->cancel();
+        clearSuggestion();
+        m_completion->warmUp();
+        m_idleTimer.start();
+    });
 }
 
 void CodeEditor::updateLineNumberAreaWidth(int) {
@@ -114,6 +245,10 @@ void CodeEditor::updateLineNumberAreaWidth(int) {
 }
 
 void CodeEditor::updateLineNumberArea(const QRect &rect, int dy) {
+    const int first = firstVisibleBlock().blockNumber();
+    const int last = cursorForPosition(QPoint(0, viewport()->height() - 1)).block().blockNumber();
+    m_highlighter->setVisibleBlocks(first, qMax(first, last));
+
     if (dy)
         lineNumberArea->scroll(0, dy);
     else
@@ -151,6 +286,16 @@ void CodeEditor::keyPressEvent(QKeyEvent *e) {
         e->accept();
         return;
     }
+    // Набранное совпадает с подсказкой — обрезаем её на месте, без нового запроса
+    const bool plainTyping = !(e->modifiers() & (Qt::ControlModifier | Qt::AltModifier | Qt::MetaModifier));
+    if (!m_ghostText.isEmpty() && plainTyping && !textCursor().hasSelection() && m_completion->advance(e->text())) {
+        m_typingIntoSuggestion = true;
+        QPlainTextEdit::keyPressEvent(e);
+        m_typingIntoSuggestion = false;
+        m_ghostText = m_completion->remaining();
+        viewport()->update();
+        return;
+    }
     QPlainTextEdit::keyPressEvent(e);
 }
 
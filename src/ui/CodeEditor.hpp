@@ -7,31 +7,48 @@
 #include <QPaintEvent>
 #include <QSize>
 #include <QTimer>
+#include <vector>
 #include "AICompletion.hpp"
 
+// Однопроходный токенизатор C++: ключевые слова — по префиксному дереву, без регулярок.
+// Состояние блока — только «внутри /* */». При массовых изменениях (открытие файла,
+// вставка) блоки вне видимой области лишь протягивают состояние, а раскрашиваются
+// позже, в простое: сначала видимые, затем остальные порциями по несколько мс.
 class Highlighter : public QSyntaxHighlighter {
     Q_OBJECT
 
 public:
     Highlighter(QTextDocument *parent = nullptr);
+    // Видимые блоки (номера) — их раскрашиваем первыми; вызывается редактором при прокрутке.
+    void setVisibleBlocks(int first, int last);
 
 protected:
     void highlightBlock(const QString &text) override;
 
 private:
-    struct HighlightingRule {
-        QRegularExpression pattern;
-        QTextCharFormat format;
+    enum BlockState { Normal = 0, InComment = 1 };
+    struct TrieNode {
+        int next[26] = {};
+        bool terminal = false;
     };
-    QVector<HighlightingRule> highlightingRules;
+    void addKeyword(const char *word);
+    bool isKeyword(const QChar *p, int length) const;
+    void scan(const QString &text, bool applyFormats);
+    void highlightPending();
 
-    QRegularExpression commentStart;
-    QRegularExpression commentEnd;
+    std::vector<TrieNode> m_trie;
     QTextCharFormat keywordFormat;
     QTextCharFormat classFormat;
     QTextCharFormat commentFormat;
     QTextCharFormat stringFormat;
     QTextCharFormat numberFormat;
+
+    int m_visibleFirst = 0;
+    int m_visibleLast = 100;
+    bool m_forceFormat = false;
+    int m_idleBlock = 0;   // откуда продолжать ленивый проход
+    int m_cleanRun = 0;    // сколько блоков подряд уже раскрашено
+    QTimer m_idleTimer;
 };
 
 class CodeEditor : public QPlainTextEdit {
@@ -45,6 +62,11 @@ public:
     void triggerCompletion();
     void acceptSuggestion();
     void clearSuggestion();
+    const AICompletion::Stats &completionStats() const { return m_completion->stats(); }
+
+signals:
+    // Готова очередная подсказка — сводка completionStats() для строки состояния
+    void completionStatsChanged(const QString &summary);
 
 protected:
     void resizeEvent(QResizeEvent *event) override;
@@ -72,5 +94,6 @@ private:
     Highlighter *m_highlighter = nullptr;
     AICompletion *m_completion = nullptr;
     QString m_ghostText;
+    bool m_typingIntoSuggestion = false;
     QTimer m_idleTimer;
 };
\ No newline at end of file
@@ -1,10 +1,11 @@
 #include "CodePanel.hpp"
+#include "ModelReceiver.hpp"
 #include <QVBoxLayout>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QFile>
 #include <QTextStream>
-#include <QInputDialog>
+#include <QTextBlock>
 #include <QHeaderView>
 
 CodePanel::CodePanel(QWidget *parent) : QWidget(parent) {
@@ -22,6 +23,9 @@ CodePanel::CodePanel(QWidget *parent) : QWidget(parent) {
     auto saveAct = m_toolbar->addAction("Сохранить");
     auto saveAsAct = m_toolbar->addAction("Сохранить как");
     auto findAct = m_toolbar->addAction("Найти в файле");
+    findAct->setShortcut(QKeySequence::Find);
+    auto findProjectAct = m_toolbar->addAction("Найти в проекте");
+    findProjectAct->setShortcut(QKeySequence("Ctrl+Shift+F"));
     auto aiAct = m_toolbar->addAction("ИИ-подсказка");
     connect(newAct, &QAction::triggered, this, &CodePanel::onNewFile);
     connect(openAct, &QAction::triggered, this, &CodePanel::onOpenFile);
@@ -29,6 +33,7 @@ CodePanel::CodePanel(QWidget *parent) : QWidget(parent) {
     connect(saveAsAct, &QAction::triggered, this, &CodePanel::onSaveAsFile);
     connect(aiAct, &QAction::triggered, this, &CodePanel::onAskAI);
     connect(findAct, &QAction::triggered, this, &CodePanel::onFindInFile);
+    connect(findProjectAct, &QAction::triggered, this, &CodePanel::onFindInProject);
 
     auto splitter = new QSplitter(Qt::Horizontal, this);
     layout->addWidget(splitter);
@@ -40,6 +45,13 @@ CodePanel::CodePanel(QWidget *parent) : QWidget(parent) {
     m_filterModel = new FilenameFilterModel(this);
     m_filterModel->setSourceModel(m_fsModel);
 
+    // Индекс имён строится в фоне; фильтр до его готовности не применяется
+    m_fileIndex = new FileIndex(this);
+    m_fileIndex->setRoot(QDir::currentPath());
+    connect(m_fileIndex, &FileIndex::ready, this, [this]{ onSearchTextChanged(m_filterEdit->text()); });
+    connect(m_fileIndex, &FileIndex::changed, this, [this]{ if (m_filterModel->isActive()) onSearchTextChanged(m_filterEdit->text()); });
+    connect(m_fsModel, &QFileSystemModel::directoryLoaded, this, &CodePanel::onDirectoryLoaded);
+
     m_tree = new QTreeView();
     m_tree->setModel(m_filterModel);
     m_tree->setRootIndex(m_filterModel->mapFromSource(m_fsModel->index(QDir::currentPath())));
@@ -50,13 +62,62 @@ CodePanel::CodePanel(QWidget *parent) : QWidget(parent) {
     connect(m_tree, &QTreeView::doubleClicked, this, &CodePanel::onTreeDoubleClicked);
 
     m_editor = new CodeEditor();
-    splitter->addWidget(m_editor);
+    connect(m_editor, &CodeEditor::completionStatsChanged, this, [this](const QString &summary){
+        emit status("[AI] " + summary);
+    });
+    m_largeDoc = new LargeFileDocument(this);
+    m_largeView = new LargeFileView();
+    m_largeView->setDocument(m_largeDoc);
+    m_editorStack = new QStackedWidget();
+    m_editorStack->addWidget(m_editor);
+    m_editorStack->addWidget(m_largeView);
+
+    // Результаты поиска — под редактором, панель появляется по первому поиску
+    m_searchPanel = new SearchPanel();
+    m_searchPanel->hide();
+    auto editorSplitter = new QSplitter(Qt::Vertical);
+    editorSplitter->addWidget(m_editorStack);
+    editorSplitter->addWidget(m_searchPanel);
+    editorSplitter->setStretchFactor(0, 3);
+    editorSplitter->setStretchFactor(1, 1);
+    splitter->addWidget(editorSplitter);
     splitter->setStretchFactor(0, 1);
     splitter->setStretchFactor(1, 3);
+
+    connect(m_searchPanel, &SearchPanel::documentSearchRequested, this, &CodePanel::onSearchDocument);
+    connect(m_searchPanel, &SearchPanel::projectSearchRequested, this, [this]{ m_searchPanel->runInProject(m_fsModel->rootPath()); });
+    connect(m_searchPanel, &SearchPanel::hitActivated, this, &CodePanel::onSearchHitActivated);
 }
 
 void CodePanel::onSearchTextChanged(const QString &text) {
-    m_filterModel->setFilterString(text);
+    if (text.trimmed().isEmpty() || !m_fileIndex->isReady()) {
+        m_filterModel->setMatches(QString(), {});
+        return;
+    }
+    const QString root = m_fileIndex->root();
+    const QStringList matches = m_fileIndex->match(text, FilterMatchLimit);
+    m_filterModel->setMatches(root, matches);
+    // Раскрываем только предков совпадений; index(path) заодно запрашивает ещё не загруженные каталоги
+    QSet<QString> dirs;
+    for (const QString &path : matches) {
+        for (QString d = path.left(path.lastIndexOf('/')); d.size() > root.size() && !dirs.contains(d); d = d.left(d.lastIndexOf('/'))) {
+            dirs.insert(d);
+        }
+    }
+    for (const QString &d : std::as_const(dirs)) {
+        const QModelIndex idx = m_filterModel->mapFromSource(m_fsModel->index(d));
+        if (idx.isValid()) m_tree->expand(idx);
+    }
+}
+
+void CodePanel::onDirectoryLoaded(const QString &path) {
+    // Каталоги подгружаются лениво: раскрытие принятого каталога запросит его содержимое,
+    // так что совпадения в глубине появляются по цепочке, но только по их предкам
+    if (!m_filterModel->isActive()) return;
+    const QModelIndex parent = m_filterModel->mapFromSource(m_fsModel->index(path));
+    if (!parent.isValid()) return;
+    m_tree->expand(parent);
+    for (int r = 0; r < m_filterModel->rowCount(parent); ++r) m_tree->expand(m_filterModel->index(r, 0, parent));
 }
 
 void CodePanel::onTreeDoubleClicked(const QModelIndex &index) {
@@ -96,27 +157,76 @@ void CodePanel::onSaveAsFile() {
 }
 
 void CodePanel::onFindInFile() {
-    bool ok=false;
-    QString q = QInputDialog::getText(this, "Найти", "Текст для поиска:", QLineEdit::Normal, "", &ok);
-    if (!ok || q.isEmpty()) return;
-    QTextDocument::FindFlags flags;
-    m_editor->find(q, flags);
+    m_searchPanel->activate(false);
+}
+
+void CodePanel::onFindInProject() {
+    m_searchPanel->activate(true);
+}
+
+void CodePanel::onSearchDocument() {
+    if (m_largeMode) {
+        // Ищем по файлу на диске через отображение; несохранённые правки — поверх него по кускам документа
+        if (m_largeDoc->isModified()) m_searchPanel->runInEdited(m_currentPath, m_largeDoc->spans());
+        else m_searchPanel->runInFiles({m_currentPath});
+        return;
+    }
+    const QString label = m_currentPath.isEmpty() ? QString("Без имени") : QFileInfo(m_currentPath).fileName();
+    m_searchPanel->runInDocument(m_editor->toPlainText().toUtf8(), label);
+}
+
+void CodePanel::onSearchHitActivated(const QString &path, qint64 line, int column, int length) {
+    if (!path.isEmpty() && QFileInfo(path) != QFileInfo(m_currentPath)) loadFile(path);
+    if (m_largeMode) {
+        m_largeView->setCurrentLine(line);
+        m_largeView->setFocus();
+        return;
+    }
+    const QTextBlock block = m_editor->document()->findBlockByNumber(int(line));
+    if (!block.isValid()) return;
+    QTextCursor cursor(block);
+    cursor.setPosition(block.position() + qMin(column, block.length() - 1));
+    cursor.setPosition(qMin(block.position() + column + length, block.position() + block.length() - 1), QTextCursor::KeepAnchor);
+    m_editor->setTextCursor(cursor);
+    m_editor->centerCursor();
+    m_editor->setFocus();
 }
 
 void CodePanel::onAskAI() {
     // Open ai_agent.py as a helper window
-    QProcess::startDetached("python3", {QString::fromStdString(std::string(PYTHON_DIR) + "/ai_agent.py")});
+    ModelReceiver::launchAgent();
 }
 
 void CodePanel::loadFile(const QString &path) {
+    if (QFileInfo(path).size() >= LargeFileThreshold) {
+        // Без чтения в память: отображение открывается мгновенно, строки индексируются в фоне
+        QString error;
+        if (!m_largeDoc->open(path, &error)) { QMessageBox::warning(this, "Ошибка", "Не удалось открыть файл: " + error); return; }
+        m_editor->clear();
+        m_largeView->setDocument(m_largeDoc);
+        m_editorStack->setCurrentWidget(m_largeView);
+        m_largeMode = true;
+        m_currentPath = path;
+        return;
+    }
     QFile f(path);
     if (!f.open(QIODevice::ReadOnly)) { QMessageBox::warning(this, "Ошибка", "Не удалось открыть файл"); return; }
     m_editor->setPlainText(QString::fromUtf8(f.readAll()));
     f.close();
+    if (m_largeMode) {
+        m_largeDoc->close();
+        m_editorStack->setCurrentWidget(m_editor);
+        m_largeMode = false;
+    }
     m_currentPath = path;
 }
 
 bool CodePanel::saveToPath(const QString &path) {
+    if (m_largeMode) {
+        QString error;
+        if (!m_largeDoc->save(path, &error)) { QMessageBox::warning(this, "Ошибка", "Не удалось сохранить файл: " + error); return false; }
+        return true;
+    }
     QFile f(path);
     if (!f.open(QIODevice::WriteOnly)) { QMessageBox::warning(this, "Ошибка", "Не удалось сохранить файл"); return false; }
     auto data = m_editor->toPlainText().toUtf8();
@@ -9,35 +9,59 @@
 #include <QLabel>
 #include <QAction>
 #include <QProcess>
+#include <QStackedWidget>
+#include <QSet>
 #include "CodeEditor.hpp"
+#include "LargeFileDocument.hpp"
+#include "LargeFileView.hpp"
+#include "SearchPanel.hpp"
+#include "FileIndex.hpp"
 
+// Фильтр дерева по результатам FileIndex: принятые пути — совпадения и их предки,
+// проверка строки — один поиск в хэше, без обхода потомков и без подгрузки
+// лениво загружаемых каталогов QFileSystemModel.
 class FilenameFilterModel : public QSortFilterProxyModel {
     Q_OBJECT
 public:
     explicit FilenameFilterModel(QObject *parent=nullptr) : QSortFilterProxyModel(parent) {}
-    void setFilterString(const QString &s) { m_filter = s; invalidateFilter(); }
+    // matches — абсолютные пути под root; пустой root — фильтр снят
+    void setMatches(const QString &root, const QStringList &matches) {
+        m_root = root;
+        m_accepted.clear();
+        for (const QString &path : matches) {
+            for (QString p = path; p.size() > root.size() && !m_accepted.contains(p); p = p.left(p.lastIndexOf('/'))) {
+                m_accepted.insert(p);
+            }
+        }
+        invalidateFilter();
+    }
+    bool isActive() const { return !m_root.isEmpty(); }
 protected:
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override {
-        if (m_filter.trimmed().isEmpty()) return true;
+        if (m_root.isEmpty()) return true;
         QModelIndex idx = sourceModel()->index(source_row, 0, source_parent);
         if (!idx.isValid()) return true;
-        QString name = sourceModel()->data(idx, QFileSystemModel::FileNameRole).toString();
-        if (name.contains(m_filter, Qt::CaseInsensitive)) return true;
-        // Accept parents if any child matches
-        if (sourceModel()->hasChildren(idx)) {
-            int rows = sourceModel()->rowCount(idx);
-            for (int r=0;r<rows;++r) if (filterAcceptsRow(r, idx)) return true;
-        }
-        return false;
+        const QString path = sourceModel()->data(idx, QFileSystemModel::FilePathRole).toString();
+        // Корень и всё выше него оставляем — иначе пропадёт корневой индекс дерева
+        if (!path.startsWith(m_root + '/')) return true;
+        return m_accepted.contains(path);
     }
 private:
-    QString m_filter;
+    QString m_root;
+    QSet<QString> m_accepted;
 };
 
 class CodePanel : public QWidget {
     Q_OBJECT
 public:
+    // Сколько лучших совпадений фильтра показывать в дереве
+    static constexpr int FilterMatchLimit = 2000;
+    // Файлы больше этого открываются в режиме большого файла (отображение + построчные правки)
+    static constexpr qint64 LargeFileThreshold = 16ll * 1024 * 1024;
+
     explicit CodePanel(QWidget *parent=nullptr);
+signals:
+    void status(const QString &message);
 private slots:
     void onOpenSelected();
     void onTreeDoubleClicked(const QModelIndex &index);
@@ -46,8 +70,12 @@ private slots:
     void onSaveFile();
     void onSaveAsFile();
     void onSearchTextChanged(const QString &text);
+    void onDirectoryLoaded(const QString &path);
     void onAskAI();
     void onFindInFile();
+    void onFindInProject();
+    void onSearchDocument();
+    void onSearchHitActivated(const QString &path, qint64 line, int column, int length);
 private:
     void loadFile(const QString &path);
     bool saveToPath(const QString &path);
@@ -57,7 +85,13 @@ private:
     QTreeView *m_tree=nullptr;
     QFileSystemModel *m_fsModel=nullptr;
     FilenameFilterModel *m_filterModel=nullptr;
+    FileIndex *m_fileIndex=nullptr;
     CodeEditor *m_editor=nullptr;
+    QStackedWidget *m_editorStack=nullptr;
+    LargeFileDocument *m_largeDoc=nullptr;
+    LargeFileView *m_largeView=nullptr;
+    SearchPanel *m_searchPanel=nullptr;
+    bool m_largeMode=false;
     QString m_currentPath;
 };
 
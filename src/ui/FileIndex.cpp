@@ -0,0 +1,256 @@
+#include "FileIndex.hpp"
+#include <QDir>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <algorithm>
+
+namespace {
+// Изменения в каталогах приходят пачками (сборка, git checkout) — собираем их
+constexpr int kChangeDelayMs = 200;
+// Совпадение целиком в имени файла важнее совпадения, размазанного по пути
+constexpr int kNameBonus = 20;
+
+quint64 charBit(QChar c) {
+    return 1ull << (c.toLower().unicode() % 64);
+}
+
+quint64 maskOf(const QString &s) {
+    quint64 mask = 0;
+    for (QChar c : s) mask |= charBit(c);
+    return mask;
+}
+
+bool isWordStart(const QString &s, int i) {
+    if (i == 0) return true;
+    const QChar prev = s[i - 1];
+    if (prev == '/' || prev == '_' || prev == '-' || prev == '.' || prev == ' ') return true;
+    return prev.isLower() && s[i].isUpper();
+}
+
+// Жадно укладывает pattern в s начиная с from; -1 — не уложился
+int scoreFrom(const QString &s, int from, const QString &pattern) {
+    int score = 0;
+    int j = 0;
+    int prev = -2;
+    for (int i = from; i < s.size() && j < pattern.size(); ++i) {
+        if (s[i].toLower() != pattern[j]) continue;
+        score += 1;
+        if (i == prev + 1) score += 5;
+        if (i == from || isWordStart(s, i)) score += 3;
+        prev = i;
+        ++j;
+    }
+    if (j < pattern.size()) return -1;
+    // При прочих равных короткие пути выше
+    return std::max(0, score * 4 - int(s.size() - from) / 8);
+}
+
+struct WalkResult {
+    std::vector<FileIndex::Entry> entries;
+    QStringList dirs; // абсолютные пути найденных каталогов — под наблюдение
+};
+
+FileIndex::Entry makeEntry(const QString &relPath, bool isDir) {
+    FileIndex::Entry e;
+    e.path = relPath;
+    e.nameStart = int(relPath.lastIndexOf('/') + 1);
+    e.mask = maskOf(relPath);
+    e.isDir = isDir;
+    return e;
+}
+
+// Тот же набор, что показывает QFileSystemModel дерева: без скрытых, без ссылок
+const QDir::Filters kListFilter = QDir::AllEntries | QDir::NoDotAndDotDot | QDir::NoSymLinks;
+
+// Содержимое rel (относительно root); recursive — со всеми подкаталогами.
+WalkResult walk(const QString &root, const QString &rel, bool recursive,
+                const std::atomic<quint64> &generation, quint64 expected) {
+    WalkResult result;
+    std::vector<QString> stack{rel};
+    while (!stack.empty() && generation.load() == expected) {
+        const QString dirRel = stack.back();
+        stack.pop_back();
+        const QString dirAbs = dirRel.isEmpty() ? root : root + '/' + dirRel;
+        const QFileInfoList list = QDir(dirAbs).entryInfoList(kListFilter, QDir::Name);
+        for (const QFileInfo &fi : list) {
+            const QString childRel = dirRel.isEmpty() ? fi.fileName() : dirRel + '/' + fi.fileName();
+            result.entries.push_back(makeEntry(childRel, fi.isDir()));
+            if (fi.isDir()) {
+                result.dirs.push_back(fi.absoluteFilePath());
+                if (recursive) stack.push_back(childRel);
+            }
+        }
+    }
+    return result;
+}
+
+bool isUnder(const QString &path, const QString &dir) {
+    return dir.isEmpty() || (path.size() > dir.size() && path.startsWith(dir) && path[dir.size()] == '/');
+}
+
+QString parentOf(const FileIndex::Entry &e) {
+    return e.path.left(std::max(0, e.nameStart - 1));
+}
+}
+
+FileIndex::FileIndex(QObject *parent) : QObject(parent) {
+    m_pool.setMaxThreadCount(1);
+    m_changeTimer.setSingleShot(true);
+    m_changeTimer.setInterval(kChangeDelayMs);
+    connect(&m_changeTimer, &QTimer::timeout, this, &FileIndex::flushChanges);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &FileIndex::onDirectoryChanged);
+}
+
+FileIndex::~FileIndex() {
+    ++m_generation;
+    m_pool.waitForDone();
+}
+
+void FileIndex::setRoot(const QString &root) {
+    const quint64 generation = ++m_generation;
+    m_root = QDir::cleanPath(QFileInfo(root).absoluteFilePath());
+    m_ready = false;
+    m_entries.clear();
+    m_lastPattern.clear();
+    m_lastMatches.clear();
+    m_pendingDirs.clear();
+    if (!m_watcher.directories().isEmpty()) m_watcher.removePaths(m_watcher.directories());
+
+    const QString base = m_root;
+    m_pool.start([this, base, generation]{
+        WalkResult r = walk(base, QString(), true, m_generation, generation);
+        if (m_generation.load() != generation) return;
+        r.dirs.prepend(base);
+        QMetaObject::invokeMethod(this, [this, generation, r = std::move(r)]() mutable {
+            if (generation != m_generation) return;
+            watch(r.dirs);
+            merge(generation, QString(), std::move(r.entries), true);
+            m_ready = true;
+            emit ready(size());
+        }, Qt::QueuedConnection);
+    });
+}
+
+void FileIndex::watch(const QStringList &dirs) {
+    const int room = MaxWatchedDirs - int(m_watcher.directories().size());
+    if (room > 0) m_watcher.addPaths(dirs.mid(0, room));
+}
+
+void FileIndex::onDirectoryChanged(const QString &path) {
+    m_pendingDirs.insert(path);
+    m_changeTimer.start();
+}
+
+void FileIndex::flushChanges() {
+    const quint64 generation = m_generation;
+    for (const QString &abs : std::as_const(m_pendingDirs)) {
+        // Удалённый каталог уберёт пересмотр его родителя
+        if (!QFileInfo(abs).isDir()) continue;
+        const QString rel = abs == m_root ? QString() : QDir(m_root).relativeFilePath(abs);
+        if (rel.startsWith("..")) continue;
+        const QString base = m_root;
+        m_pool.start([this, base, rel, generation]{
+            WalkResult r = walk(base, rel, false, m_generation, generation);
+            if (m_generation.load() != generation) return;
+            QMetaObject::invokeMethod(this, [this, generation, rel, r = std::move(r)]() mutable {
+                merge(generation, rel, std::move(r.entries), false);
+            }, Qt::QueuedConnection);
+        });
+    }
+    m_pendingDirs.clear();
+}
+
+void FileIndex::merge(quint64 generation, const QString &dir, std::vector<Entry> entries, bool subtree) {
+    if (generation != m_generation) return;
+    if (subtree) {
+        // Полный обход dir заменяет всё, что под ним было
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                       [&](const Entry &e){ return isUnder(e.path, dir); }), m_entries.end());
+        m_entries.insert(m_entries.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+    } else {
+        // Пересмотр одного уровня: сравниваем прямых потомков
+        QSet<QString> fresh;
+        for (const Entry &e : entries) fresh.insert(e.path);
+        QSet<QString> known;
+        QStringList removed;
+        for (const Entry &e : m_entries) {
+            if (parentOf(e) != dir) continue;
+            known.insert(e.path);
+            if (!fresh.contains(e.path)) removed.push_back(e.path);
+        }
+        if (!removed.isEmpty()) {
+            m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [&](const Entry &e){
+                for (const QString &r : std::as_const(removed)) if (e.path == r || isUnder(e.path, r)) return true;
+                return false;
+            }), m_entries.end());
+            for (const QString &r : std::as_const(removed)) m_watcher.removePath(m_root + '/' + r);
+        }
+        for (Entry &e : entries) {
+            if (known.contains(e.path)) continue;
+            if (e.isDir) {
+                // Новый подкаталог обходим целиком в фоне
+                const QString base = m_root;
+                const QString rel = e.path;
+                m_pool.start([this, base, rel, generation]{
+                    WalkResult r = walk(base, rel, true, m_generation, generation);
+                    if (m_generation.load() != generation) return;
+                    r.dirs.prepend(base + '/' + rel);
+                    QMetaObject::invokeMethod(this, [this, generation, rel, r = std::move(r)]() mutable {
+                        if (generation != m_generation) return;
+                        watch(r.dirs);
+                        merge(generation, rel, std::move(r.entries), true);
+                    }, Qt::QueuedConnection);
+                });
+            }
+            m_entries.push_back(std::move(e));
+        }
+    }
+    // Индексы в кэше запроса больше не действительны
+    m_lastPattern.clear();
+    m_lastMatches.clear();
+    if (m_ready) emit changed();
+}
+
+int FileIndex::fuzzyScore(const QString &path, int nameStart, const QString &pattern) {
+    const int inName = scoreFrom(path, nameStart, pattern);
+    if (inName >= 0) return inName + kNameBonus;
+    return scoreFrom(path, 0, pattern);
+}
+
+QStringList FileIndex::match(const QString &pattern, int limit) {
+    QString p = pattern.trimmed().toLower();
+    p.remove(' ');
+    if (p.isEmpty()) return {};
+    const quint64 mask = maskOf(p);
+
+    // Подпоследовательность: совпадения продолжения — подмножество прошлых совпадений
+    const bool narrow = !m_lastPattern.isEmpty() && p.startsWith(m_lastPattern);
+    std::vector<std::pair<int, int>> scored; // (оценка, индекс)
+    auto consider = [&](int i) {
+        const Entry &e = m_entries[size_t(i)];
+        if ((e.mask & mask) != mask) return;
+        const int s = fuzzyScore(e.path, e.nameStart, p);
+        if (s >= 0) scored.emplace_back(s, i);
+    };
+    if (narrow) {
+        for (int i : m_lastMatches) consider(i);
+    } else {
+        for (int i = 0; i < size(); ++i) consider(i);
+    }
+
+    m_lastPattern = p;
+    m_lastMatches.clear();
+    m_lastMatches.reserve(scored.size());
+    for (const auto &s : scored) m_lastMatches.push_back(s.second);
+
+    const size_t top = std::min(scored.size(), size_t(std::max(0, limit)));
+    std::partial_sort(scored.begin(), scored.begin() + std::ptrdiff_t(top), scored.end(),
+                      [&](const auto &a, const auto &b) {
+        if (a.first != b.first) return a.first > b.first;
+        return m_entries[size_t(a.second)].path.size() < m_entries[size_t(b.second)].path.size();
+    });
+    QStringList result;
+    result.reserve(int(top));
+    for (size_t k = 0; k < top; ++k) result.push_back(m_root + '/' + m_entries[size_t(scored[k].second)].path);
+    return result;
+}
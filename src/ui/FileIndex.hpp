@@ -0,0 +1,70 @@
+#pragma once
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <vector>
+
+// Индекс имён файлов под корнем проекта для фильтра дерева.
+//
+// Обход выполняется один раз в фоне, дальше индекс поддерживается
+// QFileSystemWatcher'ом: изменившийся каталог пересматривается на один уровень,
+// новые подкаталоги обходятся в фоне. Запрос — нечёткий (символы запроса
+// подпоследовательностью в пути, с бонусами за подряд идущие символы и начала
+// слов), отвечается из памяти. Если запрос продолжает предыдущий, просматриваются
+// только прошлые совпадения — при наборе стоимость пропорциональна их числу.
+class FileIndex : public QObject {
+    Q_OBJECT
+public:
+    // Сколько каталогов ставим под наблюдение: у inotify ограничен лимит на пользователя
+    static constexpr int MaxWatchedDirs = 8192;
+
+    explicit FileIndex(QObject *parent=nullptr);
+    ~FileIndex() override;
+
+    void setRoot(const QString &root);
+    QString root() const { return m_root; }
+    bool isReady() const { return m_ready; }
+    int size() const { return int(m_entries.size()); }
+
+    // Абсолютные пути лучших limit совпадений, по убыванию оценки.
+    QStringList match(const QString &pattern, int limit);
+
+    // Оценка совпадения pattern (в нижнем регистре) с path; -1 — не совпадает.
+    static int fuzzyScore(const QString &path, int nameStart, const QString &pattern);
+
+signals:
+    void ready(int entries);
+    void changed();
+
+public:
+    struct Entry {
+        QString path;       // относительно корня, через '/'
+        quint64 mask = 0;   // какие символы встречаются — быстрый отсев
+        int nameStart = 0;  // начало имени в path
+        bool isDir = false;
+    };
+
+private:
+    void onDirectoryChanged(const QString &path);
+    void flushChanges();
+    void merge(quint64 generation, const QString &dir, std::vector<Entry> entries, bool subtree);
+    void watch(const QStringList &dirs);
+
+    QThreadPool m_pool; // один поток: обходы идут по очереди
+    std::atomic<quint64> m_generation{0};
+    QString m_root;
+    bool m_ready = false;
+    std::vector<Entry> m_entries;
+
+    QFileSystemWatcher m_watcher;
+    QSet<QString> m_pendingDirs;
+    QTimer m_changeTimer;
+
+    // Кэш последнего запроса для сужения при наборе
+    QString m_lastPattern;
+    std::vector<int> m_lastMatches;
+};
@@ -0,0 +1,122 @@
+#include "GameExporter.hpp"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+GameExporter::GameExporter(QObject *parent) : QObject(parent) {
+    m_proc = new QProcess(this);
+    m_proc->setProcessChannelMode(QProcess::MergedChannels);
+    connect(m_proc, &QProcess::readyReadStandardOutput, this, &GameExporter::onReadyOutput);
+    connect(m_proc, &QProcess::finished, this, &GameExporter::onProcessFinished);
+    connect(m_proc, &QProcess::errorOccurred, this, [this](QProcess::ProcessError err){
+        if (err == QProcess::FailedToStart && m_running) finish(false, "[BUILD] Не удалось запустить cmake.");
+    });
+}
+
+QString GameExporter::playerFileName() {
+#ifdef Q_OS_WIN
+    return "Player.exe";
+#else
+    return "Player";
+#endif
+}
+
+void GameExporter::start(const QByteArray &bakedScene, const QString &exportDir) {
+    if (m_running) return;
+    m_running = true;
+    m_scene = bakedScene;
+    m_exportDir = exportDir;
+    m_timer.start();
+
+    // 1) Готовый runtime, поставляемый вместе с редактором — сборка не нужна вообще
+    QString prebuilt = findPrebuiltPlayer();
+    if (!prebuilt.isEmpty()) {
+        emit log("[BUILD] Используется готовый Player: " + prebuilt);
+        deploy(prebuilt);
+        return;
+    }
+    // 2) Иначе — инкрементальная сборка в постоянном кэше
+    buildCachedPlayer();
+}
+
+QString GameExporter::findPrebuiltPlayer() const {
+    const QString path = QDir(QCoreApplication::applicationDirPath()).filePath(playerFileName());
+    QFileInfo fi(path);
+    return (fi.exists() && fi.isExecutable()) ? path : QString();
+}
+
+QString GameExporter::cachedBuildDir() const {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("PlayerBuild");
+}
+
+void GameExporter::buildCachedPlayer() {
+    const QString buildDir = cachedBuildDir();
+    QDir().mkpath(buildDir);
+    auto build = [this, buildDir]{
+        runStep({"--build", buildDir, "--target", "Player", "--config", "Release"}, [this, buildDir]{
+            deploy(QDir(buildDir).filePath(playerFileName()));
+        });
+    };
+    if (QFile::exists(QDir(buildDir).filePath("CMakeCache.txt"))) {
+        emit log("[BUILD] Кэш сборки найден, пересобираются только изменения: " + buildDir);
+        build();
+    } else {
+        emit log("[BUILD] Первая настройка кэша сборки: " + buildDir);
+        runStep({"-S", QString(SOURCE_DIR), "-B", buildDir, "-DCMAKE_BUILD_TYPE=Release"}, build);
+    }
+}
+
+void GameExporter::runStep(const QStringList &args, std::function<void()> onSuccess) {
+    m_onStepSuccess = std::move(onSuccess);
+    m_pending.clear();
+    emit log("[BUILD] cmake " + args.join(' '));
+    m_proc->start("cmake", args);
+}
+
+void GameExporter::onReadyOutput() {
+    m_pending += m_proc->readAllStandardOutput();
+    int nl;
+    while ((nl = m_pending.indexOf('\n')) >= 0) {
+        emit log(QString::fromLocal8Bit(m_pending.left(nl)).trimmed());
+        m_pending.remove(0, nl + 1);
+    }
+}
+
+void GameExporter::onProcessFinished(int exitCode, QProcess::ExitStatus status) {
+    if (!m_pending.isEmpty()) { emit log(QString::fromLocal8Bit(m_pending).trimmed()); m_pending.clear(); }
+    if (status != QProcess::NormalExit || exitCode != 0) {
+        finish(false, "[BUILD] Ошибка сборки Player. Убедитесь, что Qt6 установлен.");
+        return;
+    }
+    auto next = std::move(m_onStepSuccess);
+    m_onStepSuccess = nullptr;
+    if (next) next();
+}
+
+void GameExporter::deploy(const QString &playerBinary) {
+    QDir out(m_exportDir);
+    const QString dstPlayer = out.filePath(playerFileName());
+    QFile::remove(dstPlayer);
+    if (!QFile::copy(playerBinary, dstPlayer)) {
+        finish(false, "[BUILD] Не удалось скопировать Player в " + m_exportDir);
+        return;
+    }
+    QFile::setPermissions(dstPlayer, QFile::permissions(playerBinary));
+
+    QFile scene(out.filePath("game.scbin"));
+    if (!scene.open(QIODevice::WriteOnly) || scene.write(m_scene) != m_scene.size()) {
+        finish(false, "[BUILD] Не удалось записать сцену в " + m_exportDir);
+        return;
+    }
+    scene.close();
+    finish(true, QString("[BUILD] Готово за %1 с. В папке: %2").arg(m_timer.elapsed() / 1000.0, 0, 'f', 1).arg(m_exportDir));
+}
+
+void GameExporter::finish(bool ok, const QString &message) {
+    m_running = false;
+    m_scene.clear();
+    emit log(message);
+    emit finished(ok, m_exportDir);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <QObject>
+#include <QProcess>
+#include <QElapsedTimer>
+#include <functional>
+
+// Асинхронная сборка игры: готовый Player рядом с редактором (или инкрементально
+// собранный в кэше), сцена в бинарном формате Player, лог сборки стримится построчно.
+class GameExporter : public QObject {
+    Q_OBJECT
+public:
+    explicit GameExporter(QObject *parent=nullptr);
+    bool isRunning() const { return m_running; }
+    void start(const QByteArray &bakedScene, const QString &exportDir);
+signals:
+    void log(const QString &line);
+    void finished(bool ok, const QString &exportDir);
+private slots:
+    void onReadyOutput();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus status);
+private:
+    static QString playerFileName();
+    QString findPrebuiltPlayer() const;
+    QString cachedBuildDir() const;
+    void buildCachedPlayer();
+    void runStep(const QStringList &args, std::function<void()> onSuccess);
+    void deploy(const QString &playerBinary);
+    void finish(bool ok, const QString &message);
+
+    QProcess *m_proc=nullptr;
+    std::function<void()> m_onStepSuccess;
+    QByteArray m_scene;
+    QByteArray m_pending;
+    QString m_exportDir;
+    bool m_running=false;
+    QElapsedTimer m_timer;
+};
@@ -0,0 +1,62 @@
+#include "InspectorBinding.hpp"
+#include <algorithm>
+
+InspectorBinding::InspectorBinding(SceneStore *store, QObject *parent) : QObject(parent), m_store(store) {
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &InspectorBinding::flush);
+}
+
+void InspectorBinding::bind(QDoubleSpinBox *spin, Field field) {
+    m_bindings.push_back({spin, field});
+    connect(spin, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [this, field](double v){
+        if (m_syncing || !target()) return;
+        set(field, static_cast<float>(v));
+    });
+}
+
+void InspectorBinding::setTarget(Entity entity) {
+    flush();
+    m_target = entity;
+    refresh();
+}
+
+void InspectorBinding::set(Field field, float value) {
+    if (!target()) return;
+    auto it = std::find_if(m_pending.begin(), m_pending.end(), [field](const Pending &p){ return p.field == field; });
+    if (it != m_pending.end()) it->value = value;
+    else m_pending.push_back({field, value});
+
+    m_syncing = true;
+    for (const Binding &b : m_bindings) {
+        if (b.field == field && b.spin->value() != value) b.spin->setValue(value);
+    }
+    m_syncing = false;
+    schedule();
+}
+
+void InspectorBinding::refresh() {
+    if (!target()) return;
+    m_syncing = true;
+    for (const Binding &b : m_bindings) b.spin->setValue(m_store->field(m_target, b.field));
+    m_syncing = false;
+}
+
+void InspectorBinding::schedule() {
+    if (m_timer.isActive()) return;
+    // Первая правка после паузы применяется на ближайшем проходе цикла событий,
+    // следующие — не раньше, чем через кадр после предыдущей пачки
+    const qint64 since = m_sinceFlush.isValid() ? m_sinceFlush.elapsed() : FrameIntervalMs;
+    m_timer.start(static_cast<int>(std::max<qint64>(0, FrameIntervalMs - since)));
+}
+
+void InspectorBinding::flush() {
+    m_timer.stop();
+    if (!target() || m_pending.empty()) {
+        m_pending.clear();
+        return;
+    }
+    for (const Pending &p : m_pending) m_store->field(m_target, p.field) = p.value;
+    m_pending.clear();
+    m_sinceFlush.restart();
+    emit applied(m_target);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <QObject>
+#include <QDoubleSpinBox>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <vector>
+#include "core/SceneStore.hpp"
+
+// Привязка полей инспектора к сущности SceneStore. Правки (из полей или
+// программные) копятся и применяются пачкой не чаще раза за кадр: applied —
+// одна перерисовка на пачку, в ней TransformHierarchy один раз пересчитывает матрицы.
+class InspectorBinding : public QObject {
+    Q_OBJECT
+public:
+    using Field = SceneField;
+    static constexpr int FrameIntervalMs = 16;
+
+    explicit InspectorBinding(SceneStore *store, QObject *parent=nullptr);
+
+    void bind(QDoubleSpinBox *spin, Field field);
+    // Отложенные правки уходят прежней цели, затем поля показывают новую.
+    // Правки для удалённой к тому времени сущности отбрасываются.
+    void setTarget(Entity entity);
+    Entity target() const { return m_store->alive(m_target) ? m_target : Entity{}; }
+
+    // Программная правка; поле ввода, если привязано, обновляется без обратного сигнала
+    void set(Field field, float value);
+    // Перечитать цель в поля — после правок в обход привязки (перетаскивание во вьюпорте)
+    void refresh();
+    void flush();
+
+signals:
+    void applied(Entity entity);
+
+private:
+    struct Binding {
+        QDoubleSpinBox *spin;
+        Field field;
+    };
+    struct Pending {
+        Field field;
+        float value;
+    };
+
+    void schedule();
+
+    SceneStore *m_store;
+    std::vector<Binding> m_bindings;
+    std::vector<Pending> m_pending;
+    Entity m_target;
+    bool m_syncing = false; // поля заполняются из цели — их valueChanged не правки
+    QTimer m_timer;
+    QElapsedTimer m_sinceFlush;
+};
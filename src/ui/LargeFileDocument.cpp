@@ -0,0 +1,311 @@
+#include "LargeFileDocument.hpp"
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Порция сканирования: после каждой индекс публикуется и шлётся прогресс
+constexpr qint64 kScanChunk = 8 << 20;
+// Запись исходных диапазонов при сохранении
+constexpr qint64 kWriteChunk = 64 << 20;
+}
+
+LargeFileDocument::LargeFileDocument(QObject *parent) : QObject(parent) {}
+
+LargeFileDocument::~LargeFileDocument() {
+    close();
+}
+
+bool LargeFileDocument::open(const QString &path, QString *error) {
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (error) *error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size > 0) {
+        m_data = m_file.map(0, m_size);
+        if (!m_data) {
+            if (error) *error = m_file.errorString();
+            m_file.close();
+            return false;
+        }
+    }
+    m_checkpoints.assign(1, 0);
+    m_scannedLines = 0;
+    m_cancel = false;
+    const quint64 generation = ++m_generation;
+    m_indexer = QThread::create([this, generation]{ buildIndex(generation); });
+    m_indexer->start(QThread::LowPriority);
+    return true;
+}
+
+void LargeFileDocument::close() {
+    if (m_indexer) {
+        m_cancel = true;
+        m_indexer->wait();
+        delete m_indexer;
+        m_indexer = nullptr;
+    }
+    if (m_data) m_file.unmap(const_cast<uchar*>(m_data));
+    m_data = nullptr;
+    m_file.close();
+    m_size = 0;
+    m_checkpoints.clear();
+    m_scannedLines = 0;
+    m_indexed = false;
+    m_originalLines = 0;
+    m_pieces.clear();
+    m_added.clear();
+    m_lineCount = 0;
+    m_newline = "\n";
+    m_modified = false;
+}
+
+void LargeFileDocument::buildIndex(quint64 generation) {
+    std::vector<qint64> local;
+    qint64 lines = 0;
+    qint64 pos = 0;
+    while (pos < m_size && !m_cancel.load()) {
+        const qint64 end = std::min(m_size, pos + kScanChunk);
+        const uchar *p = m_data + pos;
+        const uchar *e = m_data + end;
+        while (p < e) {
+            // memchr в libc векторизован — это и есть быстрый путь по гигабайтам
+            const void *hit = std::memchr(p, '\n', static_cast<size_t>(e - p));
+            if (!hit) break;
+            p = static_cast<const uchar*>(hit) + 1;
+            if (++lines % CheckpointStride == 0) local.push_back(p - m_data);
+        }
+        {
+            QMutexLocker lock(&m_indexMutex);
+            m_checkpoints.insert(m_checkpoints.end(), local.begin(), local.end());
+        }
+        local.clear();
+        m_scannedLines = lines;
+        pos = end;
+        QMetaObject::invokeMethod(this, [this, generation, lines, end]{
+            if (generation == m_generation) emit indexProgress(lines, end);
+        }, Qt::QueuedConnection);
+    }
+    if (m_cancel.load()) return;
+    QMetaObject::invokeMethod(this, [this, generation]{ onIndexFinished(generation); }, Qt::QueuedConnection);
+}
+
+void LargeFileDocument::onIndexFinished(quint64 generation) {
+    if (generation != m_generation || !m_indexer) return; // файл закрыли/переоткрыли, пока событие шло
+    // Последняя строка — после последнего '\n' (может быть пустой)
+    m_originalLines = m_scannedLines.load() + 1;
+    m_pieces.assign(1, Piece{false, 0, m_originalLines});
+    m_lineCount = m_originalLines;
+    if (m_size > 0) {
+        const qint64 end = originalLineEnd(0);
+        if (end < m_size && m_data[end] == '\r') m_newline = "\r\n";
+    }
+    m_indexed = true;
+    emit indexFinished(m_lineCount);
+}
+
+qint64 LargeFileDocument::lineCount() const {
+    return m_indexed ? m_lineCount : m_scannedLines.load();
+}
+
+qint64 LargeFileDocument::originalLineStart(qint64 line) const {
+    qint64 pos;
+    {
+        QMutexLocker lock(&m_indexMutex);
+        pos = m_checkpoints[static_cast<size_t>(line / CheckpointStride)];
+    }
+    for (qint64 k = line % CheckpointStride; k > 0; --k) {
+        const void *hit = std::memchr(m_data + pos, '\n', static_cast<size_t>(m_size - pos));
+        if (!hit) return m_size;
+        pos = static_cast<const uchar*>(hit) - m_data + 1;
+    }
+    return pos;
+}
+
+qint64 LargeFileDocument::originalLineEnd(qint64 line) const {
+    const qint64 start = originalLineStart(line);
+    if (start >= m_size) return m_size;
+    const void *hit = std::memchr(m_data + start, '\n', static_cast<size_t>(m_size - start));
+    qint64 end = hit ? static_cast<const uchar*>(hit) - m_data : m_size;
+    if (end > start && m_data[end - 1] == '\r') --end;
+    return end;
+}
+
+QByteArray LargeFileDocument::originalLine(qint64 line) const {
+    const qint64 start = originalLineStart(line);
+    const qint64 end = originalLineEnd(line);
+    return QByteArray(reinterpret_cast<const char*>(m_data + start), end - start);
+}
+
+QByteArray LargeFileDocument::lineBytes(qint64 line) const {
+    if (line < 0 || line >= lineCount()) return QByteArray();
+    if (!m_indexed) return originalLine(line);
+    qint64 acc = 0;
+    for (const Piece &p : m_pieces) {
+        if (line < acc + p.count) {
+            const qint64 k = p.first + (line - acc);
+            return p.added ? m_added[static_cast<size_t>(k)] : originalLine(k);
+        }
+        acc += p.count;
+    }
+    return QByteArray();
+}
+
+std::vector<LargeFileDocument::Span> LargeFileDocument::spans() const {
+    std::vector<Span> out;
+    if (!m_indexed) {
+        out.push_back(Span{0, lineCount(), 0, {}});
+        return out;
+    }
+    out.reserve(m_pieces.size());
+    qint64 acc = 0;
+    for (const Piece &p : m_pieces) {
+        if (p.count == 0) continue;
+        Span s{acc, p.count, -1, {}};
+        if (p.added) {
+            // QByteArray разделяемые — копия строк без копирования данных
+            s.added.assign(m_added.begin() + p.first, m_added.begin() + p.first + p.count);
+        } else {
+            s.original = p.first;
+        }
+        out.push_back(std::move(s));
+        acc += p.count;
+    }
+    return out;
+}
+
+size_t LargeFileDocument::splitAt(qint64 line) {
+    qint64 acc = 0;
+    for (size_t k = 0; k < m_pieces.size(); ++k) {
+        Piece &p = m_pieces[k];
+        if (line == acc) return k;
+        if (line < acc + p.count) {
+            const qint64 head = line - acc;
+            const Piece tail{p.added, p.first + head, p.count - head};
+            p.count = head;
+            m_pieces.insert(m_pieces.begin() + static_cast<std::ptrdiff_t>(k) + 1, tail);
+            return k + 1;
+        }
+        acc += p.count;
+    }
+    return m_pieces.size();
+}
+
+bool LargeFileDocument::insertLine(qint64 line, const QString &text) {
+    if (!m_indexed || line < 0 || line > m_lineCount) return false;
+    const size_t k = splitAt(line);
+    m_added.push_back(text.toUtf8());
+    const qint64 index = static_cast<qint64>(m_added.size()) - 1;
+    // Подряд набранные строки продолжают предыдущий добавленный кусок
+    if (k > 0 && m_pieces[k - 1].added && m_pieces[k - 1].first + m_pieces[k - 1].count == index) {
+        ++m_pieces[k - 1].count;
+    } else {
+        m_pieces.insert(m_pieces.begin() + static_cast<std::ptrdiff_t>(k), Piece{true, index, 1});
+    }
+    ++m_lineCount;
+    m_modified = true;
+    emit changed();
+    return true;
+}
+
+bool LargeFileDocument::removeLine(qint64 line) {
+    if (!m_indexed || line < 0 || line >= m_lineCount || m_lineCount == 1) return false;
+    const size_t k = splitAt(line);
+    splitAt(line + 1);
+    m_pieces.erase(m_pieces.begin() + static_cast<std::ptrdiff_t>(k));
+    --m_lineCount;
+    m_modified = true;
+    emit changed();
+    return true;
+}
+
+bool LargeFileDocument::replaceLine(qint64 line, const QString &text) {
+    if (!m_indexed || line < 0 || line >= m_lineCount) return false;
+    const size_t k = splitAt(line);
+    splitAt(line + 1);
+    m_added.push_back(text.toUtf8());
+    m_pieces[k] = Piece{true, static_cast<qint64>(m_added.size()) - 1, 1};
+    m_modified = true;
+    emit changed();
+    return true;
+}
+
+bool LargeFileDocument::save(const QString &path, QString *error) {
+    if (!m_indexed) {
+        if (error) *error = "Индекс строк ещё строится";
+        return false;
+    }
+    QSaveFile out(path);
+    if (!out.open(QIODevice::WriteOnly)) {
+        if (error) *error = out.errorString();
+        return false;
+    }
+    auto writeRange = [&](qint64 a, qint64 b) {
+        for (qint64 pos = a; pos < b; pos += kWriteChunk) {
+            out.write(reinterpret_cast<const char*>(m_data + pos), std::min(kWriteChunk, b - pos));
+        }
+    };
+    for (size_t k = 0; k < m_pieces.size(); ++k) {
+        const Piece &p = m_pieces[k];
+        const bool lastPiece = k + 1 == m_pieces.size();
+        if (p.count == 0) continue;
+        if (p.added) {
+            for (qint64 j = 0; j < p.count; ++j) {
+                out.write(m_added[static_cast<size_t>(p.first + j)]);
+                if (!(lastPiece && j + 1 == p.count)) out.write(m_newline);
+            }
+            continue;
+        }
+        // Исходный диапазон строк — один непрерывный кусок файла вместе с переводами строк
+        const qint64 endLine = p.first + p.count;
+        const qint64 a = originalLineStart(p.first);
+        if (endLine < m_originalLines) {
+            writeRange(a, lastPiece ? originalLineEnd(endLine - 1) : originalLineStart(endLine));
+        } else {
+            writeRange(a, m_size);
+            if (!lastPiece) out.write(m_newline);
+        }
+    }
+
+    // Пишем поверх отображённого файла — отпускаем только отображение: таблица
+    // кусков держит все правки и нужна, пока подмена не удалась
+    const bool samePath = QFileInfo(path).canonicalFilePath() == QFileInfo(m_file.fileName()).canonicalFilePath();
+    if (samePath) {
+        if (m_data) m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+        m_file.close();
+    }
+    const bool ok = out.commit();
+    if (!ok && error) *error = out.errorString();
+    if (!samePath) return ok;
+    if (ok) {
+        open(path);
+        return true;
+    }
+    // Подмена не удалась — исходный файл цел: отображаем его снова, правки остаются
+    if (!remap()) {
+        if (error) *error += "; файл не удалось открыть заново: " + m_file.errorString();
+        close();
+    }
+    return false;
+}
+
+bool LargeFileDocument::remap() {
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+    if (m_file.size() != m_size) {
+        m_file.close();
+        return false;
+    }
+    if (m_size > 0) {
+        m_data = m_file.map(0, m_size);
+        if (!m_data) {
+            m_file.close();
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <QObject>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+// Большой файл без загрузки в память: отображение через QFile::map, индекс строк
+// строится в фоне, правки копятся в таблице кусков (по строкам) и пишутся при сохранении.
+//
+// Индекс разреженный: смещение хранится для каждой CheckpointStride-й строки,
+// начало остальных находится memchr'ом от ближайшей контрольной точки.
+class LargeFileDocument : public QObject {
+    Q_OBJECT
+public:
+    static constexpr qint64 CheckpointStride = 64;
+
+    explicit LargeFileDocument(QObject *parent=nullptr);
+    ~LargeFileDocument() override;
+
+    bool open(const QString &path, QString *error=nullptr);
+    void close();
+    QString path() const { return m_file.fileName(); }
+    qint64 fileSize() const { return m_size; }
+
+    // Пока индекс строится, доступны только уже найденные строки; править нельзя.
+    bool isIndexed() const { return m_indexed; }
+    qint64 lineCount() const;
+    QByteArray lineBytes(qint64 line) const;
+    QString line(qint64 line) const { return QString::fromUtf8(lineBytes(line)); }
+
+    bool isModified() const { return m_modified; }
+    bool replaceLine(qint64 line, const QString &text);
+    bool insertLine(qint64 line, const QString &text);
+    bool removeLine(qint64 line);
+
+    // Исходные строки копируются из отображения целыми диапазонами.
+    bool save(const QString &path, QString *error=nullptr);
+
+    // Документ кусками — для поиска в фоне с учётом несохранённых правок:
+    // исходные строки задаются номерами в файле, добавленные копируются.
+    struct Span {
+        qint64 line = 0;      // первая строка куска в документе
+        qint64 count = 0;
+        qint64 original = -1; // первая строка куска в файле; -1 — строки в added
+        std::vector<QByteArray> added;
+    };
+    std::vector<Span> spans() const;
+
+signals:
+    void indexProgress(qint64 lines, qint64 bytesScanned);
+    void indexFinished(qint64 lines);
+    void changed();
+
+private:
+    // Кусок: added=false — строки исходного файла [first, first+count),
+    // added=true — строки m_added[first, first+count).
+    struct Piece {
+        bool added;
+        qint64 first;
+        qint64 count;
+    };
+
+    void buildIndex(quint64 generation);
+    void onIndexFinished(quint64 generation);
+    qint64 originalLineStart(qint64 line) const;
+    qint64 originalLineEnd(qint64 line) const; // без перевода строки
+    // Делит кусок так, чтобы строка line начинала кусок; возвращает его индекс.
+    size_t splitAt(qint64 line);
+    QByteArray originalLine(qint64 line) const;
+    // Снова отображает m_file после неудачного сохранения поверх него; индекс и куски не трогает
+    bool remap();
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+
+    mutable QMutex m_indexMutex;
+    std::vector<qint64> m_checkpoints;      // начало строк 0, Stride, 2*Stride, ...
+    std::atomic<qint64> m_scannedLines{0};  // полных строк найдено
+    std::atomic<bool> m_cancel{false};
+    QThread *m_indexer = nullptr;
+    bool m_indexed = false;
+    qint64 m_originalLines = 0;
+    quint64 m_generation = 0; // отсекает события индексатора от ранее открытого файла
+
+    std::vector<Piece> m_pieces;
+    std::vector<QByteArray> m_added;
+    qint64 m_lineCount = 0;
+    QByteArray m_newline = "\n";
+    bool m_modified = false;
+};
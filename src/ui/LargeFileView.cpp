@@ -0,0 +1,209 @@
+#include "LargeFileView.hpp"
+#include <QApplication>
+#include <QClipboard>
+#include <QFontDatabase>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <climits>
+
+namespace {
+// Очень длинные строки (минифицированные файлы) рисуются не целиком
+constexpr int kMaxDisplayColumns = 4096;
+}
+
+LargeFileView::LargeFileView(QWidget *parent) : QAbstractScrollArea(parent) {
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setFocusPolicy(Qt::StrongFocus);
+    viewport()->setCursor(Qt::IBeamCursor);
+    m_lineEdit = new QLineEdit(viewport());
+    m_lineEdit->setFrame(false);
+    m_lineEdit->hide();
+    m_lineEdit->installEventFilter(this);
+    connect(m_lineEdit, &QLineEdit::returnPressed, this, &LargeFileView::commitEdit);
+}
+
+void LargeFileView::setDocument(LargeFileDocument *doc) {
+    if (m_doc) m_doc->disconnect(this);
+    cancelEdit();
+    m_doc = doc;
+    m_current = 0;
+    m_maxColumns = 0;
+    if (m_doc) {
+        connect(m_doc, &LargeFileDocument::indexProgress, this, [this]{ updateScrollBars(); viewport()->update(); });
+        connect(m_doc, &LargeFileDocument::indexFinished, this, [this]{ updateScrollBars(); viewport()->update(); });
+        connect(m_doc, &LargeFileDocument::changed, this, [this]{ updateScrollBars(); viewport()->update(); });
+    }
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    updateScrollBars();
+    viewport()->update();
+}
+
+int LargeFileView::lineHeight() const {
+    return fontMetrics().lineSpacing();
+}
+
+int LargeFileView::gutterWidth() const {
+    const qint64 lines = m_doc ? qMax<qint64>(1, m_doc->lineCount()) : 1;
+    return 10 + fontMetrics().horizontalAdvance(QLatin1Char('9')) * int(QString::number(lines).size());
+}
+
+int LargeFileView::visibleLineCount() const {
+    return qMax(1, viewport()->height() / lineHeight());
+}
+
+qint64 LargeFileView::lineAt(int y) const {
+    return verticalScrollBar()->value() + y / lineHeight();
+}
+
+void LargeFileView::updateScrollBars() {
+    const qint64 lines = m_doc ? m_doc->lineCount() : 0;
+    // Диапазон полосы прокрутки — int; файлов больше 2^31 строк не ждём
+    const int maxTop = int(qBound<qint64>(0, lines - visibleLineCount(), INT_MAX));
+    verticalScrollBar()->setRange(0, maxTop);
+    verticalScrollBar()->setPageStep(visibleLineCount());
+    verticalScrollBar()->setSingleStep(1);
+    const int charWidth = fontMetrics().horizontalAdvance(QLatin1Char('M'));
+    horizontalScrollBar()->setRange(0, qMax(0, m_maxColumns * charWidth - (viewport()->width() - gutterWidth())));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(charWidth * 4);
+}
+
+void LargeFileView::setCurrentLine(qint64 line) {
+    if (!m_doc) return;
+    m_current = qBound<qint64>(0, line, qMax<qint64>(0, m_doc->lineCount() - 1));
+    const qint64 top = verticalScrollBar()->value();
+    if (m_current < top) verticalScrollBar()->setValue(int(m_current));
+    else if (m_current >= top + visibleLineCount()) verticalScrollBar()->setValue(int(m_current - visibleLineCount() + 1));
+    viewport()->update();
+}
+
+void LargeFileView::paintEvent(QPaintEvent *) {
+    QPainter p(viewport());
+    p.fillRect(viewport()->rect(), QColor("#1e1e1e"));
+    const int gutter = gutterWidth();
+    p.fillRect(QRect(0, 0, gutter - 4, viewport()->height()), QColor("#2d2d2d"));
+    if (!m_doc) return;
+
+    const int lh = lineHeight();
+    const int ascent = fontMetrics().ascent();
+    const int dx = horizontalScrollBar()->value();
+    const qint64 first = verticalScrollBar()->value();
+    const qint64 last = qMin(m_doc->lineCount(), first + visibleLineCount() + 1);
+    int widest = m_maxColumns;
+    for (qint64 line = first; line < last; ++line) {
+        const int y = int(line - first) * lh;
+        if (line == m_current) p.fillRect(QRect(gutter - 4, y, viewport()->width(), lh), QColor("#3c3c3c"));
+        p.setPen(Qt::lightGray);
+        p.drawText(QRect(0, y, gutter - 9, lh), Qt::AlignRight | Qt::AlignVCenter, QString::number(line + 1));
+
+        QString text = m_doc->line(line);
+        if (text.size() > kMaxDisplayColumns) text.truncate(kMaxDisplayColumns);
+        text.replace(QLatin1Char('\t'), QLatin1String("    "));
+        widest = qMax(widest, int(text.size()));
+        p.setClipRect(QRect(gutter, 0, viewport()->width() - gutter, viewport()->height()));
+        p.setPen(QColor("#dcdcdc"));
+        p.drawText(gutter - dx, y + ascent, text);
+        p.setClipping(false);
+    }
+    if (widest != m_maxColumns) {
+        m_maxColumns = widest;
+        updateScrollBars();
+    }
+    if (!m_doc->isIndexed()) {
+        p.setPen(QColor(200, 200, 200, 160));
+        p.drawText(viewport()->rect().adjusted(0, 0, -8, -4), Qt::AlignRight | Qt::AlignBottom,
+                   QString("Индексация… %1 строк").arg(m_doc->lineCount()));
+    }
+}
+
+void LargeFileView::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void LargeFileView::scrollContentsBy(int, int) {
+    cancelEdit();
+    viewport()->update();
+}
+
+void LargeFileView::keyPressEvent(QKeyEvent *e) {
+    if (!m_doc) return;
+    const bool ctrl = e->modifiers() & Qt::ControlModifier;
+    switch (e->key()) {
+    case Qt::Key_Up: setCurrentLine(m_current - 1); return;
+    case Qt::Key_Down: setCurrentLine(m_current + 1); return;
+    case Qt::Key_PageUp: setCurrentLine(m_current - visibleLineCount()); return;
+    case Qt::Key_PageDown: setCurrentLine(m_current + visibleLineCount()); return;
+    case Qt::Key_Home: if (ctrl) setCurrentLine(0); return;
+    case Qt::Key_End: if (ctrl) setCurrentLine(m_doc->lineCount() - 1); return;
+    case Qt::Key_F2: beginEdit(m_current, false); return;
+    case Qt::Key_Return:
+    case Qt::Key_Enter: beginEdit(m_current, ctrl); return;
+    default: break;
+    }
+    if (ctrl && (e->modifiers() & Qt::ShiftModifier) && e->key() == Qt::Key_K) {
+        if (m_doc->removeLine(m_current)) setCurrentLine(m_current);
+        return;
+    }
+    if (e->matches(QKeySequence::Copy)) {
+        QApplication::clipboard()->setText(m_doc->line(m_current));
+        return;
+    }
+    QAbstractScrollArea::keyPressEvent(e);
+}
+
+void LargeFileView::mousePressEvent(QMouseEvent *e) {
+    setCurrentLine(lineAt(int(e->position().y())));
+}
+
+void LargeFileView::mouseDoubleClickEvent(QMouseEvent *e) {
+    setCurrentLine(lineAt(int(e->position().y())));
+    beginEdit(m_current, false);
+}
+
+void LargeFileView::beginEdit(qint64 line, bool insertBelow) {
+    if (!m_doc || !m_doc->isIndexed()) return; // пока индекс строится — только просмотр
+    const qint64 target = insertBelow ? line + 1 : line;
+    // Прокрутка зовёт cancelEdit() — строку показываем до того, как правка началась
+    if (insertBelow) setCurrentLine(target);
+    m_editInserts = insertBelow;
+    m_editLine = target;
+    const int y = int(m_editLine - verticalScrollBar()->value()) * lineHeight();
+    const int gutter = gutterWidth();
+    m_lineEdit->setGeometry(gutter, y, viewport()->width() - gutter, lineHeight());
+    m_lineEdit->setText(insertBelow ? QString() : m_doc->line(m_editLine));
+    m_lineEdit->show();
+    m_lineEdit->setFocus();
+}
+
+void LargeFileView::commitEdit() {
+    if (m_editLine < 0) return;
+    const qint64 line = m_editLine;
+    const bool inserts = m_editInserts;
+    const QString text = m_lineEdit->text();
+    cancelEdit();
+    if (inserts) m_doc->insertLine(line, text); else m_doc->replaceLine(line, text);
+    setCurrentLine(line);
+}
+
+void LargeFileView::cancelEdit() {
+    if (m_editLine < 0) return;
+    m_editLine = -1;
+    // Фокус возвращаем, только если он был у поля правки (а не ушёл в другой виджет)
+    const bool hadFocus = m_lineEdit->hasFocus();
+    m_lineEdit->hide();
+    if (hadFocus) setFocus();
+}
+
+bool LargeFileView::eventFilter(QObject *watched, QEvent *event) {
+    if (watched == m_lineEdit) {
+        if (event->type() == QEvent::KeyPress && static_cast<QKeyEvent*>(event)->key() == Qt::Key_Escape) {
+            cancelEdit();
+            return true;
+        }
+        if (event->type() == QEvent::FocusOut) cancelEdit();
+    }
+    return QAbstractScrollArea::eventFilter(watched, event);
+}
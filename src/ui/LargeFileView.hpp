@@ -0,0 +1,44 @@
+#pragma once
+#include <QAbstractScrollArea>
+#include <QLineEdit>
+#include "LargeFileDocument.hpp"
+
+// Виртуализированный просмотр LargeFileDocument: рисуются только видимые строки,
+// вертикальная прокрутка — по номеру строки. Правка построчная:
+// Enter/F2/двойной клик — редактировать строку, Ctrl+Enter — вставить строку ниже,
+// Ctrl+Shift+K — удалить строку, Ctrl+C — копировать строку.
+class LargeFileView : public QAbstractScrollArea {
+    Q_OBJECT
+public:
+    explicit LargeFileView(QWidget *parent=nullptr);
+    void setDocument(LargeFileDocument *doc);
+    LargeFileDocument *document() const { return m_doc; }
+    qint64 currentLine() const { return m_current; }
+    void setCurrentLine(qint64 line);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void updateScrollBars();
+    int lineHeight() const;
+    int gutterWidth() const;
+    int visibleLineCount() const;
+    qint64 lineAt(int y) const;
+    void beginEdit(qint64 line, bool insertBelow);
+    void commitEdit();
+    void cancelEdit();
+
+    LargeFileDocument *m_doc=nullptr;
+    qint64 m_current = 0;
+    int m_maxColumns = 0; // самая длинная из виденных строк — для горизонтальной прокрутки
+    QLineEdit *m_lineEdit=nullptr;
+    qint64 m_editLine = -1;
+    bool m_editInserts = false;
+};
@@ -1,6 +1,9 @@
 // src/ui/MainWindow.cpp
 #include "MainWindow.hpp"
 #include "CodeEditor.hpp"
+#include "core/Engine3D.hpp"
+#include "core/SceneBinary.hpp"
+#include "core/SceneBaker.hpp"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QSplitter>
@@ -31,139 +34,14 @@
 #include <QColorDialog>
 #include <QPushButton>
 #include <QShortcut>
+#include <QInputDialog>
 #include <QKeyEvent>
+#include <limits>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// === Реализация SceneObject ===
-
-SceneObject::SceneObject(const std::string& objData, const std::string& objName)
-    : name(objName) {
-    loadFromObj(objData);
-}
-
-void SceneObject::loadFromObj(const std::string& objData) {
-    vertices.clear();
-    faces.clear();
-
-    std::istringstream iss(objData);
-    std::string line;
-
-    while (std::getline(iss, line)) {
-        std::istringstream lineStream(line);
-        std::string type;
-        lineStream >> type;
-
-        if (type == "v") {
-            float x, y, z;
-            lineStream >> x >> y >> z;
-            vertices.push_back({x, y, z});
-        } else if (type == "f") {
-            std::vector<int> face;
-            std::string vertex;
-            while (lineStream >> vertex) {
-                size_t first_slash = vertex.find('/');
-                std::string index_str = vertex.substr(0, first_slash);
-                try {
-                    int idx = std::stoi(index_str) - 1;
-                    if (idx >= 0 && idx < vertices.size()) {
-                        face.push_back(idx);
-                    }
-                } catch (...) { continue; }
-            }
-            if (face.size() >= 3) {
-                Face f;
-                f.indices = face;
-                faces.push_back(f);
-            }
-        }
-    }
-}
-
-void SceneObject::draw() {
-    glPushMatrix();
-    glTranslatef(x, y, z);
-    glRotatef(rx, 1.0f, 0.0f, 0.0f);
-    glRotatef(ry, 0.0f, 1.0f, 0.0f);
-    glRotatef(rz, 0.0f, 0.0f, 1.0f);
-    glScalef(sx, sy, sz);
-
-    glDisable(GL_COLOR_MATERIAL);
-    glEnable(GL_LIGHTING);
-    glEnable(GL_NORMALIZE);
-    glColor3f(r, g, b);
-    glBegin(GL_TRIANGLES);
-    for (const auto& face : faces) {
-        if (face.indices.size() < 3) continue;
-        for (size_t i = 1; i + 1 < face.indices.size(); ++i) {
-            int v0 = face.indices[0];
-            int v1 = face.indices[i];
-            int v2 = face.indices[i + 1];
-            // Нормаль треугольника
-            float ax = vertices[v1].x - vertices[v0].x;
-            float ay = vertices[v1].y - vertices[v0].y;
-            float az = vertices[v1].z - vertices[v0].z;
-            float bx = vertices[v2].x - vertices[v0].x;
-            float by = vertices[v2].y - vertices[v0].y;
-            float bz = vertices[v2].z - vertices[v0].z;
-            float nx = ay * bz - az * by;
-            float ny = az * bx - ax * bz;
-            float nz = ax * by - ay * bx;
-            float len = std::sqrt(nx*nx + ny*ny + nz*nz);
-            if (len > 1e-6f) { nx/=len; ny/=len; nz/=len; }
-            glNormal3f(nx, ny, nz);
-            glVertex3f(vertices[v0].x, vertices[v0].y, vertices[v0].z);
-            glVertex3f(vertices[v1].x, vertices[v1].y, vertices[v1].z);
-            glVertex3f(vertices[v2].x, vertices[v2].y, vertices[v2].z);
-        }
-    }
-    glEnd();
-    glDisable(GL_NORMALIZE);
-    glEnable(GL_COLOR_MATERIAL);
-    glPopMatrix();
-}
-
-void SceneObject::drawForPicking() {
-    glPushMatrix();
-    glTranslatef(x, y, z);
-    glRotatef(rx, 1.0f, 0.0f, 0.0f);
-    glRotatef(ry, 0.0f, 1.0f, 0.0f);
-    glRotatef(rz, 0.0f, 0.0f, 1.0f);
-    glScalef(sx, sy, sz);
-
-    glBegin(GL_TRIANGLES);
-    for (const auto& face : faces) {
-        if (face.indices.size() < 3) continue;
-        for (size_t i = 1; i + 1 < face.indices.size(); ++i) {
-            int v0 = face.indices[0];
-            int v1 = face.indices[i];
-            int v2 = face.indices[i + 1];
-            glVertex3f(vertices[v0].x, vertices[v0].y, vertices[v0].z);
-            glVertex3f(vertices[v1].x, vertices[v1].y, vertices[v1].z);
-            glVertex3f(vertices[v2].x, vertices[v2].y, vertices[v2].z);
-        }
-    }
-    glEnd();
-
-    glPopMatrix();
-}
-
-std::string SceneObject::toObj() const {
-    std::ostringstream out;
-    for (const auto &v : vertices) {
-        out << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
-    }
-    for (const auto &f : faces) {
-        if (f.indices.size() < 3) continue;
-        out << "f";
-        for (int idx : f.indices) out << ' ' << (idx + 1);
-        out << '\n';
-    }
-    return out.str();
-}
-
 // === Реализация GLWidget ===
 
 GLWidget::GLWidget(QWidget *parent) : QOpenGLWidget(parent) {
@@ -178,51 +56,63 @@ GLWidget::GLWidget(QWidget *parent) : QOpenGLWidget(parent) {
 }
 
 void GLWidget::addObject(const std::string& objData, const std::string& name) {
-    m_objects.push_back(std::make_unique<SceneObject>(objData, name));
+    addObject(SceneObject(objData, name));
+}
+
+Entity GLWidget::addObject(SceneObject&& object) {
+    const Entity e = m_scene.create(std::move(object));
     update();
+    return e;
 }
 
 void GLWidget::setupProjection() {
-    float aspect = (float)width() / std::max(1, height());
+    m_projection = projectionFor((float)width() / std::max(1, height()));
+}
+
+QMatrix4x4 GLWidget::projectionFor(float aspect) const {
     float zNear = 0.1f, zFar = 1000.0f;
 
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
+    QMatrix4x4 projection;
     if (m_ortho) {
         float size = 5.0f * std::abs(m_camZ);
-        glOrtho(-size * aspect, size * aspect, -size, size, -zFar, zFar);
+        projection.ortho(-size * aspect, size * aspect, -size, size, -zFar, zFar);
     } else {
-        // Перспектива через gluPerspective-подобную математику
-        float f = 1.0f / std::tan((m_fovY * M_PI / 180.0f) / 2.0f);
-        // Эквивалент glFrustum по FOV
-        float top = zNear / f;
-        float right = top * aspect;
-        glFrustum(-right, right, -top, top, zNear, zFar);
+        projection = makePerspective(m_fovY, aspect, zNear, zFar);
     }
+    return projection;
+}
+
+void GLWidget::drawScene(Renderer &renderer) {
+    m_transforms.update(m_scene);
+    m_scene.draw(renderer, m_transforms);
+}
+
+QMatrix4x4 GLWidget::viewMatrix() const {
+    return makeOrbitView(m_camRotX, m_camRotY, -m_camX, -m_camY, m_camZ);
 }
 
 void GLWidget::initializeGL() {
     initializeOpenGLFunctions();
     glClearColor(0.1f, 0.12f, 0.16f, 1.0f);
     glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
-    glEnable(GL_LIGHT0);
-    glEnable(GL_LIGHT1);
-    glEnable(GL_COLOR_MATERIAL);
-    glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+
+    m_renderer.initialize();
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, [this]{
+        makeCurrent();
+        m_renderer.cleanup();
+        doneCurrent();
+    });
+    m_renderer.setLights({
+        {QVector3D(m_lightX, m_lightY, m_lightZ)},
+        {QVector3D(-5.0f, 3.0f, -5.0f)},
+    });
 
     setupProjection();
 
-    GLfloat light0Pos[] = { 5.0f, 10.0f, 5.0f, 1.0f };
-    GLfloat light1Pos[] = { -5.0f, 3.0f, -5.0f, 1.0f };
-    GLfloat lightAmb[] = { 0.15f, 0.15f, 0.15f, 1.0f };
-    GLfloat lightDiff[] = { 0.85f, 0.85f, 0.85f, 1.0f };
-    glLightfv(GL_LIGHT0, GL_POSITION, light0Pos);
-    glLightfv(GL_LIGHT0, GL_AMBIENT, lightAmb);
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, lightDiff);
-    glLightfv(GL_LIGHT1, GL_POSITION, light1Pos);
-    glLightfv(GL_LIGHT1, GL_AMBIENT, lightAmb);
-    glLightfv(GL_LIGHT1, GL_DIFFUSE, lightDiff);
+    // Сетка в мировых координатах (вращается вместе со сценой) и оси —
+    // буферы оверлея заливаются при первом кадре
+    m_overlay.setGrid(20.0f, 1.0f, QVector3D(0.3f, 0.3f, 0.3f));
+    m_overlay.setAxesLength(5.0f);
 
     m_fpsTimer.start();
 }
@@ -230,47 +120,19 @@ void GLWidget::initializeGL() {
 void GLWidget::paintGL() {
     qDebug() << "GLWidget: paintGL called";
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-
-    glPolygonMode(GL_FRONT_AND_BACK, m_wireframe ? GL_LINE : GL_FILL);
     glEnable(GL_DEPTH_TEST);
 
-    // Камера
-    glRotatef(-m_camRotX, 1.0f, 0.0f, 0.0f);
-    glRotatef(-m_camRotY, 0.0f, 1.0f, 0.0f);
-    glTranslatef(-m_camX, -m_camY, m_camZ);
-
-    // Объекты
-    for (size_t i = 0; i < m_objects.size(); ++i) {
-        glPushName(static_cast<GLuint>(i));
-        m_objects[i]->draw();
-        glPopName();
-    }
+    m_renderer.beginFrame(viewMatrix(), m_projection);
+    m_renderer.setWireframe(m_wireframe);
 
-    // Оси и сетка в мировых координатах (вращаются вместе со сценой)
-    glDisable(GL_LIGHTING);
-    glDisable(GL_COLOR_MATERIAL);
-    glColor3f(0.2f, 0.2f, 0.4f);
-    glBegin(GL_LINES);
-    float size = 20.0f;
-    for (float i = -size; i <= size; i += 1.0f) {
-        if (fabs(i) < 0.1f) continue;
-        glColor3f(0.3f, 0.3f, 0.3f);
-        glVertex3f(i, 0, -size);
-        glVertex3f(i, 0, size);
-        glVertex3f(-size, 0, i);
-        glVertex3f(size, 0, i);
-    }
-    glEnd();
+    // Объекты: мировые матрицы обновляются одним проходом перед отрисовкой
+    m_transforms.update(m_scene);
+    m_scene.draw(m_renderer, m_transforms);
+    m_renderer.flush();
 
-    glBegin(GL_LINES);
-    glColor3f(1.0f, 0.0f, 0.0f); glVertex3f(0,0,0); glVertex3f(5,0,0);
-    glColor3f(0.0f, 1.0f, 0.0f); glVertex3f(0,0,0); glVertex3f(0,5,0);
-    glColor3f(0.0f, 0.0f, 1.0f); glVertex3f(0,0,0); glVertex3f(0,0,5);
-    glEnd();
-    glEnable(GL_COLOR_MATERIAL);
-    glEnable(GL_LIGHTING);
+    // Оси и сетка
+    m_overlay.drawGrid(m_renderer);
+    m_overlay.drawAxes(m_renderer);
 
     // Bounding box around selected object
     drawSelectedBoundingBox();
@@ -296,7 +158,7 @@ void GLWidget::mousePressEvent(QMouseEvent *ev) {
         m_middleButtonPressed = true;
     }
 
-    setCursor(m_selectedObject ? Qt::SizeAllCursor : Qt::ArrowCursor);
+    setCursor(getSelectedObject() ? Qt::SizeAllCursor : Qt::ArrowCursor);
     update();
 }
 
@@ -312,7 +174,7 @@ void GLWidget::mouseReleaseEvent(QMouseEvent *ev) {
     if (ev->button() == Qt::MiddleButton) {
         m_middleButtonPressed = false;
     }
-    setCursor(m_selectedObject ? Qt::SizeAllCursor : Qt::ArrowCursor);
+    setCursor(getSelectedObject() ? Qt::SizeAllCursor : Qt::ArrowCursor);
 }
 
 void GLWidget::mouseMoveEvent(QMouseEvent *ev) {
@@ -360,20 +222,21 @@ void GLWidget::mouseMoveEvent(QMouseEvent *ev) {
         m_camY += diff.y() * speed;
         qDebug() << "pan via Shift+LMB" << m_camX << m_camY;
     }
-    else if (m_leftButtonPressed && m_selectedObject) {
+    else if (m_leftButtonPressed && getSelectedObject()) {
         float speed = 0.01f * fabs(m_camZ);
+        TransformComponent &t = m_scene.transform(m_selected);
         if (m_axisConstraint == MoveAxis::X) {
-            m_selectedObject->x += diff.x() * speed;
+            t.x += diff.x() * speed;
         } else if (m_axisConstraint == MoveAxis::Y) {
-            m_selectedObject->y -= diff.y() * speed;
+            t.y -= diff.y() * speed;
         } else if (m_axisConstraint == MoveAxis::Z) {
-            m_selectedObject->z -= diff.y() * speed;
+            t.z -= diff.y() * speed;
         } else {
-            m_selectedObject->x += diff.x() * speed;
-            m_selectedObject->y -= diff.y() * speed;
+            t.x += diff.x() * speed;
+            t.y -= diff.y() * speed;
         }
-        emit objectMoved(m_selectedObject->name, m_selectedObject->x, m_selectedObject->y, m_selectedObject->z);
-        qDebug() << "move object via LMB" << m_selectedObject->x << m_selectedObject->y;
+        emit objectMoved(m_scene.name(m_selected), t.x, t.y, t.z);
+        qDebug() << "move object via LMB" << t.x << t.y;
     }
     // иначе ЛКМ без модификаторов — ничего (выбор/перемещение уже обработаны)
 
@@ -409,8 +272,8 @@ void GLWidget::resetView() {
 void GLWidget::frameAll() {
     // Примитивная реализация: сдвигаем Z так, чтобы вся сцена влезла
     float maxRadius = 1.0f;
-    for (const auto &ptr : m_objects) {
-        for (const auto &v : ptr->vertices) {
+    for (const MeshComponent &mesh : m_scene.meshes()) {
+        for (const auto &v : mesh.vertices) {
             maxRadius = std::max(maxRadius, std::sqrt(v.x*v.x + v.y*v.y + v.z*v.z));
         }
     }
@@ -454,71 +317,31 @@ void GLWidget::dropEvent(QDropEvent *event) {
 }
 
 void GLWidget::selectObject(const QPoint& pos) {
-    GLuint selectBuf[512];
-    glSelectBuffer(512, selectBuf);
-    glRenderMode(GL_SELECT);
-    glInitNames();
-    glPushName(0);
-
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-
-    int viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
-
-    float sx = static_cast<float>(pos.x());
-    float sy = static_cast<float>(viewport[3] - pos.y());
-
-    glTranslatef((2.0f * sx - viewport[2]) / viewport[2],
-                 (2.0f * sy - viewport[3]) / viewport[3], 0.0f);
-    glScalef(5.0f / viewport[2], 5.0f / viewport[3], 1.0f);
-
-    setupProjection();
-
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    glRotatef(-m_camRotX, 1.0f, 0.0f, 0.0f);
-    glRotatef(-m_camRotY, 0.0f, 1.0f, 0.0f);
-    glTranslatef(-m_camX, -m_camY, m_camZ);
-
-    for (size_t i = 0; i < m_objects.size(); ++i) {
-        glLoadName(static_cast<GLuint>(i));
-        m_objects[i]->drawForPicking();
-    }
+    // Луч из камеры через пиксель: обратная проекция ближней и дальней точек
+    const float ndcX = 2.0f * pos.x() / std::max(1, width()) - 1.0f;
+    const float ndcY = 1.0f - 2.0f * pos.y() / std::max(1, height());
+    const QMatrix4x4 invViewProj = (m_projection * viewMatrix()).inverted();
+    const QVector3D nearPt = invViewProj.map(QVector3D(ndcX, ndcY, -1.0f));
+    const QVector3D farPt = invViewProj.map(QVector3D(ndcX, ndcY, 1.0f));
+    const QVector3D dir = farPt - nearPt;
+
+    m_transforms.update(m_scene);
+    selectEntity(m_scene.pick(nearPt, dir, m_transforms));
+}
 
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glFlush();
-
-    GLint hits = glRenderMode(GL_RENDER);
-    if (hits > 0) {
-        GLuint minZ = 0xFFFFFFFF;
-        GLuint selected = 0;
-        for (int i = 0; i < hits; ++i) {
-            GLuint z1 = selectBuf[i * 4 + 1];
-            if (z1 < minZ) {
-                minZ = z1;
-                selected = selectBuf[i * 4 + 3];
-            }
-        }
-        m_selectedObject = m_objects[selected].get();
-        emit objectSelected(m_selectedObject->name);
-        update();
-    }
+void GLWidget::selectEntity(Entity e) {
+    if (!m_scene.alive(e)) return;
+    m_selected = e;
+    emit objectSelected(m_scene.name(m_selected));
+    update();
 }
 
 bool GLWidget::removeSelectedObject() {
-    if (!m_selectedObject) return false;
-    for (size_t i = 0; i < m_objects.size(); ++i) {
-        if (m_objects[i].get() == m_selectedObject) {
-            m_objects.erase(m_objects.begin() + static_cast<long>(i));
-            m_selectedObject = nullptr;
-            update();
-            return true;
-        }
-    }
-    return false;
+    // Дети удаляемого переходят к его родителю — это делает SceneStore::destroy
+    if (!m_scene.destroy(m_selected)) return false;
+    m_selected = Entity{};
+    update();
+    return true;
 }
 
 void GLWidget::keyPressEvent(QKeyEvent *event) {
@@ -536,44 +359,10 @@ void GLWidget::keyReleaseEvent(QKeyEvent *event) {
 }
 
 void GLWidget::drawSelectedBoundingBox() {
-    if (!m_selectedObject) return;
-    Vertex minV, maxV;
-    m_selectedObject->getAABB(minV, maxV);
-
-    glDisable(GL_LIGHTING);
-    glColor3f(1.0f, 0.9f, 0.2f);
-    glLineWidth(2.0f);
-
-    glPushMatrix();
-    glTranslatef(m_selectedObject->x, m_selectedObject->y, m_selectedObject->z);
-    glRotatef(m_selectedObject->rx, 1.0f, 0.0f, 0.0f);
-    glRotatef(m_selectedObject->ry, 0.0f, 1.0f, 0.0f);
-    glRotatef(m_selectedObject->rz, 0.0f, 0.0f, 1.0f);
-    glScalef(m_selectedObject->sx, m_selectedObject->sy, m_selectedObject->sz);
-
-    float x0 = minV.x, y0 = minV.y, z0 = minV.z;
-    float x1 = maxV.x, y1 = maxV.y, z1 = maxV.z;
-    glBegin(GL_LINES);
-    // bottom rectangle
-    glVertex3f(x0,y0,z0); glVertex3f(x1,y0,z0);
-    glVertex3f(x1,y0,z0); glVertex3f(x1,y0,z1);
-    glVertex3f(x1,y0,z1); glVertex3f(x0,y0,z1);
-    glVertex3f(x0,y0,z1); glVertex3f(x0,y0,z0);
-    // top rectangle
-    glVertex3f(x0,y1,z0); glVertex3f(x1,y1,z0);
-    glVertex3f(x1,y1,z0); glVertex3f(x1,y1,z1);
-    glVertex3f(x1,y1,z1); glVertex3f(x0,y1,z1);
-    glVertex3f(x0,y1,z1); glVertex3f(x0,y1,z0);
-    // verticals
-    glVertex3f(x0,y0,z0); glVertex3f(x0,y1,z0);
-    glVertex3f(x1,y0,z0); glVertex3f(x1,y1,z0);
-    glVertex3f(x1,y0,z1); glVertex3f(x1,y1,z1);
-    glVertex3f(x0,y0,z1); glVertex3f(x0,y1,z1);
-    glEnd();
-
-    glPopMatrix();
-    glLineWidth(1.0f);
-    glEnable(GL_LIGHTING);
+    const QMatrix4x4 *world = m_transforms.worldOf(m_scene, m_selected);
+    if (!world) return;
+    const MeshComponent &mesh = m_scene.mesh(m_selected);
+    m_overlay.drawBox(m_renderer, mesh.boundsMin, mesh.boundsMax, *world);
 }
 
 void GLWidget::updateFpsCounter() {
@@ -594,9 +383,52 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     setWindowState(Qt::WindowMaximized);
     setupUI();
 
-    m_modelTimer = new QTimer(this);
-    connect(m_modelTimer, &QTimer::timeout, this, &MainWindow::checkForModel);
-    m_modelTimer->start(500);
+    // Модели от ИИ-агента приходят через локальный сокет уже разобранными
+    m_modelReceiver = new ModelReceiver(this);
+    connect(m_modelReceiver, &ModelReceiver::log, this, [this](const QString &line){ m_console->append(line); });
+    connect(m_modelReceiver, &ModelReceiver::modelReceived, this, &MainWindow::onModelReceived);
+    if (!m_modelReceiver->isListening()) m_console->append("[AI] Не удалось открыть канал моделей: " + ModelReceiver::serverName());
+
+    m_sceneLoader = new SceneLoader(this);
+    connect(m_sceneLoader, &SceneLoader::loaded, this, &MainWindow::onSceneLoaded);
+    connect(m_sceneLoader, &SceneLoader::failed, this, [this](const QString &path, const QString &error){
+        m_statusLabel->setText("Готов");
+        m_console->append("[SCENE] Не удалось загрузить " + path + ": " + error);
+    });
+    connect(m_sceneLoader, &SceneLoader::assetsMissing, this, [this](const QString &path, const QStringList &guids){
+        m_console->append(QString("[SCENE] %1: ассетов не найдено: %2, объекты без меша (%3)")
+            .arg(path).arg(guids.size()).arg(guids.join(", ")));
+    });
+
+    // Ассеты проекта: модели — через базу и cooked-копии, сцены ссылаются на них по GUID
+    m_assets = new AssetPipeline(this);
+    connect(m_assets, &AssetPipeline::log, this, [this](const QString &line){ m_console->append(line); });
+    connect(m_assets, &AssetPipeline::instantiated, this, [this](const QString &source, std::shared_ptr<SceneObject> object){
+        m_glWidget->addObject(std::move(*object));
+        m_sceneModel->sync();
+        m_console->append("[IMPORT] OBJ: " + source);
+    });
+    connect(m_assets, &AssetPipeline::reimported, this, [this](const QString &guid, std::shared_ptr<SceneObject> object){
+        const size_t n = m_glWidget->reloadAsset(guid.toStdString(), object->vertices, object->faces);
+        if (n) m_console->append(QString("[ASSET] %1: обновлено объектов в сцене: %2").arg(QString::fromStdString(object->name)).arg(n));
+    });
+    m_assets->openProject(QDir::currentPath());
+    m_sceneLoader->setAssetLoader(m_assets->meshLoader());
+    m_renderService->setAssetLoader(m_assets->meshLoader());
+
+    connect(m_renderService, &RenderService::saved, this, [this](const QString &path, qint64 renderMs){
+        m_console->append(QString("[SHOT] Сохранён: %1 (рендер %2 мс)").arg(path).arg(renderMs));
+    });
+    connect(m_renderService, &RenderService::failed, this, [this](const QString &path, const QString &error){
+        m_console->append("[RENDER] Ошибка: " + path + ": " + error);
+    });
+
+    m_exporter = new GameExporter(this);
+    connect(m_exporter, &GameExporter::log, this, [this](const QString &line){ m_console->append(line); });
+    connect(m_exporter, &GameExporter::finished, this, [this](bool ok, const QString &){
+        m_statusLabel->setText(ok ? "Сборка завершена" : "Ошибка сборки");
+        if (!ok) QMessageBox::warning(this, "Build", "Сборка не удалась. Нужен Qt6 SDK в окружении.");
+    });
 
     connect(m_glWidget, &GLWidget::objectSelected, this, [this](const std::string& name) {
         m_console->append(QString("✅ Выделено: %1").arg(QString::fromStdString(name)));
@@ -637,8 +469,20 @@ void MainWindow::setupUI() {
     new QTreeWidgetItem(assets, QStringList("Scripts"));
     new QTreeWidgetItem(assets, QStringList("Materials"));
     m_projectTree->setMinimumWidth(220);
+    m_projectTree->setIconSize(QSize(48, 48));
     mainSplitter->addWidget(m_projectTree);
 
+    // Превью моделей и сцен проекта рисуются offscreen и копятся в атласе рядом с проектом
+    m_renderService = new RenderService(this);
+    m_thumbnailCache = new ThumbnailCache(QDir::current().filePath(".simplecascade/thumbnails.atlas"), m_renderService, this);
+    m_assetBrowser = new AssetBrowser(m_projectTree, scenesNode, modelsNode, m_thumbnailCache, this);
+    connect(m_assetBrowser, &AssetBrowser::modelActivated, this, [this](const QString &path){ m_assets->instantiate(path); });
+    connect(m_assetBrowser, &AssetBrowser::sceneActivated, this, [this](const QString &path){
+        if (!m_sceneLoader->load(path, SceneLoader::Scene)) { m_console->append("[SCENE] Загрузка уже выполняется"); return; }
+        m_statusLabel->setText("Загрузка сцены...");
+    });
+    m_assetBrowser->setRoot(QDir::currentPath());
+
     auto rightSplitter = new QSplitter(Qt::Vertical);
     m_viewTabs = new QTabWidget();
     m_glWidget = new GLWidget();
@@ -665,12 +509,26 @@ void MainWindow::setupUI() {
     mainSplitter->addWidget(rightSplitter);
 
     auto sideSplitter = new QSplitter(Qt::Vertical);
-    m_sceneTree = new QTreeWidget();
-    m_sceneTree->setHeaderLabel("Иерархия");
-    auto sceneRoot = new QTreeWidgetItem(m_sceneTree, QStringList("Сцена"));
-    new QTreeWidgetItem(sceneRoot, QStringList("Камера"));
-    new QTreeWidgetItem(sceneRoot, QStringList("Свет"));
+    // Строки дерева — представление SceneStore; после правок сцены — m_sceneModel->sync()
+    m_sceneModel = new SceneTreeModel(m_glWidget->scene(), this);
+    m_sceneTree = new QTreeView();
+    m_sceneTree->setModel(m_sceneModel);
+    m_sceneTree->setUniformRowHeights(true);
+    m_sceneTree->expand(m_sceneModel->sceneIndex());
     m_sceneTree->setMinimumWidth(220);
+    // После сброса модели (загрузка, очистка) вид сворачивается — «Сцену» раскрываем снова
+    connect(m_sceneModel, &QAbstractItemModel::modelReset, m_sceneTree, [this]{ m_sceneTree->expand(m_sceneModel->sceneIndex()); });
+    connect(m_sceneTree->selectionModel(), &QItemSelectionModel::currentChanged, this, [this](const QModelIndex &current){
+        const Entity e = m_sceneModel->entityAt(current);
+        if (e && e != m_glWidget->getSelectedObject()) m_glWidget->selectEntity(e);
+    });
+    connect(m_glWidget, &GLWidget::objectSelected, m_sceneTree, [this](const std::string&){
+        m_sceneModel->sync();
+        const QModelIndex index = m_sceneModel->indexOf(m_glWidget->getSelectedObject());
+        if (!index.isValid() || index == m_sceneTree->currentIndex()) return;
+        m_sceneTree->setCurrentIndex(index);
+        m_sceneTree->scrollTo(index);
+    });
     sideSplitter->addWidget(m_sceneTree);
 
     m_inspector = createInspector();
@@ -693,6 +551,8 @@ void MainWindow::setupUI() {
 
     auto codePanel = new CodePanel();
     codeLayout->addWidget(codePanel);
+    // Строка состояния создаётся ниже, в setupStatusBar — сигнал приходит уже после
+    connect(codePanel, &CodePanel::status, this, [this](const QString &msg){ m_statusBar->showMessage(msg, 5000); });
 
     m_tabWidget->addTab(codeTab, " 💻 Редактор кода ");
 
@@ -704,7 +564,7 @@ void MainWindow::setupUI() {
     modelLayout->addWidget(modelEditor);
     connect(modelEditor, &ModelEditor::sendToScene, this, [this](const QString &obj, const QString &name){
         m_glWidget->addObject(obj.toStdString(), name.toStdString());
-        new QTreeWidgetItem(m_sceneTree->topLevelItem(0), QStringList(name));
+        m_sceneModel->sync();
         if (m_console) m_console->append("[MODEL-EDITOR] Вставлен: "+name);
     });
     m_tabWidget->addTab(modelTab, " 🧱 Редактор моделей ");
@@ -747,64 +607,83 @@ QWidget* MainWindow::createInspector() {
     m_colorBtn->setMaximumWidth(120);
     form->addRow("Цвет", m_colorBtn);
 
-    // Привязки к выбранному объекту
-    auto connectSpin = [this](QDoubleSpinBox* s, auto setter) {
-        connect(s, qOverload<double>(&QDoubleSpinBox::valueChanged), this, [this, setter](double v){
-            if (m_glWidget->getSelectedObject()) {
-                setter(*m_glWidget->getSelectedObject(), static_cast<float>(v));
-                m_glWidget->update();
-            }
-        });
-    };
-
-    connectSpin(m_posX, [](SceneObject& o, float v){ o.x = v; });
-    connectSpin(m_posY, [](SceneObject& o, float v){ o.y = v; });
-    connectSpin(m_posZ, [](SceneObject& o, float v){ o.z = v; });
-    connectSpin(m_rotX, [](SceneObject& o, float v){ o.rx = v; });
-    connectSpin(m_rotY, [](SceneObject& o, float v){ o.ry = v; });
-    connectSpin(m_rotZ, [](SceneObject& o, float v){ o.rz = v; });
-    connectSpin(m_sclX, [](SceneObject& o, float v){ o.sx = v; });
-    connectSpin(m_sclY, [](SceneObject& o, float v){ o.sy = v; });
-    connectSpin(m_sclZ, [](SceneObject& o, float v){ o.sz = v; });
+    // Родитель в иерархии; локальное преобразование остаётся прежним
+    m_parentCombo = new QComboBox();
+    m_parentCombo->setMaximumWidth(180);
+    form->addRow("Родитель", m_parentCombo);
+
+    // Привязки к выбранному объекту: правки копятся и применяются раз за кадр
+    m_inspectorBinding = new InspectorBinding(&m_glWidget->scene(), this);
+    m_inspectorBinding->bind(m_posX, SceneField::PosX);
+    m_inspectorBinding->bind(m_posY, SceneField::PosY);
+    m_inspectorBinding->bind(m_posZ, SceneField::PosZ);
+    m_inspectorBinding->bind(m_rotX, SceneField::RotX);
+    m_inspectorBinding->bind(m_rotY, SceneField::RotY);
+    m_inspectorBinding->bind(m_rotZ, SceneField::RotZ);
+    m_inspectorBinding->bind(m_sclX, SceneField::SclX);
+    m_inspectorBinding->bind(m_sclY, SceneField::SclY);
+    m_inspectorBinding->bind(m_sclZ, SceneField::SclZ);
+    connect(m_inspectorBinding, &InspectorBinding::applied, m_glWidget, [this]{ m_glWidget->update(); });
 
     // Обновление при выборе объекта
     connect(m_glWidget, &GLWidget::objectSelected, this, [this](const std::string&){
         bindInspector(m_glWidget->getSelectedObject());
     });
+    // Перетаскивание во вьюпорте меняет позицию в обход привязки
+    connect(m_glWidget, &GLWidget::objectMoved, m_inspectorBinding, &InspectorBinding::refresh);
 
     connect(m_colorBtn, &QPushButton::clicked, this, [this]{
-        auto so = m_glWidget->getSelectedObject();
+        const Entity so = m_inspectorBinding->target();
         if (!so) return;
-        QColor current = QColor::fromRgbF(so->r, so->g, so->b);
+        const RenderComponent &rc = m_glWidget->scene().render(so);
+        QColor current = QColor::fromRgbF(rc.r, rc.g, rc.b);
         QColor c = QColorDialog::getColor(current, this, "Выбор цвета");
         if (!c.isValid()) return;
-        so->r = static_cast<float>(c.redF());
-        so->g = static_cast<float>(c.greenF());
-        so->b = static_cast<float>(c.blueF());
+        m_inspectorBinding->set(SceneField::ColorR, static_cast<float>(c.redF()));
+        m_inspectorBinding->set(SceneField::ColorG, static_cast<float>(c.greenF()));
+        m_inspectorBinding->set(SceneField::ColorB, static_cast<float>(c.blueF()));
+        bindInspector(so);
+    });
+
+    connect(m_parentCombo, qOverload<int>(&QComboBox::activated), this, [this](int row){
+        const Entity so = m_inspectorBinding->target();
+        if (!so) return;
+        const Entity parent = Entity::fromId(m_parentCombo->itemData(row).toULongLong());
+        if (!m_glWidget->scene().setParent(so, parent)) {
+            if (m_console) m_console->append("[SCENE] Нельзя сделать объект потомком собственного потомка");
+            bindInspector(so);
+            return;
+        }
+        m_sceneModel->sync();
         m_glWidget->update();
     });
 
     return panel;
 }
 
-void MainWindow::bindInspector(SceneObject* o) {
-    if (!o) return;
-    m_posX->blockSignals(true); m_posY->blockSignals(true); m_posZ->blockSignals(true);
-    m_rotX->blockSignals(true); m_rotY->blockSignals(true); m_rotZ->blockSignals(true);
-    m_sclX->blockSignals(true); m_sclY->blockSignals(true); m_sclZ->blockSignals(true);
-
-    m_posX->setValue(o->x); m_posY->setValue(o->y); m_posZ->setValue(o->z);
-    m_rotX->setValue(o->rx); m_rotY->setValue(o->ry); m_rotZ->setValue(o->rz);
-    m_sclX->setValue(o->sx); m_sclY->setValue(o->sy); m_sclZ->setValue(o->sz);
+void MainWindow::bindInspector(Entity o) {
+    m_inspectorBinding->setTarget(o);
+    m_parentCombo->clear();
+    const SceneStore &scene = m_glWidget->scene();
+    if (!scene.alive(o)) return;
+    // Кнопка показывает цвет с учётом ещё не применённой правки
+    m_inspectorBinding->flush();
+    const RenderComponent &rc = scene.renders()[scene.slotOf(o)];
     QPalette pal = m_colorBtn->palette();
-    pal.setColor(QPalette::Button, QColor::fromRgbF(o->r, o->g, o->b));
+    pal.setColor(QPalette::Button, QColor::fromRgbF(rc.r, rc.g, rc.b));
     m_colorBtn->setAutoFillBackground(true);
     m_colorBtn->setPalette(pal);
     m_colorBtn->update();
 
-    m_posX->blockSignals(false); m_posY->blockSignals(false); m_posZ->blockSignals(false);
-    m_rotX->blockSignals(false); m_rotY->blockSignals(false); m_rotZ->blockSignals(false);
-    m_sclX->blockSignals(false); m_sclY->blockSignals(false); m_sclZ->blockSignals(false);
+    // В списке — только допустимые родители: не сам объект и не его потомки
+    m_parentCombo->addItem("— нет —", QVariant::fromValue<qulonglong>(Entity{}.id()));
+    const Entity current = scene.parent(o);
+    for (size_t i = 0; i < scene.size(); ++i) {
+        const Entity candidate = scene.entityAt(i);
+        if (scene.isDescendant(candidate, o)) continue;
+        m_parentCombo->addItem(QString::fromStdString(scene.name(candidate)), QVariant::fromValue<qulonglong>(candidate.id()));
+        if (candidate == current) m_parentCombo->setCurrentIndex(m_parentCombo->count() - 1);
+    }
 }
 
 void MainWindow::setupToolbar() {
@@ -869,6 +748,11 @@ void MainWindow::setupToolbar() {
     connect(openAction, &QAction::triggered, this, &MainWindow::onOpenScene);
     auto saveAction = addAction("Сохранить", "icons/save.png");
     connect(saveAction, &QAction::triggered, this, &MainWindow::onSaveScene);
+    QAction* compressAct = new QAction("Сжимать меши", this);
+    compressAct->setCheckable(true);
+    compressAct->setToolTip("Сохранять меши сжатыми (16-битные позиции, ~10x меньше; точность — 1/65535 габарита)");
+    m_toolbar->addAction(compressAct);
+    connect(compressAct, &QAction::toggled, this, [this](bool on){ m_meshEncoding = on ? MeshEncoding::Quantized : MeshEncoding::Obj; });
 
     // Сессия
     QAction* saveSession = new QAction("Сохранить сессию", this);
@@ -885,14 +769,8 @@ void MainWindow::setupToolbar() {
     connect(importObj, &QAction::triggered, this, [this]{
         QString p = QFileDialog::getOpenFileName(this, "Импорт OBJ", "", "OBJ Files (*.obj)");
         if (p.isEmpty()) return;
-        QFile f(p);
-        if (f.open(QIODevice::ReadOnly)) {
-            auto data = QString::fromUtf8(f.readAll());
-            auto modelName = QFileInfo(p).baseName();
-            m_glWidget->addObject(data.toStdString(), modelName.toStdString());
-            new QTreeWidgetItem(m_sceneTree->topLevelItem(0), QStringList(modelName));
-            m_console->append("[IMPORT] OBJ: " + p);
-        }
+        // Разбор и cooked-копия — в очереди ассетов, объект придёт в instantiated
+        m_assets->instantiate(p);
     });
 
     // Примитивы: Куб, Сфера, Плоскость
@@ -979,7 +857,7 @@ void MainWindow::setupToolbar() {
 
     auto addPrimitive = [this](const QString &name, const std::string &obj){
         m_glWidget->addObject(obj, name.toStdString());
-        new QTreeWidgetItem(m_sceneTree->topLevelItem(0), QStringList(name));
+        m_sceneModel->sync();
         if (m_console) m_console->append("[PRIM] Добавлен: " + name);
     };
 
@@ -1042,7 +920,7 @@ void MainWindow::setupToolbar() {
 
     auto aiAction = addAction("ИИ", "icons/ai.png");
     connect(aiAction, &QAction::triggered, [this] {
-        QProcess::startDetached("python3", {QString::fromStdString(std::string(PYTHON_DIR) + "/ai_agent.py")});
+        ModelReceiver::launchAgent();
     });
 
     auto modelAction = addAction("Модель", "icons/model.png");
@@ -1086,6 +964,11 @@ void MainWindow::setupToolbar() {
     m_toolbar->addAction(orthoAct);
     connect(orthoAct, &QAction::toggled, this, [this](bool on){ m_glWidget->setOrtho(on); });
     setIconIfExists(orthoAct, "icons/ortho.png");
+    QAction* gridAct = new QAction("Infinite Grid", this);
+    gridAct->setCheckable(true);
+    gridAct->setToolTip("Бесконечная сетка (строится шейдером)");
+    m_toolbar->addAction(gridAct);
+    connect(gridAct, &QAction::toggled, this, [this](bool on){ m_glWidget->setInfiniteGrid(on); });
 }
 
 void MainWindow::setupStatusBar() {
@@ -1109,54 +992,25 @@ static QString openSceneDialog(QWidget* parent) {
     return QFileDialog::getOpenFileName(parent, "Открыть сцену", "", "SimpleCASCADE Scene (*.scene)");
 }
 
-void MainWindow::checkForModel() {
-    QString flagPath = QString::fromStdString(std::string(PYTHON_DIR) + "/model_ready.flag");
-    QString objPath = QString::fromStdString(std::string(PYTHON_DIR) + "/temp_model.obj");
-
-    if (QFile::exists(flagPath)) {
-        QFile::remove(flagPath);
-        if (QFile::exists(objPath)) {
-            QFile file(objPath);
-            if (file.open(QIODevice::ReadOnly)) {
-                QTextStream in(&file);
-                QString data = in.readAll();
-                auto modelName = QString("Модель_%1").arg(m_glWidget->getObjectCount() + 1);
-                m_glWidget->addObject(data.toStdString(), modelName.toStdString());
-                m_console->append("[AI] Модель добавлена в сцену");
-                file.close();
-                QFile::remove(objPath);
-                auto item = new QTreeWidgetItem(m_sceneTree->topLevelItem(0), QStringList(modelName));
-            }
-        }
-    }
+void MainWindow::onModelReceived(std::shared_ptr<SceneObject> model) {
+    QString modelName = QString::fromStdString(model->name);
+    if (modelName.isEmpty()) modelName = QString("Модель_%1").arg(m_glWidget->getObjectCount() + 1);
+    m_glWidget->addObject(SceneObject(std::move(model->vertices), std::move(model->faces), modelName.toStdString()));
+    m_console->append("[AI] Модель добавлена в сцену");
+    m_sceneModel->sync();
 }
 
 void MainWindow::onNewScene() {
+    bindInspector(Entity{});
     if (m_glWidget) m_glWidget->clearObjects();
-    if (m_sceneTree && m_sceneTree->topLevelItemCount() > 0) {
-        auto root = m_sceneTree->topLevelItem(0);
-        // Удаляем детей, кроме Камера/Свет
-        while (root->childCount() > 2) {
-            delete root->takeChild(2);
-        }
-    }
+    if (m_sceneModel) m_sceneModel->sync();
     m_console->append("[SCENE] Новая сцена");
 }
 
 void MainWindow::onSaveScene() {
     QString path = saveSceneDialog(this);
     if (path.isEmpty()) return;
-    QJsonArray objects;
-    for (const auto &ptr : m_glWidget->objects()) {
-        const auto &o = *ptr;
-        QJsonObject jo;
-        jo["name"] = QString::fromStdString(o.name);
-        jo["transform"] = QJsonObject{{"pos", QJsonArray{o.x,o.y,o.z}}, {"rot", QJsonArray{o.rx,o.ry,o.rz}}, {"scl", QJsonArray{o.sx,o.sy,o.sz}}};
-        jo["mesh_obj"] = QString::fromStdString(o.toObj());
-        jo["color"] = QJsonArray{o.r, o.g, o.b};
-        objects.push_back(jo);
-    }
-    QJsonObject root{{"objects", objects}};
+    QJsonObject root = sceneToJson(m_glWidget->scene(), m_meshEncoding);
     QFile f(path);
     if (f.open(QIODevice::WriteOnly)) {
         f.write(QJsonDocument(root).toJson());
@@ -1168,21 +1022,11 @@ void MainWindow::onSaveScene() {
 void MainWindow::onSaveSession() {
     QString path = QFileDialog::getSaveFileName(this, "Сохранить сессию", "", "SimpleCASCADE Session (*.session)");
     if (path.isEmpty()) return;
-    QJsonObject root;
     // Scene
-    QJsonArray objects;
-    for (const auto &ptr : m_glWidget->objects()) {
-        const auto &o = *ptr;
-        QJsonObject jo;
-        jo["name"] = QString::fromStdString(o.name);
-        jo["transform"] = QJsonObject{{"pos", QJsonArray{o.x,o.y,o.z}}, {"rot", QJsonArray{o.rx,o.ry,o.rz}}, {"scl", QJsonArray{o.sx,o.sy,o.sz}}};
-        jo["mesh_obj"] = QString::fromStdString(o.toObj());
-        jo["color"] = QJsonArray{o.r, o.g, o.b};
-        objects.push_back(jo);
-    }
-    root["objects"] = objects;
+    QJsonObject root = sceneToJson(m_glWidget->scene(), m_meshEncoding);
     // Camera/UI state
-    QJsonObject cam{{"x", m_glWidget->getSelectedObject() ? m_glWidget->getSelectedObject()->x : 0}, {"y", 0}, {"z", 0}}; // placeholder
+    const Entity sel = m_glWidget->getSelectedObject();
+    QJsonObject cam{{"x", sel ? m_glWidget->scene().transform(sel).x : 0}, {"y", 0}, {"z", 0}}; // placeholder
     root["ui"] = QJsonObject{
         {"tab", m_tabWidget->currentIndex()},
     };
@@ -1194,117 +1038,46 @@ void MainWindow::onSaveSession() {
 void MainWindow::onLoadSession() {
     QString path = QFileDialog::getOpenFileName(this, "Загрузить сессию", "", "SimpleCASCADE Session (*.session)");
     if (path.isEmpty()) return;
-    QFile f(path);
-    if (!f.open(QIODevice::ReadOnly)) return;
-    auto doc = QJsonDocument::fromJson(f.readAll()); f.close(); if (!doc.isObject()) return;
+    if (!m_sceneLoader->load(path, SceneLoader::Session)) { m_console->append("[SCENE] Загрузка уже выполняется"); return; }
+    m_statusLabel->setText("Загрузка сессии...");
+}
+
+void MainWindow::onSceneLoaded(SceneLoader::Kind kind, const QString &path, std::shared_ptr<SceneObjectList> objects,
+                               const QJsonObject &root, qint64 elapsedMs) {
+    // Объекты уже разобраны в фоне: в сцену, дерево и на экран — одним пакетом
+    const size_t count = objects->size();
     onNewScene();
-    auto root = doc.object();
-    auto arr = root.value("objects").toArray();
-    for (const auto &it : arr) {
-        auto jo = it.toObject();
-        auto name = jo.value("name").toString("Object");
-        auto mesh = jo.value("mesh_obj").toString();
-        m_glWidget->addObject(mesh.toStdString(), name.toStdString());
-        if (!m_glWidget->objects().empty()) {
-            auto &o = *m_glWidget->objects().back();
-            auto tr = jo.value("transform").toObject();
-            auto pos = tr.value("pos").toArray();
-            auto rot = tr.value("rot").toArray();
-            auto scl = tr.value("scl").toArray();
-            if (pos.size()==3){ o.x=pos[0].toDouble(); o.y=pos[1].toDouble(); o.z=pos[2].toDouble(); }
-            if (rot.size()==3){ o.rx=rot[0].toDouble(); o.ry=rot[1].toDouble(); o.rz=rot[2].toDouble(); }
-            if (scl.size()==3){ o.sx=scl[0].toDouble(); o.sy=scl[1].toDouble(); o.sz=scl[2].toDouble(); }
-            auto color = jo.value("color").toArray();
-            if (color.size()==3){ o.r=color[0].toDouble(); o.g=color[1].toDouble(); o.b=color[2].toDouble(); }
-        }
-        new QTreeWidgetItem(m_sceneTree->topLevelItem(0), QStringList(name));
+    m_glWidget->addObjects(std::move(*objects));
+    m_sceneModel->sync();
+    m_statusLabel->setText("Готов");
+    if (kind == SceneLoader::Session) {
+        auto ui = root.value("ui").toObject();
+        int tab = ui.value("tab").toInt(0);
+        m_tabWidget->setCurrentIndex(tab);
+        m_console->append("[SESSION] Загружена: "+path);
+    } else {
+        m_console->append("[SCENE] Сцена загружена: " + path);
     }
-    // UI
-    auto ui = root.value("ui").toObject();
-    int tab = ui.value("tab").toInt(0);
-    m_tabWidget->setCurrentIndex(tab);
-    m_glWidget->update();
-    m_console->append("[SESSION] Загружена: "+path);
+    m_console->append(QString("[SCENE] Объектов: %1, разбор: %2 мс").arg(count).arg(elapsedMs));
 }
 
 void MainWindow::onBuildGame() {
-    // 1) Сохранить сцену во временный файл
-    QString scenePath = QDir::temp().filePath("SimpleCASCADE_build.scene");
-    {
-        QJsonArray objects;
-        for (const auto &ptr : m_glWidget->objects()) {
-            const auto &o = *ptr;
-            QJsonObject jo;
-            jo["name"] = QString::fromStdString(o.name);
-            jo["transform"] = QJsonObject{{"pos", QJsonArray{o.x,o.y,o.z}}, {"rot", QJsonArray{o.rx,o.ry,o.rz}}, {"scl", QJsonArray{o.sx,o.sy,o.sz}}};
-            jo["mesh_obj"] = QString::fromStdString(o.toObj());
-            jo["color"] = QJsonArray{o.r, o.g, o.b};
-            objects.push_back(jo);
-        }
-        QJsonObject root{{"objects", objects}};
-        QFile f(scenePath);
-        if (f.open(QIODevice::WriteOnly)) { f.write(QJsonDocument(root).toJson()); f.close(); }
-    }
-
-    // 2) Сконфигурировать/собрать Player (если Qt установлен)
-    QString buildDir = QDir::temp().filePath("SimpleCASCADE_PlayerBuild");
-    QDir().mkpath(buildDir);
-    QString cmake = "cmake";
-    QString configure = QString("%1 -S \"%2\" -B \"%3\" -DCMAKE_BUILD_TYPE=Release").arg(cmake, QString(SOURCE_DIR), buildDir);
-    QString build = QString("%1 --build \"%2\" --target Player --config Release").arg(cmake, buildDir);
-    auto run = [this](const QString &cmd){ return QProcess::execute("/bin/sh", {"-lc", cmd}); };
-    int ec1 = run(configure);
-    int ec2 = ec1==0 ? run(build) : -1;
-    if (ec1!=0 || ec2!=0) {
-        m_console->append("[BUILD] Ошибка сборки Player. Убедитесь, что Qt6 установлен.");
-        QMessageBox::warning(this, "Build", "Сборка не удалась. Нужен Qt6 SDK в окружении.");
-        return;
-    }
-
-    // 3) Скопировать итог
+    if (m_exporter->isRunning()) { m_console->append("[BUILD] Сборка уже выполняется"); return; }
     QString exportDir = QFileDialog::getExistingDirectory(this, "Папка вывода игры");
     if (exportDir.isEmpty()) return;
-    // бинарь и сцена
-    QString playerBin = QDir(buildDir).filePath("Player");
-    QFile::copy(playerBin, QDir(exportDir).filePath("Player"));
-    QFile::copy(scenePath, QDir(exportDir).filePath("game.scene"));
-    m_console->append("[BUILD] Готово. В папке: " + exportDir);
+    // Статика сливается в батчи по материалу/кластеру, сцена пишется в бинарный формат Player; дальше всё асинхронно
+    m_statusLabel->setText("Сборка игры...");
+    BakedScene baked = bakeScene(m_glWidget->scene().toObjects());
+    m_console->append(QString("[BAKE] Объектов: %1 → батчей: %2, динамических: %3")
+        .arg(m_glWidget->getObjectCount()).arg(baked.batches.size()).arg(baked.dynamicObjects.size()));
+    m_exporter->start(SceneBinary::save(baked), exportDir);
 }
 
 void MainWindow::onOpenScene() {
     QString path = openSceneDialog(this);
     if (path.isEmpty()) return;
-    QFile f(path);
-    if (!f.open(QIODevice::ReadOnly)) return;
-    auto doc = QJsonDocument::fromJson(f.readAll());
-    f.close();
-    if (!doc.isObject()) return;
-    onNewScene();
-    auto arr = doc.object().value("objects").toArray();
-    for (const auto &it : arr) {
-        auto jo = it.toObject();
-        auto name = jo.value("name").toString("Object");
-        auto mesh = jo.value("mesh_obj").toString();
-        m_glWidget->addObject(mesh.toStdString(), name.toStdString());
-        if (auto so = m_glWidget->getSelectedObject()) {
-            // noop
-        }
-        auto tr = jo.value("transform").toObject();
-        auto pos = tr.value("pos").toArray();
-        auto rot = tr.value("rot").toArray();
-        auto scl = tr.value("scl").toArray();
-        if (!m_glWidget->objects().empty()) {
-            auto &o = *m_glWidget->objects().back();
-            if (pos.size()==3){ o.x=pos[0].toDouble(); o.y=pos[1].toDouble(); o.z=pos[2].toDouble(); }
-            if (rot.size()==3){ o.rx=rot[0].toDouble(); o.ry=rot[1].toDouble(); o.rz=rot[2].toDouble(); }
-            if (scl.size()==3){ o.sx=scl[0].toDouble(); o.sy=scl[1].toDouble(); o.sz=scl[2].toDouble(); }
-            auto color = jo.value("color").toArray();
-            if (color.size()==3){ o.r=color[0].toDouble(); o.g=color[1].toDouble(); o.b=color[2].toDouble(); }
-        }
-        auto item = new QTreeWidgetItem(m_sceneTree->topLevelItem(0), QStringList(name));
-    }
-    m_glWidget->update();
-    m_console->append("[SCENE] Сцена загружена: " + path);
+    if (!m_sceneLoader->load(path, SceneLoader::Scene)) { m_console->append("[SCENE] Загрузка уже выполняется"); return; }
+    m_statusLabel->setText("Загрузка сцены...");
 }
 
 void MainWindow::onRun() {
@@ -1313,39 +1086,26 @@ void MainWindow::onRun() {
 }
 
 void MainWindow::onDuplicateSelected() {
-    auto sel = m_glWidget->getSelectedObject();
+    const Entity sel = m_glWidget->getSelectedObject();
     if (!sel) { if (m_console) m_console->append("[DUP] Нет выбранного объекта"); return; }
-    QString name = QString::fromStdString(sel->name) + "_copy";
-    m_glWidget->addObject(sel->toObj(), name.toStdString());
-    if (!m_glWidget->objects().empty()) {
-        auto &o = *m_glWidget->objects().back();
-        o.x = sel->x; o.y = sel->y; o.z = sel->z;
-        o.rx = sel->rx; o.ry = sel->ry; o.rz = sel->rz;
-        o.sx = sel->sx; o.sy = sel->sy; o.sz = sel->sz;
-        o.r = sel->r; o.g = sel->g; o.b = sel->b;
-    }
-    if (m_sceneTree && m_sceneTree->topLevelItemCount() > 0) {
-        auto root = m_sceneTree->topLevelItem(0);
-        new QTreeWidgetItem(root, QStringList(name));
-    }
+    SceneStore &scene = m_glWidget->scene();
+    QString name = QString::fromStdString(scene.name(sel)) + "_copy";
+    // toObject даёт копию с собственным ключом меша
+    SceneObject copy = scene.toObject(sel);
+    copy.name = name.toStdString();
+    const Entity dup = m_glWidget->addObject(std::move(copy));
+    scene.setParent(dup, scene.parent(sel));
+    m_sceneModel->sync();
     if (m_console) m_console->append("[DUP] Создан дубль: " + name);
 }
 
 void MainWindow::onDeleteSelected() {
-    auto sel = m_glWidget->getSelectedObject();
+    const Entity sel = m_glWidget->getSelectedObject();
     if (!sel) { if (m_console) m_console->append("[DEL] Нет выбранного объекта"); return; }
-    QString name = QString::fromStdString(sel->name);
+    QString name = QString::fromStdString(m_glWidget->scene().name(sel));
+    bindInspector(Entity{});
     if (m_glWidget->removeSelectedObject()) {
-        if (m_sceneTree && m_sceneTree->topLevelItemCount() > 0) {
-            auto root = m_sceneTree->topLevelItem(0);
-            for (int i = 0; i < root->childCount(); ++i) {
-                auto child = root->child(i);
-                if (child->text(0) == name && child->text(0) != "Камера" && child->text(0) != "Свет") {
-                    delete root->takeChild(i);
-                    break;
-                }
-            }
-        }
+        m_sceneModel->sync();
         if (m_console) m_console->append("[DEL] Удалён: " + name);
     } else {
         if (m_console) m_console->append("[DEL] Не удалось удалить: " + name);
@@ -1353,13 +1113,15 @@ void MainWindow::onDeleteSelected() {
 }
 
 void MainWindow::onExportSelectedObj() {
-    auto sel = m_glWidget->getSelectedObject();
+    const Entity sel = m_glWidget->getSelectedObject();
     if (!sel) { if (m_console) m_console->append("[EXPORT] Нет выбранного объекта"); return; }
-    QString path = QFileDialog::getSaveFileName(this, "Экспорт OBJ", sel->name.empty() ? "object.obj" : QString::fromStdString(sel->name) + ".obj", "OBJ Files (*.obj)");
+    const std::string &selName = m_glWidget->scene().name(sel);
+    QString path = QFileDialog::getSaveFileName(this, "Экспорт OBJ", selName.empty() ? "object.obj" : QString::fromStdString(selName) + ".obj", "OBJ Files (*.obj)");
     if (path.isEmpty()) return;
     QFile f(path);
     if (f.open(QIODevice::WriteOnly)) {
-        QByteArray data = QByteArray::fromStdString(sel->toObj());
+        const MeshComponent &mesh = m_glWidget->scene().mesh(sel);
+        QByteArray data = QByteArray::fromStdString(writeObj(mesh.vertices, mesh.faces));
         f.write(data);
         f.close();
         if (m_console) m_console->append("[EXPORT] Сохранён OBJ: " + path);
@@ -1367,16 +1129,28 @@ void MainWindow::onExportSelectedObj() {
 }
 
 void MainWindow::onSaveScreenshot() {
+    // Размер кадра не привязан к окну: рендер идёт в offscreen-FBO, крупные кадры — тайлами
+    const QSize window = m_glWidget->size() * m_glWidget->devicePixelRatio();
+    const QStringList sizes = {
+        QString("%1x%2 (окно)").arg(window.width()).arg(window.height()),
+        "1920x1080", "3840x2160", "7680x4320", "15360x8640",
+    };
+    bool ok = false;
+    const QString choice = QInputDialog::getItem(this, "Скриншот", "Разрешение:", sizes, 0, true, &ok);
+    if (!ok) return;
+    const QStringList wh = choice.section(' ', 0, 0).split('x');
+    const QSize size = wh.size() == 2 ? QSize(wh[0].toInt(), wh[1].toInt()) : QSize();
+    if (size.isEmpty()) { if (m_console) m_console->append("[SHOT] Неверное разрешение: " + choice); return; }
     QString path = QFileDialog::getSaveFileName(this, "Сохранить скриншот", "screenshot.png", "PNG (*.png)");
     if (path.isEmpty()) return;
-    QImage img = m_glWidget->grabFramebuffer();
-    if (!img.isNull()) {
-        if (img.save(path)) {
-            if (m_console) m_console->append("[SHOT] Скриншот: " + path);
-        } else {
-            if (m_console) m_console->append("[SHOT] Ошибка сохранения: " + path);
-        }
-    }
+
+    const QMatrix4x4 projection = m_glWidget->projectionFor(float(size.width()) / size.height());
+    m_renderService->renderToFile(path, size, m_glWidget->cameraView(), projection,
+                                  [this](Renderer &renderer){ m_glWidget->drawScene(renderer); });
+    // Копии мешей в offscreen-контексте нужны только этому кадру
+    std::vector<uint64_t> keys;
+    for (const RenderComponent &r : m_glWidget->scene().renders()) keys.push_back(r.meshKey);
+    m_renderService->releaseMeshes(keys);
 }
 
 void MainWindow::onPause() {
@@ -13,43 +13,30 @@
 #include <QTimer>
 #include <QLabel>
 #include <QTreeWidget>
+#include <QTreeView>
 #include <memory>
 #include <vector>
 #include <string>
 #include <QFormLayout>
 #include <QDoubleSpinBox>
+#include <QComboBox>
 #include <QElapsedTimer>
 #include "ModelEditor.hpp"
 #include "CodePanel.hpp"
-
-struct Vertex { float x, y, z; };
-struct Face { std::vector<int> indices; };
-
-class SceneObject {
-public:
-    std::string name;
-    float x = 0.0f, y = 0.0f, z = 0.0f;
-    float rx = 0.0f, ry = 0.0f, rz = 0.0f;
-    float sx = 1.0f, sy = 1.0f, sz = 1.0f;
-    float r = 0.75f, g = 0.8f, b = 1.0f;
-    std::vector<Vertex> vertices;
-    std::vector<Face> faces;
-
-    SceneObject(const std::string& objData, const std::string& name = "Object");
-    void loadFromObj(const std::string& objData);
-    void draw();
-    void drawForPicking();
-    std::string toObj() const;
-    void getAABB(Vertex &minV, Vertex &maxV) const {
-        if (vertices.empty()) { minV = {0,0,0}; maxV = {0,0,0}; return; }
-        minV = {vertices[0].x, vertices[0].y, vertices[0].z};
-        maxV = minV;
-        for (const auto &v : vertices) {
-            if (v.x < minV.x) minV.x = v.x; if (v.y < minV.y) minV.y = v.y; if (v.z < minV.z) minV.z = v.z;
-            if (v.x > maxV.x) maxV.x = v.x; if (v.y > maxV.y) maxV.y = v.y; if (v.z > maxV.z) maxV.z = v.z;
-        }
-    }
-};
+#include "GameExporter.hpp"
+#include "SceneLoader.hpp"
+#include "SceneTreeModel.hpp"
+#include "RenderService.hpp"
+#include "ThumbnailCache.hpp"
+#include "AssetBrowser.hpp"
+#include "AssetPipeline.hpp"
+#include "ModelReceiver.hpp"
+#include "InspectorBinding.hpp"
+#include "core/Renderer.hpp"
+#include "core/Scene.hpp"
+#include "core/SceneStore.hpp"
+#include "core/TransformHierarchy.hpp"
+#include "core/ViewportOverlay.hpp"
 
 class GLWidget : public QOpenGLWidget, protected QOpenGLFunctions {
     Q_OBJECT
@@ -57,18 +44,35 @@ class GLWidget : public QOpenGLWidget, protected QOpenGLFunctions {
 public:
     explicit GLWidget(QWidget *parent = nullptr);
     void addObject(const std::string& objData, const std::string& name = "Object");
+    Entity addObject(SceneObject&& object);
+    void addObjects(SceneObjectList&& objects) { m_scene.adopt(std::move(objects)); update(); }
     bool removeSelectedObject();
-    size_t getObjectCount() const { return m_objects.size(); }
-    SceneObject* getSelectedObject() const { return m_selectedObject; }
-    void clearObjects() { m_objects.clear(); m_selectedObject = nullptr; update(); }
-    const std::vector<std::unique_ptr<SceneObject>>& objects() const { return m_objects; }
+    size_t getObjectCount() const { return m_scene.size(); }
+    Entity getSelectedObject() const { return m_scene.alive(m_selected) ? m_selected : Entity{}; }
+    // Выбор не из вьюпорта (дерево иерархии); шлёт objectSelected
+    void selectEntity(Entity e);
+    void clearObjects() { m_scene.clear(); m_selected = Entity{}; update(); }
+    // Переимпортированный ассет: новый меш всем его объектам; сколько обновлено
+    size_t reloadAsset(const std::string &asset, const std::vector<Vertex> &vertices, const std::vector<Face> &faces) {
+        const size_t n = m_scene.setAssetMesh(asset, vertices, faces);
+        if (n) update();
+        return n;
+    }
+    SceneStore& scene() { return m_scene; }
+    const SceneStore& scene() const { return m_scene; }
     void setWireframe(bool on) { m_wireframe = on; update(); }
     void setOrtho(bool on) { m_ortho = on; setupProjection(); update(); }
+    void setInfiniteGrid(bool on) { m_overlay.setGridMode(on ? ViewportOverlay::GridMode::Infinite : ViewportOverlay::GridMode::Lines); update(); }
     void zoomIn();
     void zoomOut();
     void resetView();
     void frameAll();
     int currentFPS() const { return m_lastFps; }
+    // Камера вьюпорта для кадра другого соотношения сторон (рендер в файл)
+    QMatrix4x4 cameraView() const { return viewMatrix(); }
+    QMatrix4x4 projectionFor(float aspect) const;
+    // Объекты сцены без сетки и рамки выбора — в чужой Renderer
+    void drawScene(Renderer &renderer);
 
 signals:
     void objectSelected(const std::string& name);
@@ -90,6 +94,7 @@ protected:
 
 private:
     void setupProjection();
+    QMatrix4x4 viewMatrix() const;
     void selectObject(const QPoint& pos);
     void drawSelectedBoundingBox();
     void updateFpsCounter();
@@ -113,8 +118,13 @@ private:
     int m_frameCount = 0;
     int m_lastFps = 0;
 
-    std::vector<std::unique_ptr<SceneObject>> m_objects;
-    SceneObject* m_selectedObject = nullptr;
+    Renderer m_renderer;
+    TransformHierarchy m_transforms;
+    QMatrix4x4 m_projection;
+    ViewportOverlay m_overlay;
+
+    SceneStore m_scene;
+    Entity m_selected;
 };
 
 class MainWindow : public QMainWindow {
@@ -127,12 +137,14 @@ private slots:
     void onRun();
     void onPause();
     void onStop();
-    void checkForModel();
+    void onModelReceived(std::shared_ptr<SceneObject> model);
     void onNewScene();
     void onOpenScene();
     void onSaveScene();
     void onSaveSession();
     void onLoadSession();
+    void onSceneLoaded(SceneLoader::Kind kind, const QString &path, std::shared_ptr<SceneObjectList> objects,
+                       const QJsonObject &root, qint64 elapsedMs);
     void onBuildGame();
     void onDuplicateSelected();
     void onDeleteSelected();
@@ -145,7 +157,7 @@ private:
     void setupConsole();
     void setupStatusBar();
     QWidget* createInspector();
-    void bindInspector(SceneObject* object);
+    void bindInspector(Entity entity);
 
     QToolBar *m_toolbar = nullptr;
     QTabWidget *m_tabWidget = nullptr; // верхние вкладки (Сцена/Редактор/Модели)
@@ -153,16 +165,26 @@ private:
     QStatusBar *m_statusBar = nullptr;
     QLabel *m_statusLabel = nullptr;
     GLWidget *m_glWidget = nullptr;
-    QTimer *m_modelTimer = nullptr;
-    QTreeWidget *m_sceneTree = nullptr;
+    ModelReceiver *m_modelReceiver = nullptr;
+    GameExporter *m_exporter = nullptr;
+    SceneLoader *m_sceneLoader = nullptr;
+    RenderService *m_renderService = nullptr;
+    ThumbnailCache *m_thumbnailCache = nullptr;
+    AssetBrowser *m_assetBrowser = nullptr;
+    AssetPipeline *m_assets = nullptr;
+    QTreeView *m_sceneTree = nullptr;
+    SceneTreeModel *m_sceneModel = nullptr;
     QTreeWidget *m_projectTree = nullptr;
     QTabWidget *m_viewTabs = nullptr; // вкладки Scene/Game
+    MeshEncoding m_meshEncoding = MeshEncoding::Obj; // как .scene/.session хранят меши
     // Inspector
     QWidget *m_inspector = nullptr;
     QDoubleSpinBox *m_posX = nullptr; QDoubleSpinBox *m_posY = nullptr; QDoubleSpinBox *m_posZ = nullptr;
     QDoubleSpinBox *m_rotX = nullptr; QDoubleSpinBox *m_rotY = nullptr; QDoubleSpinBox *m_rotZ = nullptr;
     QDoubleSpinBox *m_sclX = nullptr; QDoubleSpinBox *m_sclY = nullptr; QDoubleSpinBox *m_sclZ = nullptr;
     QPushButton *m_colorBtn = nullptr;
+    QComboBox *m_parentCombo = nullptr;
+    InspectorBinding *m_inspectorBinding = nullptr;
 };
 
 #endif // MAINWINDOW_HPP
@@ -1,4 +1,5 @@
 #include "ModelEditor.hpp"
+#include "core/Engine3D.hpp"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QToolBar>
@@ -11,46 +12,71 @@
 #include <QMimeData>
 #include <QDragEnterEvent>
 #include <QDropEvent>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <algorithm>
 #include <cmath>
 
 MeshEditorViewport::MeshEditorViewport(QWidget *parent) : QOpenGLWidget(parent) {
     setFocusPolicy(Qt::StrongFocus);
     setAcceptDrops(true);
+    m_overlay.setGrid(10.0f, 1.0f, QVector3D(0.25f, 0.25f, 0.3f));
+    m_overlay.setAxesLength(0.0f);
+    m_objMap.reset("", 0, m_vertices, m_faces);
 }
 
-void MeshEditorViewport::setData(std::vector<MEVertex> verts, std::vector<MEFace> faces) {
-    m_vertices = std::move(verts);
-    m_faces = std::move(faces);
+void MeshEditorViewport::setData(std::vector<Vertex> verts, std::vector<Face> faces) {
+    // Соответствие строк строится по тексту, который вернёт toObj()
+    const std::string text = writeObj(verts, faces);
+    m_objMap.reset(text.data(), text.size(), m_vertices, m_faces);
+    topologyChanged();
     update();
 }
 
-void MeshEditorViewport::clear() { m_vertices.clear(); m_faces.clear(); update(); }
+void MeshEditorViewport::clear() { m_objMap.reset("", 0, m_vertices, m_faces); topologyChanged(); update(); }
 
-QString MeshEditorViewport::toObj() const {
-    QString out;
-    for (const auto &v : m_vertices) out += QString("v %1 %2 %3\n").arg(v.x).arg(v.y).arg(v.z);
-    for (const auto &f : m_faces) {
-        if (f.indices.size()<3) continue;
-        out += "f";
-        for (int idx : f.indices) out += QString(" %1").arg(idx+1);
-        out += "\n";
-    }
-    return out;
+void MeshEditorViewport::topologyChanged() {
+    m_topologyStale = true;
+    m_meshKey = Renderer::newMeshKey();
+    m_overlayStale = true;
+    m_dirtyVertices.clear();
+    m_picker.invalidate();
+    m_selectedVertex = -1;
+    m_selectedEdge = -1;
 }
 
-void MeshEditorViewport::fromObj(const QString &objText) {
-    m_vertices.clear(); m_faces.clear();
-    QTextStream in(const_cast<QString*>(&objText), QIODevice::ReadOnly);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed(); if (line.isEmpty()) continue;
-        auto parts = line.split(' ', Qt::SkipEmptyParts);
-        if (parts.isEmpty()) continue;
-        if (parts[0]=="v" && parts.size()>=4) {
-            m_vertices.push_back({parts[1].toFloat(), parts[2].toFloat(), parts[3].toFloat()});
-        } else if (parts[0]=="f" && parts.size()>=4) {
-            MEFace f; for (int i=1;i<parts.size();++i){ auto tok=parts[i].split('/')[0]; int idx=tok.toInt(); if (idx>0) f.indices.push_back(idx-1);} if (f.indices.size()>=3) m_faces.push_back(std::move(f));
+void MeshEditorViewport::ensureTopology() {
+    if (!m_topologyStale) return;
+    m_topology.build(m_vertices.size(), m_faces);
+    m_topologyStale = false;
+}
+
+void MeshEditorViewport::replaceObjLines(int first, int removed, const std::vector<std::string> &lines) {
+    const ObjLineMap::Patch patch = m_objMap.replaceLines(first, removed, lines, m_vertices, m_faces);
+    if (patch.structural) {
+        topologyChanged();
+    } else {
+        for (uint32_t v : patch.moved) {
+            if (!m_topologyStale) m_picker.moveVertex(v, m_vertices[v], m_topology);
+            markDirty((int)v);
         }
     }
+    if (patch.structural || !patch.moved.empty()) update();
+}
+
+void MeshEditorViewport::markDirty(int v) {
+    if (v >= 0 && v < (int)m_vertices.size()) m_dirtyVertices.push_back(static_cast<uint32_t>(v));
+}
+
+QString MeshEditorViewport::toObj() const {
+    return QString::fromStdString(writeObj(m_vertices, m_faces));
+}
+
+void MeshEditorViewport::fromObj(const QString &objText) {
+    const QByteArray data = objText.toUtf8();
+    m_objMap.reset(data.constData(), static_cast<size_t>(data.size()), m_vertices, m_faces);
+    topologyChanged();
     update();
 }
 
@@ -58,60 +84,136 @@ void MeshEditorViewport::initializeGL() {
     initializeOpenGLFunctions();
     glClearColor(0.1f,0.12f,0.16f,1);
     glEnable(GL_DEPTH_TEST);
+    m_renderer.initialize();
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, [this]{ makeCurrent(); m_renderer.cleanup(); doneCurrent(); });
 }
 
 void MeshEditorViewport::resizeGL(int w, int h) { glViewport(0,0,w,h); }
 
+QMatrix4x4 MeshEditorViewport::projectionMatrix() const {
+    float aspect = float(std::max(1,width()))/std::max(1,height());
+    return makePerspective(60.0f, aspect, 0.1f, 1000.0f);
+}
+
+QMatrix4x4 MeshEditorViewport::viewMatrix() const {
+    return makeOrbitView(m_rotX, m_rotY, -m_camX, -m_camY, m_camZ);
+}
+
 void MeshEditorViewport::drawGrid() {
-    glDisable(GL_LIGHTING);
-    glColor3f(0.25f,0.25f,0.3f);
-    glBegin(GL_LINES);
-    float size=10.0f; for (int i=-10;i<=10;++i){ glVertex3f((float)i,0,-size); glVertex3f((float)i,0,size); glVertex3f(-size,0,(float)i); glVertex3f(size,0,(float)i);} glEnd();
+    m_overlay.drawGrid(m_renderer);
+}
+
+ColorVertex MeshEditorViewport::overlayVertex(size_t i) const {
+    const Vertex &v = m_vertices[i];
+    if ((int)i == m_selectedVertex) return {v.x, v.y, v.z, 1.0f, 0.4f, 0.2f};
+    return {v.x, v.y, v.z, 1.0f, 1.0f, 1.0f};
+}
+
+void MeshEditorViewport::syncOverlay() {
+    if (m_overlayStale || !m_renderer.hasColorBuffer(m_pointsKey)) {
+        std::vector<ColorVertex> points(m_vertices.size());
+        for (size_t i = 0; i < points.size(); ++i) points[i] = overlayVertex(i);
+        m_renderer.uploadColorBuffer(m_pointsKey, points, m_topology.edgeIndexPairs());
+        m_overlayStale = false;
+        m_dirtyVertices.clear();
+        return;
+    }
+    if (m_dirtyVertices.empty()) return;
+    // Соседние грязные вершины сливаются в один диапазон, далёкие — отдельные заливки
+    std::sort(m_dirtyVertices.begin(), m_dirtyVertices.end());
+    m_dirtyVertices.erase(std::unique(m_dirtyVertices.begin(), m_dirtyVertices.end()), m_dirtyVertices.end());
+    std::vector<ColorVertex> run;
+    size_t i = 0;
+    while (i < m_dirtyVertices.size()) {
+        const uint32_t first = m_dirtyVertices[i];
+        uint32_t last = first;
+        while (i + 1 < m_dirtyVertices.size() && m_dirtyVertices[i + 1] - last <= 32) last = m_dirtyVertices[++i];
+        ++i;
+        run.clear();
+        for (uint32_t v = first; v <= last; ++v) run.push_back(overlayVertex(v));
+        m_renderer.updateColorBuffer(m_pointsKey, first, run.data(), run.size());
+        m_renderer.updateMeshPositions(m_meshKey, first, &m_vertices[first].x, run.size());
+    }
+    m_dirtyVertices.clear();
 }
 
 void MeshEditorViewport::drawMesh(bool filled) {
+    // Сдвинутые вершины заливаются в VBO меша до отрисовки заливки, иначе она отстаёт на кадр
+    syncOverlay();
     if (filled) {
-        glColor3f(0.7f,0.8f,1.0f);
-        glBegin(GL_TRIANGLES);
-        for (const auto &f : m_faces) { if (f.indices.size()<3) continue; for (size_t i=1;i+1<f.indices.size();++i){ int v0=f.indices[0], v1=f.indices[i], v2=f.indices[i+1]; glVertex3f(m_vertices[v0].x,m_vertices[v0].y,m_vertices[v0].z); glVertex3f(m_vertices[v1].x,m_vertices[v1].y,m_vertices[v1].z); glVertex3f(m_vertices[v2].x,m_vertices[v2].y,m_vertices[v2].z);} }
-        glEnd();
+        m_renderer.ensureMesh(m_meshKey, m_vertices, m_faces);
+        m_renderer.submit(m_meshKey, QMatrix4x4(), {RenderProgram::Unlit, QVector3D(0.7f,0.8f,1.0f)});
+        m_renderer.flush();
+    }
+    // Каждое ребро — один раз, из списка рёбер полурёберной структуры
+    m_renderer.drawLines(m_pointsKey, QMatrix4x4(), 1.0f, QVector4D(0.1f, 0.5f, 1.0f, 1.0f));
+    if (m_selectedEdge >= 0 && m_selectedEdge < (int)m_topology.edges().size()) {
+        const auto &e = m_topology.edges()[m_selectedEdge];
+        const Vertex &a = m_vertices[e.a], &b = m_vertices[e.b];
+        m_renderer.drawLines({{a.x, a.y, a.z, 1.0f, 0.4f, 0.2f}, {b.x, b.y, b.z, 1.0f, 0.4f, 0.2f}}, QMatrix4x4(), 3.0f);
     }
-    glColor3f(0.1f,0.5f,1.0f);
-    glBegin(GL_LINES);
-    for (const auto &f : m_faces) {
-        if (f.indices.size()<2) continue;
-        for (size_t i=0;i<f.indices.size();++i){ int a=f.indices[i], b=f.indices[(i+1)%f.indices.size()]; glVertex3f(m_vertices[a].x,m_vertices[a].y,m_vertices[a].z); glVertex3f(m_vertices[b].x,m_vertices[b].y,m_vertices[b].z);} }
-    glEnd();
+    m_renderer.drawPoints(m_pointsKey, 6.0f);
+}
 
-    // vertices
-    glPointSize(6.0f);
-    glBegin(GL_POINTS);
-    for (int i=0;i<(int)m_vertices.size();++i){ if (i==m_selectedVertex) glColor3f(1,0.4f,0.2f); else glColor3f(1,1,1); glVertex3f(m_vertices[i].x,m_vertices[i].y,m_vertices[i].z);} glEnd();
+void MeshEditorViewport::ensurePicker() {
+    ensureTopology();
+    m_picker.setView(projectionMatrix() * viewMatrix(), width(), height());
+    if (!m_picker.isValid()) m_picker.rebuild(m_vertices, m_topology);
 }
 
 int MeshEditorViewport::pickVertex(const QPoint &p) {
-    Q_UNUSED(p); return -1;
+    ensurePicker();
+    const uint32_t v = m_picker.pickVertex(p, PickRadiusPx);
+    return v == ScreenPicker::None ? -1 : (int)v;
+}
+
+int MeshEditorViewport::pickEdge(const QPoint &p) {
+    ensurePicker();
+    const uint32_t e = m_picker.pickEdge(p, PickRadiusPx);
+    return e == ScreenPicker::None ? -1 : (int)e;
 }
 
 void MeshEditorViewport::paintGL() {
     glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
-    glMatrixMode(GL_PROJECTION); glLoadIdentity();
-    float aspect = float(std::max(1,width()))/std::max(1,height()); float zNear=0.1f, zFar=1000.0f; float fov=60.0f; float f=1.0f/std::tan((fov*M_PI/180.0f)/2.0f); float top=zNear/f; float right=top*aspect; glFrustum(-right,right,-top,top,zNear,zFar);
-    glMatrixMode(GL_MODELVIEW); glLoadIdentity();
-    glRotatef(-m_rotX,1,0,0); glRotatef(-m_rotY,0,1,0); glTranslatef(-m_camX,-m_camY,m_camZ);
+    m_renderer.beginFrame(viewMatrix(), projectionMatrix());
+    ensureTopology();
     drawGrid();
     drawMesh(true);
 }
 
-void MeshEditorViewport::mousePressEvent(QMouseEvent *e) { m_last = e->position().toPoint(); update(); }
+void MeshEditorViewport::mousePressEvent(QMouseEvent *e) {
+    m_last = e->position().toPoint();
+    if (e->button() == Qt::LeftButton) {
+        markDirty(m_selectedVertex);
+        m_selectedVertex = pickVertex(m_last);
+        m_selectedEdge = m_selectedVertex >= 0 ? -1 : pickEdge(m_last);
+        markDirty(m_selectedVertex);
+        if (m_selectedVertex >= 0) {
+            const auto degree = m_topology.vertexEdgesEnd(m_selectedVertex) - m_topology.vertexEdgesBegin(m_selectedVertex);
+            emit status(QString("Вершина %1, рёбер: %2").arg(m_selectedVertex).arg(degree));
+        } else if (m_selectedEdge >= 0) {
+            const auto &edge = m_topology.edges()[m_selectedEdge];
+            emit status(QString("Ребро %1–%2").arg(edge.a).arg(edge.b));
+        }
+    }
+    update();
+}
 void MeshEditorViewport::mouseMoveEvent(QMouseEvent *e) {
     QPoint d = e->position().toPoint() - m_last;
     if (e->buttons() & Qt::MiddleButton) { m_rotX += d.y()*0.5f; m_rotY += d.x()*0.5f; }
     else if (e->buttons() & Qt::LeftButton) {
         if (m_selectedVertex>=0 && m_selectedVertex < (int)m_vertices.size()) {
-            float s = 0.01f * std::fabs(m_camZ);
-            m_vertices[m_selectedVertex].x += d.x()*s;
-            m_vertices[m_selectedVertex].y -= d.y()*s;
+            // Сдвиг в плоскости экрана на глубине вершины
+            const QMatrix4x4 vp = projectionMatrix() * viewMatrix();
+            Vertex &v = m_vertices[m_selectedVertex];
+            QVector3D ndc = vp.map(QVector3D(v.x, v.y, v.z));
+            ndc.setX(ndc.x() + 2.0f * d.x() / std::max(1, width()));
+            ndc.setY(ndc.y() - 2.0f * d.y() / std::max(1, height()));
+            const QVector3D w = vp.inverted().map(ndc);
+            v = {w.x(), w.y(), w.z()};
+            m_picker.moveVertex(m_selectedVertex, v, m_topology);
+            markDirty(m_selectedVertex);
+            emit vertexMoved(m_selectedVertex);
         }
     }
     m_last = e->position().toPoint(); update();
@@ -131,9 +233,9 @@ void MeshEditorViewport::dragEnterEvent(QDragEnterEvent *event) {
 }
 
 void MeshEditorViewport::dropEvent(QDropEvent *event) {
-    if (event->mimeData()->hasText()) { fromObj(event->mimeData()->text()); return; }
+    if (event->mimeData()->hasText()) { emit objDropped(event->mimeData()->text()); return; }
     if (event->mimeData()->hasUrls()) {
-        for (const auto &u : event->mimeData()->urls()) { QString p=u.toLocalFile(); if (!p.endsWith(".obj", Qt::CaseInsensitive)) continue; QFile f(p); if (f.open(QIODevice::ReadOnly)) { QString t=QString::fromUtf8(f.readAll()); f.close(); fromObj(t); return; } }
+        for (const auto &u : event->mimeData()->urls()) { QString p=u.toLocalFile(); if (!p.endsWith(".obj", Qt::CaseInsensitive)) continue; QFile f(p); if (f.open(QIODevice::ReadOnly)) { QString t=QString::fromUtf8(f.readAll()); f.close(); emit objDropped(t); return; } }
     }
 }
 
@@ -145,8 +247,9 @@ ModelEditor::ModelEditor(QWidget *parent) : QWidget(parent) {
     layout->addWidget(splitter);
     m_view = new MeshEditorViewport();
     splitter->addWidget(m_view);
-    m_code = new QTextEdit();
+    m_code = new QPlainTextEdit();
     m_code->setPlaceholderText("OBJ-код модели");
+    m_code->setLineWrapMode(QPlainTextEdit::NoWrap);
     splitter->addWidget(m_code);
     splitter->setStretchFactor(0,3); splitter->setStretchFactor(1,2);
 
@@ -157,18 +260,87 @@ ModelEditor::ModelEditor(QWidget *parent) : QWidget(parent) {
     auto toSceneA = toolbar->addAction("Вставить в сцену");
 
     QObject::connect(newPrim, &QAction::triggered, this, [this]{
-        std::vector<MEVertex> v = {{-0.5f,-0.5f,-0.5f},{0.5f,-0.5f,-0.5f},{0.5f,0.5f,-0.5f},{-0.5f,0.5f,-0.5f},{-0.5f,-0.5f,0.5f},{0.5f,-0.5f,0.5f},{0.5f,0.5f,0.5f},{-0.5f,0.5f,0.5f}};
-        std::vector<MEFace> f = {{{0,1,2}},{{0,2,3}},{{4,7,6}},{{4,6,5}},{{0,4,5}},{{0,5,1}},{{3,2,6}},{{3,6,7}},{{0,3,7}},{{0,7,4}},{{1,5,6}},{{1,6,2}}};
-        m_view->setData(std::move(v), std::move(f));
-        m_code->setPlainText(m_view->toObj());
+        std::vector<Vertex> v = {{-0.5f,-0.5f,-0.5f},{0.5f,-0.5f,-0.5f},{0.5f,0.5f,-0.5f},{-0.5f,0.5f,-0.5f},{-0.5f,-0.5f,0.5f},{0.5f,-0.5f,0.5f},{0.5f,0.5f,0.5f},{-0.5f,0.5f,0.5f}};
+        std::vector<Face> f = {{{0,1,2}},{{0,2,3}},{{4,7,6}},{{4,6,5}},{{0,4,5}},{{0,5,1}},{{3,2,6}},{{3,6,7}},{{0,3,7}},{{0,7,4}},{{1,5,6}},{{1,6,2}}};
+        loadText(QString::fromStdString(writeObj(v, f)));
     });
     QObject::connect(importA, &QAction::triggered, this, [this]{
-        QString p = QFileDialog::getOpenFileName(this, "Импорт OBJ", "", "OBJ Files (*.obj)"); if (p.isEmpty()) return; QFile f(p); if (!f.open(QIODevice::ReadOnly)) return; QString t = QString::fromUtf8(f.readAll()); f.close(); m_view->fromObj(t); m_code->setPlainText(t);
+        QString p = QFileDialog::getOpenFileName(this, "Импорт OBJ", "", "OBJ Files (*.obj)"); if (p.isEmpty()) return; QFile f(p); if (!f.open(QIODevice::ReadOnly)) return; QString t = QString::fromUtf8(f.readAll()); f.close(); loadText(t);
     });
     QObject::connect(exportA, &QAction::triggered, this, [this]{
         QString p = QFileDialog::getSaveFileName(this, "Экспорт OBJ", "model.obj", "OBJ Files (*.obj)"); if (p.isEmpty()) return; QFile f(p); if (f.open(QIODevice::WriteOnly)) { auto t = m_view->toObj(); f.write(t.toUtf8()); f.close(); }
     });
-    QObject::connect(applyA, &QAction::triggered, this, [this]{ m_view->fromObj(m_code->toPlainText()); });
+    // Текст и вид синхронизируются построчно; кнопка — полный разбор на всякий случай
+    QObject::connect(applyA, &QAction::triggered, this, [this]{ flushVertexLines(); m_view->fromObj(m_code->toPlainText()); });
     QObject::connect(toSceneA, &QAction::triggered, this, [this]{ emit sendToScene(m_view->toObj(), "EditedModel"); });
+
+    connect(m_code->document(), &QTextDocument::contentsChange, this, &ModelEditor::onContentsChange);
+    connect(m_view, &MeshEditorViewport::objDropped, this, &ModelEditor::loadText);
+    m_writeBack.setSingleShot(true);
+    connect(&m_writeBack, &QTimer::timeout, this, &ModelEditor::flushVertexLines);
+    connect(m_view, &MeshEditorViewport::vertexMoved, this, [this](int v){
+        m_pendingVertices.push_back(v);
+        if (!m_writeBack.isActive()) m_writeBack.start(16);
+    });
+}
+
+void ModelEditor::loadText(const QString &text) {
+    m_writeBack.stop();
+    m_pendingVertices.clear();
+    m_syncing = true;
+    m_code->setPlainText(text);
+    m_syncing = false;
+    m_lineCount = m_code->document()->blockCount();
+    m_view->fromObj(text);
+}
+
+void ModelEditor::onContentsChange(int position, int charsRemoved, int charsAdded) {
+    Q_UNUSED(charsRemoved);
+    if (m_syncing) return;
+    // Правка текста важнее отложенной записи: номера вершин в очереди относятся
+    // к тексту до правки и после неё могут указывать на чужие строки
+    m_writeBack.stop();
+    m_pendingVertices.clear();
+    QTextDocument *doc = m_code->document();
+    // Затронутые блоки после правки; сколько их было до — по разнице числа блоков
+    const QTextBlock firstBlock = doc->findBlock(position);
+    QTextBlock lastBlock = doc->findBlock(position + charsAdded);
+    if (!lastBlock.isValid()) lastBlock = doc->lastBlock();
+    const int first = firstBlock.isValid() ? firstBlock.blockNumber() : 0;
+    const int newCount = doc->blockCount();
+    const int added = lastBlock.blockNumber() - first + 1;
+    const int removed = added - (newCount - m_lineCount);
+    m_lineCount = newCount;
+
+    std::vector<std::string> lines;
+    lines.reserve(static_cast<size_t>(added));
+    for (QTextBlock b = doc->findBlockByNumber(first); b.isValid() && b.blockNumber() <= lastBlock.blockNumber(); b = b.next()) {
+        lines.push_back(b.text().toStdString());
+    }
+    m_view->replaceObjLines(first, removed, lines);
+}
+
+void ModelEditor::flushVertexLines() {
+    m_writeBack.stop();
+    if (m_pendingVertices.empty()) return;
+    std::sort(m_pendingVertices.begin(), m_pendingVertices.end());
+    m_pendingVertices.erase(std::unique(m_pendingVertices.begin(), m_pendingVertices.end()), m_pendingVertices.end());
+
+    // Переписываются только строки v сдвинутых вершин, одним шагом отмены
+    QTextDocument *doc = m_code->document();
+    QTextCursor cursor(doc);
+    m_syncing = true;
+    cursor.beginEditBlock();
+    for (int v : m_pendingVertices) {
+        if (v < 0 || v >= m_view->vertexCount()) continue;
+        const QTextBlock block = doc->findBlockByNumber(m_view->objLineOfVertex(v));
+        if (!block.isValid()) continue;
+        cursor.setPosition(block.position());
+        cursor.setPosition(block.position() + block.length() - 1, QTextCursor::KeepAnchor);
+        cursor.insertText(QString::fromStdString(m_view->objVertexText(v)));
+    }
+    cursor.endEditBlock();
+    m_syncing = false;
+    m_pendingVertices.clear();
 }
 
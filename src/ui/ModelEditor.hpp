@@ -3,27 +3,42 @@
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
 #include <QToolBar>
-#include <QTextEdit>
+#include <QPlainTextEdit>
+#include <QTimer>
 #include <QSplitter>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <vector>
-
-struct MEVertex { float x, y, z; };
-struct MEFace { std::vector<int> indices; };
+#include "core/Mesh.hpp"
+#include "core/Renderer.hpp"
+#include "core/ViewportOverlay.hpp"
+#include "core/HalfEdgeMesh.hpp"
+#include "core/ScreenPicker.hpp"
+#include "core/ObjLineMap.hpp"
 
 class MeshEditorViewport : public QOpenGLWidget, protected QOpenGLFunctions {
     Q_OBJECT
 public:
     explicit MeshEditorViewport(QWidget *parent=nullptr);
-    void setData(std::vector<MEVertex> verts, std::vector<MEFace> faces);
+    void setData(std::vector<Vertex> verts, std::vector<Face> faces);
     void clear();
     QString toObj() const;
+    // Полный разбор; заодно строится соответствие строк текста вершинам/граням
     void fromObj(const QString &objText);
+    // Правка текста: строки [first, first + removed) заменены на lines.
+    // Разбираются только они; сдвиг вершин без смены состава не трогает топологию.
+    void replaceObjLines(int first, int removed, const std::vector<std::string> &lines);
+    int vertexCount() const { return static_cast<int>(m_vertices.size()); }
+    int objLineOfVertex(int v) const { return (int)m_objMap.vertexLine(static_cast<uint32_t>(v)); }
+    std::string objVertexText(int v) const { return writeObjVertex(m_vertices[v]); }
 signals:
     void status(const QString &msg);
+    // Вершина сдвинута во вьюпорте — её строку в тексте надо обновить
+    void vertexMoved(int index);
+    // Брошенный OBJ: текст редактора и вид загружаются вместе
+    void objDropped(const QString &objText);
 protected:
     void initializeGL() override;
     void resizeGL(int w, int h) override;
@@ -34,16 +49,43 @@ protected:
     void dragEnterEvent(QDragEnterEvent *event) override;
     void dropEvent(QDropEvent *event) override;
 private:
+    static constexpr float PickRadiusPx = 8.0f;
+
     void drawGrid();
     void drawMesh(bool filled);
+    // Индекс под курсором или -1; экранный индекс пересобирается при смене ракурса
     int pickVertex(const QPoint &p);
+    int pickEdge(const QPoint &p);
+    void ensurePicker();
+    // Состав вершин или грани изменились: топология, буферы и индекс выбора —
+    // заново, но лениво, один раз к ближайшему кадру или выбору
+    void topologyChanged();
+    void ensureTopology();
+    // Вершина сдвинута или перекрашена: в кадре перезальётся только её диапазон
+    void markDirty(int v);
+    void syncOverlay();
+    ColorVertex overlayVertex(size_t i) const;
+    QMatrix4x4 viewMatrix() const;
+    QMatrix4x4 projectionMatrix() const;
 private:
-    std::vector<MEVertex> m_vertices;
-    std::vector<MEFace> m_faces;
+    Renderer m_renderer;
+    ViewportOverlay m_overlay;
+    std::vector<Vertex> m_vertices;
+    std::vector<Face> m_faces;
+    ObjLineMap m_objMap;
+    HalfEdgeMesh m_topology;
+    bool m_topologyStale = true;
+    ScreenPicker m_picker;
+    uint64_t m_meshKey = Renderer::newMeshKey();
+    // Точки и рёбра — один буфер вершин, рёбра по индексам из m_topology
+    uint64_t m_pointsKey = Renderer::newMeshKey();
+    bool m_overlayStale = true;
+    std::vector<uint32_t> m_dirtyVertices;
     float m_camX=0, m_camY=0, m_camZ=-5;
     float m_rotX=20, m_rotY=30;
     QPoint m_last;
     int m_selectedVertex=-1;
+    int m_selectedEdge=-1;
 };
 
 class ModelEditor : public QWidget {
@@ -51,10 +93,21 @@ class ModelEditor : public QWidget {
 public:
     explicit ModelEditor(QWidget *parent=nullptr);
     QString exportObj() const { return m_view->toObj(); }
-    void importObj(const QString &obj) { m_view->fromObj(obj); }
+    void importObj(const QString &obj) { loadText(obj); }
 signals:
     void sendToScene(const QString &objText, const QString &name);
 private:
+    // Текст и вид целиком; один разбор
+    void loadText(const QString &text);
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+    // Строки сдвинутых во вьюпорте вершин переписываются пачкой раз в кадр
+    void flushVertexLines();
+
     MeshEditorViewport *m_view;
-    QTextEdit *m_code;
+    // QPlainTextEdit раскладывает только видимые блоки, без переноса строк — большой OBJ не тормозит
+    QPlainTextEdit *m_code;
+    int m_lineCount = 1;
+    bool m_syncing = false; // текст правится из вьюпорта — contentsChange не разбирать
+    std::vector<int> m_pendingVertices;
+    QTimer m_writeBack;
 };
@@ -0,0 +1,114 @@
+#include "ModelReceiver.hpp"
+#include "core/Mesh.hpp"
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QtEndian>
+
+namespace {
+constexpr int kHeaderSize = 5;
+// Защита от мусора в канале: больше этого модель не принимаем
+constexpr quint32 kMaxModelBytes = 256u * 1024u * 1024u;
+}
+
+ModelReceiver::ModelReceiver(QObject *parent) : QObject(parent) {
+    m_pool.setMaxThreadCount(2);
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    // Имя с pid — остаться от упавшего редактора могло только наше же, его можно убрать
+    QLocalServer::removeServer(serverName());
+    connect(m_server, &QLocalServer::newConnection, this, &ModelReceiver::onNewConnection);
+    m_server->listen(serverName());
+}
+
+ModelReceiver::~ModelReceiver() {
+    // Разбор из пула пишет в this через очередь событий — дожидаемся его до удаления
+    m_pool.waitForDone();
+}
+
+bool ModelReceiver::isListening() const {
+    return m_server->isListening();
+}
+
+QString ModelReceiver::serverName() {
+    return QString("SimpleCASCADE-models-%1").arg(QCoreApplication::applicationPid());
+}
+
+bool ModelReceiver::launchAgent() {
+    QProcess proc;
+    proc.setProgram("python3");
+    proc.setArguments({QString::fromStdString(std::string(PYTHON_DIR) + "/ai_agent.py")});
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("SIMPLECASCADE_MODEL_SOCKET", serverName());
+    proc.setProcessEnvironment(env);
+    return proc.startDetached();
+}
+
+void ModelReceiver::onNewConnection() {
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        m_connections.insert(socket, Connection());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]{ onReadyRead(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]{
+            // Хвост, пришедший вместе с закрытием, ещё не разобран
+            onReadyRead(socket);
+            m_connections.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void ModelReceiver::onReadyRead(QLocalSocket *socket) {
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) return;
+    Connection &c = it.value();
+    c.buffer.append(socket->readAll());
+
+    qsizetype pos = 0;
+    while (c.buffer.size() - pos >= kHeaderSize) {
+        const quint8 type = static_cast<quint8>(c.buffer[pos]);
+        const quint32 length = qFromLittleEndian<quint32>(c.buffer.constData() + pos + 1);
+        if (length > kMaxModelBytes || c.obj.size() + qsizetype(length) > qsizetype(kMaxModelBytes)) {
+            emit log("[AI] Слишком большая модель, соединение закрыто");
+            m_connections.erase(it);
+            socket->abort();
+            return;
+        }
+        if (c.buffer.size() - pos - kHeaderSize < qsizetype(length)) break;
+        const char *payload = c.buffer.constData() + pos + kHeaderSize;
+        switch (type) {
+        case Begin:
+            c.name = QByteArray(payload, length);
+            c.obj.clear();
+            c.inModel = true;
+            break;
+        case Data:
+            if (c.inModel) c.obj.append(payload, length);
+            break;
+        case End:
+            if (c.inModel) dispatch(std::move(c.name), std::move(c.obj));
+            c.name.clear();
+            c.obj.clear();
+            c.inModel = false;
+            break;
+        default:
+            emit log("[AI] Неизвестный кадр в канале моделей, соединение закрыто");
+            m_connections.erase(it);
+            socket->abort();
+            return;
+        }
+        pos += kHeaderSize + length;
+    }
+    c.buffer.remove(0, pos);
+}
+
+void ModelReceiver::dispatch(QByteArray name, QByteArray obj) {
+    m_pool.start([this, name = std::move(name), obj = std::move(obj)]{
+        std::vector<Vertex> vertices;
+        std::vector<Face> faces;
+        parseObj(obj.constData(), static_cast<size_t>(obj.size()), vertices, faces);
+        auto object = std::make_shared<SceneObject>(std::move(vertices), std::move(faces), name.toStdString());
+        QMetaObject::invokeMethod(this, [this, object]{ emit modelReceived(object); }, Qt::QueuedConnection);
+    });
+}
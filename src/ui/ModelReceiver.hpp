@@ -0,0 +1,51 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QThreadPool>
+#include <memory>
+#include "core/Scene.hpp"
+
+class QLocalServer;
+class QLocalSocket;
+
+// Приём моделей от ai_agent.py через локальный сокет (Unix-сокет / именованный канал).
+// Агент стримит OBJ кадрами, разбор идёт в пуле потоков, в GUI-поток приходит готовый объект.
+//
+// Кадр: u8 type, u32 length (little-endian), payload.
+//   Begin — имя модели (utf8, может быть пустым), Data — очередной кусок OBJ, End — модель целиком.
+// Каждое соединение разбирается независимо, поэтому одновременные модели не мешают друг другу.
+class ModelReceiver : public QObject {
+    Q_OBJECT
+public:
+    enum FrameType : quint8 { Begin = 1, Data = 2, End = 3 };
+
+    explicit ModelReceiver(QObject *parent=nullptr);
+    ~ModelReceiver() override;
+
+    bool isListening() const;
+    // Имя сервера уникально для процесса редактора; агенту передаётся через окружение.
+    static QString serverName();
+    // Запуск ai_agent.py с адресом сервера в SIMPLECASCADE_MODEL_SOCKET.
+    static bool launchAgent();
+
+signals:
+    void modelReceived(std::shared_ptr<SceneObject> object);
+    void log(const QString &line);
+
+private slots:
+    void onNewConnection();
+
+private:
+    struct Connection {
+        QByteArray buffer;
+        QByteArray name;
+        QByteArray obj;
+        bool inModel = false;
+    };
+    void onReadyRead(QLocalSocket *socket);
+    void dispatch(QByteArray name, QByteArray obj);
+
+    QLocalServer *m_server=nullptr;
+    QHash<QLocalSocket*, Connection> m_connections;
+    QThreadPool m_pool;
+};
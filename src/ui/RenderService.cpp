@@ -0,0 +1,141 @@
+#include "RenderService.hpp"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <algorithm>
+#include "core/SceneStore.hpp"
+#include "core/TransformHierarchy.hpp"
+
+RenderService::RenderService(QObject *parent) : QObject(parent) {}
+
+RenderService::~RenderService() {
+    // Задачи пула пишут в this через очередь событий — дожидаемся их до удаления
+    m_pool.waitForDone();
+}
+
+bool RenderService::ensureInitialized(const QString &path) {
+    if (m_renderer.isInitialized()) return true;
+    QString error;
+    if (m_renderer.initialize(&error)) return true;
+    emit failed(path, error);
+    return false;
+}
+
+bool RenderService::renderToFile(const QString &path, const QSize &size, const QMatrix4x4 &view, const QMatrix4x4 &projection,
+                                 const OffscreenRenderer::DrawFn &draw) {
+    if (!ensureInitialized(path)) return false;
+    QElapsedTimer timer;
+    timer.start();
+    const QImage image = m_renderer.render(size, view, projection, draw);
+    if (image.isNull()) {
+        emit failed(path, "Кадр не отрисован");
+        return false;
+    }
+    encode(image, path, timer.elapsed(), false);
+    return true;
+}
+
+bool RenderService::renderThumbnails(const QStringList &sources, const QString &outDir, int size) {
+    if (sources.isEmpty() || !ensureInitialized(outDir)) return false;
+    if (!outDir.isEmpty()) QDir().mkpath(outDir);
+    m_pendingThumbnails += sources.size();
+    for (const QString &source : sources) {
+        m_pool.start([this, source, outDir, size, assets = m_assetLoader]{
+            auto objects = std::make_shared<SceneObjectList>();
+            QString error;
+            QFile f(source);
+            if (!f.open(QIODevice::ReadOnly)) {
+                error = "Не удалось открыть файл";
+            } else if (source.endsWith(".scene", Qt::CaseInsensitive)) {
+                QJsonParseError parseError;
+                const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &parseError);
+                if (doc.isNull()) error = parseError.errorString();
+                else *objects = sceneFromJson(doc.object(), assets);
+            } else {
+                objects->push_back(std::make_unique<SceneObject>(f.readAll().toStdString(), QFileInfo(source).baseName().toStdString()));
+            }
+            QMetaObject::invokeMethod(this, [this, source, objects, outDir, size, error]{
+                if (!error.isEmpty()) {
+                    emit failed(source, error);
+                    thumbnailDone(false);
+                    return;
+                }
+                renderThumbnail(source, objects, outDir, size);
+            }, Qt::QueuedConnection);
+        });
+    }
+    return true;
+}
+
+void RenderService::renderThumbnail(const QString &source, std::shared_ptr<SceneObjectList> objects, const QString &outDir, int size) {
+    QElapsedTimer timer;
+    timer.start();
+    SceneStore store;
+    store.adopt(std::move(*objects));
+    TransformHierarchy worlds;
+    worlds.update(store);
+
+    // Границы — углы локальных AABB в мировых координатах
+    bool any = false;
+    QVector3D lo, hi;
+    std::vector<uint64_t> keys;
+    keys.reserve(store.size());
+    for (size_t i = 0; i < store.size(); ++i) {
+        keys.push_back(store.renders()[i].meshKey);
+        const MeshComponent &mesh = store.meshes()[i];
+        if (mesh.vertices.empty()) continue;
+        for (int c = 0; c < 8; ++c) {
+            const QVector3D p = worlds.world(i).map(QVector3D(c & 1 ? mesh.boundsMax.x : mesh.boundsMin.x,
+                                                              c & 2 ? mesh.boundsMax.y : mesh.boundsMin.y,
+                                                              c & 4 ? mesh.boundsMax.z : mesh.boundsMin.z));
+            lo = any ? QVector3D(std::min(lo.x(), p.x()), std::min(lo.y(), p.y()), std::min(lo.z(), p.z())) : p;
+            hi = any ? QVector3D(std::max(hi.x(), p.x()), std::max(hi.y(), p.y()), std::max(hi.z(), p.z())) : p;
+            any = true;
+        }
+    }
+    if (!any) {
+        emit failed(source, "Нет геометрии");
+        thumbnailDone(false);
+        return;
+    }
+
+    QMatrix4x4 view, projection;
+    OffscreenRenderer::frameBounds(lo, hi, 1.0f, view, projection);
+    const QImage image = m_renderer.render(QSize(size, size), view, projection, [&](Renderer &renderer){ store.draw(renderer, worlds); });
+    // Меши превью больше не понадобятся — не ждём вытеснения по возрасту
+    m_renderer.releaseMeshes(keys);
+    if (image.isNull()) {
+        emit failed(source, "Кадр не отрисован");
+        thumbnailDone(false);
+        return;
+    }
+    emit thumbnailReady(source, image);
+    if (outDir.isEmpty()) {
+        thumbnailDone(true);
+        return;
+    }
+    // Имя с расширением: model.obj и model.scene не затирают друг друга
+    encode(image, QDir(outDir).filePath(QFileInfo(source).fileName() + ".png"), timer.elapsed(), true);
+}
+
+void RenderService::encode(const QImage &image, const QString &path, qint64 renderMs, bool thumbnail) {
+    m_pool.start([this, image, path, renderMs, thumbnail]{
+        const bool ok = image.save(path, "PNG");
+        QMetaObject::invokeMethod(this, [this, path, renderMs, thumbnail, ok]{
+            if (ok) emit saved(path, renderMs);
+            else emit failed(path, "Не удалось записать PNG");
+            if (thumbnail) thumbnailDone(ok);
+        }, Qt::QueuedConnection);
+    }, 1);
+}
+
+void RenderService::thumbnailDone(bool ok) {
+    if (ok) ++m_renderedThumbnails;
+    else ++m_failedThumbnails;
+    if (--m_pendingThumbnails > 0) return;
+    const int rendered = m_renderedThumbnails, failedCount = m_failedThumbnails;
+    m_renderedThumbnails = m_failedThumbnails = 0;
+    emit thumbnailsFinished(rendered, failedCount);
+}
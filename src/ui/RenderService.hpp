@@ -0,0 +1,53 @@
+#pragma once
+#include <QObject>
+#include <QImage>
+#include <QStringList>
+#include <QThreadPool>
+#include <memory>
+#include "core/OffscreenRenderer.hpp"
+#include "core/Scene.hpp"
+
+// Рендер в файл и пакетные превью без окна.
+//
+// GL — только в GUI-потоке (OffscreenRenderer), всё остальное — в пуле:
+// разбор исходников превью до отрисовки и сжатие PNG после неё, так что
+// GL-поток не ждёт ни парсера, ни zlib. Итоги приходят сигналами в GUI-поток.
+class RenderService : public QObject {
+    Q_OBJECT
+public:
+    explicit RenderService(QObject *parent=nullptr);
+    ~RenderService() override;
+
+    // Кадр любого размера (крупнее предела FBO — тайлами); PNG пишется в фоне
+    bool renderToFile(const QString &path, const QSize &size, const QMatrix4x4 &view, const QMatrix4x4 &projection,
+                      const OffscreenRenderer::DrawFn &draw);
+    // Превью .obj/.scene: каждый источник — в кадре по своим границам.
+    // outDir пуст — файлы не пишутся, только thumbnailReady. false — нечего делать или нет GL
+    bool renderThumbnails(const QStringList &sources, const QString &outDir, int size = 256);
+    bool isBusy() const { return m_pendingThumbnails > 0; }
+    // GPU-копии мешей, нужных только для разового кадра
+    void releaseMeshes(const std::vector<uint64_t> &keys) { m_renderer.releaseMeshes(keys); }
+    // Меши ассетов, на которые ссылаются .scene (AssetPipeline::meshLoader)
+    void setAssetLoader(AssetMeshLoader loader) { m_assetLoader = std::move(loader); }
+
+signals:
+    void saved(const QString &path, qint64 renderMs);
+    void failed(const QString &path, const QString &error);
+    void thumbnailReady(const QString &source, const QImage &image);
+    // Все заказанные превью отрисованы и записаны
+    void thumbnailsFinished(int rendered, int failed);
+
+private:
+    bool ensureInitialized(const QString &path);
+    void renderThumbnail(const QString &source, std::shared_ptr<SceneObjectList> objects, const QString &outDir, int size);
+    // В пуле, впереди ещё не начатых разборов: готовые кадры не копятся в памяти
+    void encode(const QImage &image, const QString &path, qint64 renderMs, bool thumbnail);
+    void thumbnailDone(bool ok);
+
+    OffscreenRenderer m_renderer;
+    AssetMeshLoader m_assetLoader;
+    QThreadPool m_pool;
+    int m_pendingThumbnails = 0;
+    int m_renderedThumbnails = 0;
+    int m_failedThumbnails = 0;
+};
@@ -0,0 +1,51 @@
+#include "SceneLoader.hpp"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+
+SceneLoader::SceneLoader(QObject *parent) : QObject(parent) {
+    m_pool.setMaxThreadCount(1);
+}
+
+SceneLoader::~SceneLoader() {
+    // Задача пишет в this через очередь событий — дожидаемся её до удаления
+    m_pool.waitForDone();
+}
+
+bool SceneLoader::load(const QString &path, Kind kind) {
+    if (m_running) return false;
+    m_running = true;
+    m_pool.start([this, path, kind, assets = m_assetLoader]{
+        QElapsedTimer timer;
+        timer.start();
+        QString error;
+        QJsonObject root;
+        auto objects = std::make_shared<SceneObjectList>();
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly)) {
+            error = "Не удалось открыть файл";
+        } else {
+            QJsonParseError parseError;
+            const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &parseError);
+            f.close();
+            if (!doc.isObject()) error = "Ошибка JSON: " + parseError.errorString();
+            else root = doc.object();
+        }
+        std::vector<std::string> unresolved;
+        if (error.isEmpty()) *objects = sceneFromJson(root, assets, &unresolved);
+        QStringList missing;
+        for (const std::string &guid : unresolved) missing.append(QString::fromStdString(guid));
+        missing.removeDuplicates();
+        const qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, kind, path, objects, root, error, missing, elapsed]{
+            m_running = false;
+            if (!error.isEmpty()) {
+                emit failed(path, error);
+                return;
+            }
+            emit loaded(kind, path, objects, root, elapsed);
+            if (!missing.isEmpty()) emit assetsMissing(path, missing);
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
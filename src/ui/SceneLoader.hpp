@@ -0,0 +1,38 @@
+#pragma once
+#include <QObject>
+#include <QJsonObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <memory>
+#include "core/Scene.hpp"
+
+// Загрузка .scene/.session вне GUI-потока. Чтение файла, разбор JSON и мешей
+// (sceneFromJson — по потоку на ядро) идут в фоне; в GUI-поток приходит готовый
+// список объектов, и его добавляют в сцену и дерево одним пакетом.
+class SceneLoader : public QObject {
+    Q_OBJECT
+public:
+    enum Kind { Scene, Session };
+
+    explicit SceneLoader(QObject *parent=nullptr);
+    ~SceneLoader() override;
+
+    bool isRunning() const { return m_running; }
+    // false — предыдущая загрузка ещё идёт
+    bool load(const QString &path, Kind kind);
+    // Меши объектов-ссылок на ассеты (AssetPipeline::meshLoader)
+    void setAssetLoader(AssetMeshLoader loader) { m_assetLoader = std::move(loader); }
+
+signals:
+    // root — документ целиком, для полей кроме objects (ui сессии)
+    void loaded(SceneLoader::Kind kind, const QString &path, std::shared_ptr<SceneObjectList> objects,
+                const QJsonObject &root, qint64 elapsedMs);
+    void failed(const QString &path, const QString &error);
+    // Сцена загружена, но часть объектов осталась без меша: ассеты не нашлись, встроенной копии нет
+    void assetsMissing(const QString &path, const QStringList &guids);
+
+private:
+    AssetMeshLoader m_assetLoader;
+    QThreadPool m_pool; // один поток: разбор мешей распараллеливает sceneFromJson
+    bool m_running = false;
+};
@@ -0,0 +1,245 @@
+#include "SceneTreeModel.hpp"
+
+SceneTreeModel::SceneTreeModel(SceneStore &scene, QObject *parent)
+    : QAbstractItemModel(parent), m_scene(scene) {
+    m_scene.setChangeLog(true);
+    rebuild();
+}
+
+void SceneTreeModel::sync() {
+    const std::vector<StructureChange> changes = m_scene.takeChanges();
+    if (changes.empty()) return;
+    size_t edits = 0;
+    bool cleared = false;
+    for (const StructureChange &c : changes) {
+        if (c.kind == StructureChange::Cleared) cleared = true;
+        else if (c.kind != StructureChange::Created) ++edits;
+    }
+    if (cleared || edits > ResetThreshold) { rebuild(); return; }
+
+    for (size_t i = 0; i < changes.size();) {
+        const StructureChange &c = changes[i];
+        if (c.kind == StructureChange::Created) {
+            // Созданные подряд встают в конец верхнего уровня подряд — одна вставка на серию
+            size_t last = i;
+            while (last < changes.size() && changes[last].kind == StructureChange::Created) ++last;
+            insertCreated(changes, i, last);
+            i = last;
+            continue;
+        }
+        const uint32_t n = nodeOf(c.entity);
+        if (n != RootNode) {
+            if (c.kind == StructureChange::Destroyed) removeNode(n);
+            else reparent(n, nodeOf(c.parent));
+        }
+        ++i;
+    }
+}
+
+void SceneTreeModel::rebuild() {
+    beginResetModel();
+    m_nodes.clear();
+    m_rootChildren.clear();
+    for (size_t i = 0; i < m_scene.size(); ++i) {
+        const Entity e = m_scene.entityAt(i);
+        if (e.index >= m_nodes.size()) m_nodes.resize(e.index + 1);
+        m_nodes[e.index].entity = e;
+    }
+    const std::vector<Entity> &parents = m_scene.parents();
+    for (size_t i = 0; i < m_scene.size(); ++i) attach(m_scene.entityAt(i).index, nodeOf(parents[i]));
+    // Непустые узлы отдадут детей, когда вид их раскроет
+    for (Node &node : m_nodes) node.fetched = node.children.empty();
+    m_rootFetched = m_rootChildren.empty();
+    endResetModel();
+}
+
+void SceneTreeModel::insertCreated(const std::vector<StructureChange> &changes, size_t first, size_t last) {
+    const int row = FixedRows + static_cast<int>(m_rootChildren.size());
+    const bool visible = m_rootFetched;
+    if (visible) beginInsertRows(sceneIndex(), row, row + static_cast<int>(last - first) - 1);
+    for (size_t i = first; i < last; ++i) {
+        const Entity e = changes[i].entity;
+        if (e.index >= m_nodes.size()) m_nodes.resize(e.index + 1);
+        m_nodes[e.index] = Node();
+        m_nodes[e.index].entity = e;
+        attach(e.index, RootNode);
+    }
+    if (visible) endInsertRows();
+}
+
+void SceneTreeModel::attach(uint32_t n, uint32_t parent) {
+    std::vector<uint32_t> &siblings = childrenOf(parent);
+    m_nodes[n].parent = parent;
+    m_nodes[n].row = static_cast<int>(siblings.size());
+    siblings.push_back(n);
+}
+
+void SceneTreeModel::detach(uint32_t n) {
+    std::vector<uint32_t> &siblings = childrenOf(m_nodes[n].parent);
+    const int row = m_nodes[n].row;
+    siblings.erase(siblings.begin() + row);
+    for (size_t i = size_t(row); i < siblings.size(); ++i) m_nodes[siblings[i]].row = static_cast<int>(i);
+}
+
+void SceneTreeModel::reparent(uint32_t n, uint32_t newParent) {
+    const uint32_t oldParent = m_nodes[n].parent;
+    if (oldParent == newParent) return;
+    const bool fromVisible = isVisible(n);
+    const bool toVisible = isVisible(newParent) && isFetched(newParent);
+    const int toRow = (newParent == RootNode ? FixedRows : 0) + static_cast<int>(childrenOf(newParent).size());
+
+    if (fromVisible && toVisible) {
+        const int row = rowOf(n);
+        beginMoveRows(indexOfNode(oldParent), row, row, indexOfNode(newParent), toRow);
+        detach(n);
+        attach(n, newParent);
+        endMoveRows();
+    } else if (fromVisible) {
+        const int row = rowOf(n);
+        beginRemoveRows(indexOfNode(oldParent), row, row);
+        detach(n);
+        attach(n, newParent);
+        endRemoveRows();
+    } else if (toVisible) {
+        detach(n);
+        beginInsertRows(indexOfNode(newParent), toRow, toRow);
+        attach(n, newParent);
+        endInsertRows();
+    } else {
+        detach(n);
+        attach(n, newParent);
+    }
+}
+
+void SceneTreeModel::removeNode(uint32_t n) {
+    // Детей журнал уже перенёс к родителю (SceneStore::destroy пишет их первыми);
+    // на случай рассинхронизации — переносим сами
+    while (!m_nodes[n].children.empty()) reparent(m_nodes[n].children.back(), m_nodes[n].parent);
+    const bool visible = isVisible(n);
+    if (visible) {
+        const int row = rowOf(n);
+        beginRemoveRows(indexOfNode(m_nodes[n].parent), row, row);
+    }
+    detach(n);
+    m_nodes[n] = Node();
+    if (visible) endRemoveRows();
+}
+
+bool SceneTreeModel::isVisible(uint32_t n) const {
+    while (n != RootNode) {
+        const uint32_t p = m_nodes[n].parent;
+        if (!isFetched(p)) return false;
+        n = p;
+    }
+    return true;
+}
+
+QModelIndex SceneTreeModel::indexOfNode(uint32_t n) const {
+    if (n == RootNode) return sceneIndex();
+    return createIndex(rowOf(n), 0, quintptr(n) + FirstEntityId);
+}
+
+QModelIndex SceneTreeModel::indexOf(Entity e) {
+    const uint32_t n = nodeOf(e);
+    if (n == RootNode) return QModelIndex();
+    std::vector<uint32_t> ancestors;
+    for (uint32_t a = m_nodes[n].parent; a != RootNode; a = m_nodes[a].parent) ancestors.push_back(a);
+    if (!m_rootFetched) fetchMore(sceneIndex());
+    for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it) {
+        if (!m_nodes[*it].fetched) fetchMore(indexOfNode(*it));
+    }
+    return indexOfNode(n);
+}
+
+Entity SceneTreeModel::entityAt(const QModelIndex &index) const {
+    if (!index.isValid() || index.internalId() < FirstEntityId) return Entity{};
+    const uint32_t n = static_cast<uint32_t>(index.internalId() - FirstEntityId);
+    return isNode(n) ? m_nodes[n].entity : Entity{};
+}
+
+QModelIndex SceneTreeModel::index(int row, int column, const QModelIndex &parent) const {
+    if (row < 0 || column != 0) return QModelIndex();
+    if (!parent.isValid()) return row == 0 ? sceneIndex() : QModelIndex();
+    const quintptr id = parent.internalId();
+    if (id == SceneId) {
+        if (row < FixedRows) return createIndex(row, 0, quintptr(CameraId + row));
+        const size_t r = size_t(row - FixedRows);
+        if (!m_rootFetched || r >= m_rootChildren.size()) return QModelIndex();
+        return createIndex(row, 0, quintptr(m_rootChildren[r]) + FirstEntityId);
+    }
+    if (id < FirstEntityId) return QModelIndex();
+    const Node &node = m_nodes[id - FirstEntityId];
+    if (!node.fetched || size_t(row) >= node.children.size()) return QModelIndex();
+    return createIndex(row, 0, quintptr(node.children[row]) + FirstEntityId);
+}
+
+QModelIndex SceneTreeModel::parent(const QModelIndex &child) const {
+    if (!child.isValid()) return QModelIndex();
+    const quintptr id = child.internalId();
+    if (id == SceneId) return QModelIndex();
+    if (id < FirstEntityId) return sceneIndex();
+    return indexOfNode(m_nodes[id - FirstEntityId].parent);
+}
+
+int SceneTreeModel::rowCount(const QModelIndex &parent) const {
+    if (!parent.isValid()) return 1;
+    if (parent.column() > 0) return 0;
+    const quintptr id = parent.internalId();
+    if (id == SceneId) return FixedRows + (m_rootFetched ? static_cast<int>(m_rootChildren.size()) : 0);
+    if (id < FirstEntityId) return 0;
+    const Node &node = m_nodes[id - FirstEntityId];
+    return node.fetched ? static_cast<int>(node.children.size()) : 0;
+}
+
+int SceneTreeModel::columnCount(const QModelIndex &) const {
+    return 1;
+}
+
+bool SceneTreeModel::hasChildren(const QModelIndex &parent) const {
+    // Стрелка раскрытия — и у ещё не подгруженных узлов
+    if (!parent.isValid()) return true;
+    const quintptr id = parent.internalId();
+    if (id == SceneId) return true;
+    if (id < FirstEntityId) return false;
+    return !m_nodes[id - FirstEntityId].children.empty();
+}
+
+bool SceneTreeModel::canFetchMore(const QModelIndex &parent) const {
+    if (!parent.isValid()) return false;
+    const quintptr id = parent.internalId();
+    if (id == SceneId) return !m_rootFetched;
+    if (id < FirstEntityId) return false;
+    return !m_nodes[id - FirstEntityId].fetched;
+}
+
+void SceneTreeModel::fetchMore(const QModelIndex &parent) {
+    if (!canFetchMore(parent)) return;
+    const quintptr id = parent.internalId();
+    const uint32_t n = id == SceneId ? RootNode : static_cast<uint32_t>(id - FirstEntityId);
+    const int count = static_cast<int>(childrenOf(n).size());
+    const int first = n == RootNode ? FixedRows : 0;
+    if (count > 0) beginInsertRows(parent, first, first + count - 1);
+    if (n == RootNode) m_rootFetched = true;
+    else m_nodes[n].fetched = true;
+    if (count > 0) endInsertRows();
+}
+
+QVariant SceneTreeModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) return QVariant();
+    const quintptr id = index.internalId();
+    if (id < FirstEntityId) {
+        if (role != Qt::DisplayRole) return QVariant();
+        return id == SceneId ? QString("Сцена") : id == CameraId ? QString("Камера") : QString("Свет");
+    }
+    const Entity e = m_nodes[id - FirstEntityId].entity;
+    // Между правкой сцены и sync() узел может пережить сущность
+    if (!m_scene.alive(e)) return QVariant();
+    if (role == Qt::DisplayRole) return QString::fromStdString(m_scene.name(e));
+    if (role == EntityRole) return QVariant::fromValue<qulonglong>(e.id());
+    return QVariant();
+}
+
+QVariant SceneTreeModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (section == 0 && orientation == Qt::Horizontal && role == Qt::DisplayRole) return QString("Иерархия");
+    return QVariant();
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <QAbstractItemModel>
+#include <cstdint>
+#include <vector>
+#include "core/SceneStore.hpp"
+
+// Дерево иерархии поверх SceneStore: элементов на объект нет, узлы лежат
+// массивом по Entity::index, так что объект -> строка и строка -> объект — O(1).
+//
+// Верхний уровень — «Сцена» с постоянными «Камера» и «Свет», объекты без
+// родителя идут после них. Дети узла отдаются виду лениво (canFetchMore/
+// fetchMore): пока узел не раскрыт, правки под ним сигналов не порождают.
+//
+// sync() забирает журнал SceneStore::takeChanges() и превращает его в
+// сигналы модели: подряд созданные объекты — одна вставка, перенос —
+// beginMoveRows. Большие пакеты правок (загрузка, массовое удаление) дешевле
+// отдать одним сбросом модели, чем тысячами построчных сигналов.
+class SceneTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+public:
+    enum Roles { EntityRole = Qt::UserRole }; // Entity::id()
+
+    // Включает журнал изменений сцены; сцена должна пережить модель
+    explicit SceneTreeModel(SceneStore &scene, QObject *parent=nullptr);
+
+    // Вызывать после правок состава/связей сцены
+    void sync();
+
+    // Подгружает предков, чтобы строка объекта существовала у вида
+    QModelIndex indexOf(Entity e);
+    Entity entityAt(const QModelIndex &index) const;
+    QModelIndex sceneIndex() const { return createIndex(0, 0, quintptr(SceneId)); }
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    // internalId: 0 — «Сцена», 1 — «Камера», 2 — «Свет», дальше Entity::index + FirstEntityId
+    enum : quintptr { SceneId = 0, CameraId = 1, LightId = 2, FirstEntityId = 3 };
+    static constexpr int FixedRows = 2;            // Камера и Свет перед объектами верхнего уровня
+    static constexpr uint32_t RootNode = UINT32_MAX;
+    // Больше правок, кроме создания, — сброс модели вместо построчных сигналов
+    static constexpr size_t ResetThreshold = 256;
+
+    struct Node {
+        Entity entity;                   // null — индекс свободен
+        uint32_t parent = RootNode;
+        int row = 0;                     // позиция в children родителя
+        std::vector<uint32_t> children;  // индексы узлов, в порядке строк
+        bool fetched = true;             // дети отданы виду
+    };
+
+    bool isNode(uint32_t n) const { return n < m_nodes.size() && !m_nodes[n].entity.isNull(); }
+    uint32_t nodeOf(Entity e) const { return e && isNode(e.index) && m_nodes[e.index].entity == e ? e.index : RootNode; }
+    std::vector<uint32_t> &childrenOf(uint32_t n) { return n == RootNode ? m_rootChildren : m_nodes[n].children; }
+    bool isFetched(uint32_t n) const { return n == RootNode ? m_rootFetched : m_nodes[n].fetched; }
+    // Узел виден, если виден родитель и родитель отдал детей
+    bool isVisible(uint32_t n) const;
+    QModelIndex indexOfNode(uint32_t n) const;
+    int rowOf(uint32_t n) const { return m_nodes[n].row + (m_nodes[n].parent == RootNode ? FixedRows : 0); }
+
+    void rebuild();
+    void insertCreated(const std::vector<StructureChange> &changes, size_t first, size_t last);
+    void attach(uint32_t n, uint32_t parent);
+    void detach(uint32_t n);
+    void reparent(uint32_t n, uint32_t newParent);
+    void removeNode(uint32_t n);
+
+    SceneStore &m_scene;
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_rootChildren;
+    bool m_rootFetched = true;
+};
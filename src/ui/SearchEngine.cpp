@@ -0,0 +1,483 @@
+#include "SearchEngine.hpp"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+namespace {
+// Файлы отдаются пулу пачками — на мелких исходниках накладные расходы задачи заметны
+constexpr int kFilesPerTask = 32;
+// Порция результатов, после которой они уходят в GUI-поток
+constexpr int kHitsPerPost = 256;
+// Как в git: NUL в начале файла — считаем двоичным
+constexpr qint64 kBinaryProbe = 8000;
+// Регулярки работают по QString; файл больше этого проверяется построчно
+constexpr qint64 kRegexFileLimit = 64 << 20;
+constexpr int kPreviewChars = 200;
+
+// ===== .gitignore =====
+
+struct IgnoreRule {
+    QRegularExpression re;
+    bool negate = false;
+    bool dirOnly = false;
+    bool byName = false; // без '/' — сравниваем только имя, на любой глубине
+};
+
+struct IgnoreLevel {
+    QString base; // каталог, где лежит .gitignore
+    std::vector<IgnoreRule> rules;
+};
+
+QString globToRegex(const QString &glob) {
+    QString rx;
+    for (int i = 0; i < glob.size(); ++i) {
+        const QChar c = glob[i];
+        if (c == '*') {
+            if (i + 1 < glob.size() && glob[i + 1] == '*') {
+                const bool slash = i + 2 < glob.size() && glob[i + 2] == '/';
+                rx += slash ? "(?:.*/)?" : ".*";
+                i += slash ? 2 : 1;
+            } else {
+                rx += "[^/]*";
+            }
+        } else if (c == '?') {
+            rx += "[^/]";
+        } else if (c == '[') {
+            const int close = glob.indexOf(']', i + 1);
+            if (close < 0) { rx += "\\["; continue; }
+            QString set = glob.mid(i + 1, close - i - 1);
+            if (set.startsWith('!')) set[0] = '^';
+            rx += '[' + set + ']';
+            i = close;
+        } else if (c == '\\' && i + 1 < glob.size()) {
+            rx += QRegularExpression::escape(QString(glob[++i]));
+        } else {
+            rx += QRegularExpression::escape(QString(c));
+        }
+    }
+    return QRegularExpression::anchoredPattern(rx);
+}
+
+IgnoreLevel loadIgnore(const QString &dir) {
+    IgnoreLevel level{dir, {}};
+    QFile f(dir + "/.gitignore");
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return level;
+    QTextStream in(&f);
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        while (line.endsWith(' ') && !line.endsWith("\\ ")) line.chop(1);
+        if (line.isEmpty()) continue;
+        IgnoreRule rule;
+        if (line.startsWith('!')) { rule.negate = true; line.remove(0, 1); }
+        if (line.endsWith('/')) { rule.dirOnly = true; line.chop(1); }
+        if (line.startsWith('/')) line.remove(0, 1);
+        else if (!line.contains('/')) rule.byName = true;
+        if (line.isEmpty()) continue;
+        rule.re.setPattern(globToRegex(line));
+        if (rule.re.isValid()) level.rules.push_back(std::move(rule));
+    }
+    return level;
+}
+
+// Правила применяются от корня вглубь, последнее совпавшее решает (с учётом '!').
+bool isIgnored(const std::vector<IgnoreLevel> &stack, const QString &path, const QString &name, bool isDir) {
+    bool ignored = false;
+    for (const IgnoreLevel &level : stack) {
+        const QString rel = path.mid(level.base.size() + 1);
+        for (const IgnoreRule &rule : level.rules) {
+            if (rule.dirOnly && !isDir) continue;
+            if (rule.re.match(rule.byName ? name : rel).hasMatch()) ignored = !rule.negate;
+        }
+    }
+    return ignored;
+}
+
+// ===== Сопоставление =====
+
+QString previewOf(const QString &line) {
+    QString s = line;
+    if (s.endsWith('\r')) s.chop(1);
+    return s.size() > kPreviewChars ? s.left(kPreviewChars) + QStringLiteral("…") : s;
+}
+
+// Литерал по байтам UTF-8. Первый байт ищется memchr, остальное сравнивается
+// memcmp; без учёта регистра — две memchr-ветки (строчная/прописная) и
+// ASCII-свёртка, этого хватает для исходников.
+class LiteralMatcher {
+public:
+    LiteralMatcher(const QString &pattern, bool caseSensitive)
+        : m_needle(pattern.toUtf8()), m_caseSensitive(caseSensitive) {
+        if (!caseSensitive) m_needle = m_needle.toLower();
+    }
+
+    bool isEmpty() const { return m_needle.isEmpty(); }
+    int length() const { return int(m_needle.size()); }
+
+    const char *find(const char *p, const char *end) const {
+        const size_t n = size_t(m_needle.size());
+        const char first = m_needle[0];
+        if (m_caseSensitive) {
+            while (size_t(end - p) >= n) {
+                p = static_cast<const char*>(std::memchr(p, first, size_t(end - p) - n + 1));
+                if (!p) return nullptr;
+                if (std::memcmp(p + 1, m_needle.constData() + 1, n - 1) == 0) return p;
+                ++p;
+            }
+            return nullptr;
+        }
+        const char upper = first >= 'a' && first <= 'z' ? char(first - 'a' + 'A') : first;
+        while (size_t(end - p) >= n) {
+            const size_t span = size_t(end - p) - n + 1;
+            const char *a = static_cast<const char*>(std::memchr(p, first, span));
+            const char *b = upper != first ? static_cast<const char*>(std::memchr(p, upper, a ? size_t(a - p) : span)) : nullptr;
+            p = b ? b : a;
+            if (!p) return nullptr;
+            if (equalsFolded(p + 1, n - 1)) return p;
+            ++p;
+        }
+        return nullptr;
+    }
+
+private:
+    bool equalsFolded(const char *p, size_t n) const {
+        const char *q = m_needle.constData() + 1;
+        for (size_t i = 0; i < n; ++i) {
+            char c = p[i];
+            if (c >= 'A' && c <= 'Z') c = char(c - 'A' + 'a');
+            if (c != q[i]) return false;
+        }
+        return true;
+    }
+
+    QByteArray m_needle;
+    bool m_caseSensitive;
+};
+
+} // namespace
+
+// Общее состояние одного поиска; задачи пула держат его через shared_ptr,
+// так что отменённый поиск доживает до конца своих задач сам по себе.
+struct SearchEngine::Job {
+    SearchQuery query;
+    QRegularExpression regex;
+    std::atomic<bool> cancelled{false};
+    std::atomic<int> pending{1}; // задачи в работе + сам запуск
+    std::atomic<int> files{0};
+    std::atomic<qint64> bytes{0};
+    std::atomic<int> hits{0};
+    std::atomic<bool> truncated{false};
+    QElapsedTimer timer;
+
+    bool stop() const { return cancelled.load(std::memory_order_relaxed); }
+
+    // Резервирует место под очередное совпадение; false — лимит исчерпан
+    bool reserveHit() {
+        if (hits.fetch_add(1, std::memory_order_relaxed) < MaxHits) return true;
+        truncated = true;
+        cancelled = true;
+        return false;
+    }
+
+    // Поиск в одном буфере. path — для результатов, пусто у текущего документа.
+    template <class Emit>
+    void scan(const char *data, qint64 size, const QString &path, Emit emitHit) {
+        files.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+        if (query.regex) scanRegex(data, size, path, emitHit);
+        else scanLiteral(data, size, path, emitHit);
+    }
+
+    template <class Emit>
+    void scanLiteral(const char *data, qint64 size, const QString &path, Emit emitHit) {
+        const LiteralMatcher matcher(query.pattern, query.caseSensitive);
+        if (matcher.isEmpty()) return;
+        const char *end = data + size;
+        const char *lineStart = data;
+        const char *counted = data; // номер строки досчитан до этого места
+        qint64 line = 0;
+        for (const char *p = data; !stop() && (p = matcher.find(p, end)); ) {
+            // Строки считаются memchr'ом только между соседними совпадениями
+            for (const char *nl; (nl = static_cast<const char*>(std::memchr(counted, '\n', size_t(p - counted)))); ) {
+                ++line;
+                lineStart = counted = nl + 1;
+            }
+            counted = p;
+            const char *lineEnd = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+            if (!lineEnd) lineEnd = end;
+            if (!reserveHit()) return;
+            SearchHit hit;
+            hit.path = path;
+            hit.line = line;
+            hit.column = QString::fromUtf8(lineStart, qsizetype(p - lineStart)).size();
+            hit.length = QString::fromUtf8(p, matcher.length()).size();
+            hit.preview = previewOf(QString::fromUtf8(lineStart, qsizetype(lineEnd - lineStart)));
+            emitHit(std::move(hit));
+            p += matcher.length();
+        }
+    }
+
+    template <class Emit>
+    void scanRegex(const char *data, qint64 size, const QString &path, Emit emitHit) {
+        if (size > kRegexFileLimit) {
+            scanRegexLines(data, size, path, emitHit);
+            return;
+        }
+        const QString text = QString::fromUtf8(data, qsizetype(size));
+        qsizetype counted = 0;
+        qsizetype lineStart = 0;
+        qint64 line = 0;
+        auto it = regex.globalMatch(text);
+        while (!stop() && it.hasNext()) {
+            const QRegularExpressionMatch m = it.next();
+            if (m.capturedLength() == 0) continue;
+            const qsizetype pos = m.capturedStart();
+            for (qsizetype nl; (nl = text.indexOf('\n', counted)) >= 0 && nl < pos; ) {
+                ++line;
+                lineStart = counted = nl + 1;
+            }
+            counted = pos;
+            qsizetype lineEnd = text.indexOf('\n', pos);
+            if (lineEnd < 0) lineEnd = text.size();
+            if (!reserveHit()) return;
+            SearchHit hit;
+            hit.path = path;
+            hit.line = line;
+            hit.column = int(pos - lineStart);
+            hit.length = int(m.capturedLength());
+            hit.preview = previewOf(text.mid(lineStart, lineEnd - lineStart));
+            emitHit(std::move(hit));
+        }
+    }
+
+    // Большой файл целиком в QString не разворачиваем: выражение применяется
+    // к каждой строке, совпадения через перевод строки не находятся
+    template <class Emit>
+    void scanRegexLines(const char *data, qint64 size, const QString &path, Emit emitHit) {
+        const char *end = data + size;
+        qint64 line = 0;
+        for (const char *p = data; p < end && !stop(); ++line) {
+            const char *nl = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+            const char *lineEnd = nl ? nl : end;
+            const QString text = QString::fromUtf8(p, qsizetype(lineEnd - p));
+            auto it = regex.globalMatch(text);
+            while (!stop() && it.hasNext()) {
+                const QRegularExpressionMatch m = it.next();
+                if (m.capturedLength() == 0) continue;
+                if (!reserveHit()) return;
+                SearchHit hit;
+                hit.path = path;
+                hit.line = line;
+                hit.column = int(m.capturedStart());
+                hit.length = int(m.capturedLength());
+                hit.preview = previewOf(text);
+                emitHit(std::move(hit));
+            }
+            if (!nl) break;
+            p = nl + 1;
+        }
+    }
+};
+
+namespace {
+
+bool looksBinary(const char *data, qint64 size) {
+    return std::memchr(data, '\0', size_t(std::min(size, kBinaryProbe))) != nullptr;
+}
+
+} // namespace
+
+SearchEngine::SearchEngine(QObject *parent) : QObject(parent) {
+    m_pool.setMaxThreadCount(std::max(2, QThread::idealThreadCount()));
+}
+
+SearchEngine::~SearchEngine() {
+    cancel();
+    m_pool.waitForDone();
+}
+
+void SearchEngine::cancel() {
+    if (m_job) m_job->cancelled = true;
+    m_job.reset();
+}
+
+std::shared_ptr<SearchEngine::Job> SearchEngine::startJob(const SearchQuery &query) {
+    cancel();
+    auto job = std::make_shared<Job>();
+    job->query = query;
+    if (query.regex) {
+        job->regex.setPattern(query.pattern);
+        if (!query.caseSensitive) job->regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+        job->regex.optimize();
+    }
+    job->timer.start();
+    m_job = job;
+    return job;
+}
+
+void SearchEngine::post(const std::shared_ptr<Job> &job, QVector<SearchHit> hits) {
+    if (hits.isEmpty()) return;
+    QMetaObject::invokeMethod(this, [this, job, hits = std::move(hits)]{
+        if (job == m_job) emit hitsFound(hits);
+    }, Qt::QueuedConnection);
+}
+
+void SearchEngine::finishTask(const std::shared_ptr<Job> &job) {
+    if (job->pending.fetch_sub(1) != 1) return;
+    QMetaObject::invokeMethod(this, [this, job]{
+        if (job != m_job) return;
+        SearchStats stats;
+        stats.files = job->files.load();
+        stats.bytes = job->bytes.load();
+        stats.hits = std::min(job->hits.load(), int(MaxHits));
+        stats.elapsedMs = job->timer.elapsed();
+        stats.truncated = job->truncated.load();
+        m_job.reset();
+        emit finished(stats);
+    }, Qt::QueuedConnection);
+}
+
+void SearchEngine::searchBuffer(const QByteArray &utf8, const SearchQuery &query) {
+    auto job = startJob(query);
+    m_pool.start([this, job, utf8]{
+        QVector<SearchHit> batch;
+        job->scan(utf8.constData(), utf8.size(), QString(), [&](SearchHit &&hit) {
+            batch.push_back(std::move(hit));
+            if (batch.size() >= kHitsPerPost) post(job, std::exchange(batch, {}));
+        });
+        post(job, std::move(batch));
+        finishTask(job);
+    });
+}
+
+void SearchEngine::scanFiles(const std::shared_ptr<Job> &job, const QStringList &paths) {
+    QVector<SearchHit> batch;
+    for (const QString &path : paths) {
+        if (job->stop()) break;
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly) || f.size() == 0) continue;
+        const uchar *data = f.map(0, f.size());
+        if (!data) continue;
+        const char *p = reinterpret_cast<const char*>(data);
+        if (!looksBinary(p, f.size())) {
+            job->scan(p, f.size(), path, [&](SearchHit &&hit) {
+                batch.push_back(std::move(hit));
+                if (batch.size() >= kHitsPerPost) post(job, std::exchange(batch, {}));
+            });
+        }
+        f.unmap(const_cast<uchar*>(data));
+        // Файл закончился — отдаём найденное, чтобы панель наполнялась по ходу
+        post(job, std::exchange(batch, {}));
+    }
+}
+
+void SearchEngine::searchFiles(const QStringList &paths, const SearchQuery &query) {
+    auto job = startJob(query);
+    for (int i = 0; i < paths.size(); i += kFilesPerTask) {
+        const QStringList chunk = paths.mid(i, kFilesPerTask);
+        job->pending.fetch_add(1);
+        m_pool.start([this, job, chunk]{
+            scanFiles(job, chunk);
+            finishTask(job);
+        });
+    }
+    finishTask(job);
+}
+
+void SearchEngine::searchEdited(const QString &path, std::vector<LargeFileDocument::Span> spans, const SearchQuery &query) {
+    auto job = startJob(query);
+    m_pool.start([this, job, path, spans = std::move(spans)]{
+        QVector<SearchHit> batch;
+        auto push = [&](SearchHit &&hit) {
+            batch.push_back(std::move(hit));
+            if (batch.size() >= kHitsPerPost) post(job, std::exchange(batch, {}));
+        };
+        // Исходные куски по возрастанию строк файла: номер строки файла -> строка документа
+        std::vector<const LargeFileDocument::Span*> originals;
+        for (const auto &s : spans) {
+            if (s.original >= 0) originals.push_back(&s);
+        }
+        std::sort(originals.begin(), originals.end(), [](auto a, auto b){ return a->original < b->original; });
+        QFile f(path);
+        if (!originals.empty() && f.open(QIODevice::ReadOnly) && f.size() > 0) {
+            if (const uchar *data = f.map(0, f.size())) {
+                job->scan(reinterpret_cast<const char*>(data), f.size(), path, [&](SearchHit &&hit) {
+                    auto it = std::upper_bound(originals.begin(), originals.end(), hit.line,
+                                               [](qint64 line, auto s){ return line < s->original; });
+                    if (it == originals.begin()) return;
+                    const LargeFileDocument::Span *s = *(it - 1);
+                    // Строка удалена или заменена правкой
+                    if (hit.line >= s->original + s->count) return;
+                    hit.line = s->line + (hit.line - s->original);
+                    push(std::move(hit));
+                });
+                f.unmap(const_cast<uchar*>(data));
+            }
+        }
+        for (const auto &s : spans) {
+            for (size_t j = 0; j < s.added.size() && !job->stop(); ++j) {
+                const QByteArray &text = s.added[j];
+                job->bytes.fetch_add(text.size(), std::memory_order_relaxed);
+                auto emitLine = [&](SearchHit &&hit) {
+                    hit.line = s.line + qint64(j);
+                    push(std::move(hit));
+                };
+                if (job->query.regex) job->scanRegex(text.constData(), text.size(), path, emitLine);
+                else job->scanLiteral(text.constData(), text.size(), path, emitLine);
+            }
+        }
+        post(job, std::move(batch));
+        finishTask(job);
+    });
+}
+
+void SearchEngine::searchTree(const QString &root, const SearchQuery &query) {
+    auto job = startJob(query);
+    const QString base = QDir::cleanPath(QFileInfo(root).absoluteFilePath());
+    // Обход — тоже задача пула: найденные файлы уходят на поиск, не дожидаясь конца обхода
+    m_pool.start([this, job, base]{
+        struct Frame { QString dir; size_t depth; };
+        std::vector<IgnoreLevel> ignores;
+        std::vector<Frame> stack{{base, 0}};
+        QStringList chunk;
+        auto flush = [&]{
+            if (chunk.isEmpty()) return;
+            job->pending.fetch_add(1);
+            m_pool.start([this, job, files = std::exchange(chunk, {})]{
+                scanFiles(job, files);
+                finishTask(job);
+            });
+        };
+        while (!stack.empty() && !job->stop()) {
+            const Frame frame = stack.back();
+            stack.pop_back();
+            ignores.resize(frame.depth);
+            ignores.push_back(loadIgnore(frame.dir));
+            const QFileInfoList entries = QDir(frame.dir).entryInfoList(
+                QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks, QDir::Name);
+            for (const QFileInfo &fi : entries) {
+                const QString name = fi.fileName();
+                if (fi.isDir() && name == ".git") continue;
+                const QString path = frame.dir + '/' + name;
+                if (isIgnored(ignores, path, name, fi.isDir())) continue;
+                if (fi.isDir()) {
+                    stack.push_back({path, frame.depth + 1});
+                } else {
+                    chunk.push_back(path);
+                    if (chunk.size() >= kFilesPerTask) flush();
+                }
+            }
+        }
+        flush();
+        finishTask(job);
+    });
+}
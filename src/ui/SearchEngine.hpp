@@ -0,0 +1,69 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include "LargeFileDocument.hpp"
+
+struct SearchQuery {
+    QString pattern;
+    bool regex = false;
+    bool caseSensitive = false;
+};
+
+struct SearchHit {
+    QString path;     // пусто — текущий документ
+    qint64 line = 0;  // с нуля
+    int column = 0;   // в символах
+    int length = 0;
+    QString preview;  // строка целиком (обрезанная)
+};
+
+struct SearchStats {
+    int files = 0;
+    qint64 bytes = 0;
+    int hits = 0;
+    qint64 elapsedMs = 0;
+    bool truncated = false; // упёрлись в MaxHits
+};
+
+// Поиск по документу и по дереву проекта. Файлы читаются через отображение
+// (QFile::map), литерал ищется memchr/memcmp — в libc они векторизованы; регулярки
+// идут через QRegularExpression (в файлах больше 64 МБ — построчно). Обход дерева учитывает .gitignore, файлы
+// раздаются пачками пулу потоков, найденное приходит порциями через hitsFound.
+// Новый поиск отменяет предыдущий.
+class SearchEngine : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int MaxHits = 50000;
+
+    explicit SearchEngine(QObject *parent=nullptr);
+    ~SearchEngine() override;
+
+    void searchBuffer(const QByteArray &utf8, const SearchQuery &query);
+    void searchFiles(const QStringList &paths, const SearchQuery &query);
+    // Большой документ с несохранёнными правками: исходные строки ищутся по файлу
+    // path и переводятся в номера документа, добавленные — по копиям из spans
+    void searchEdited(const QString &path, std::vector<LargeFileDocument::Span> spans, const SearchQuery &query);
+    void searchTree(const QString &root, const SearchQuery &query);
+    void cancel();
+    bool isRunning() const { return m_job != nullptr; }
+
+signals:
+    void hitsFound(const QVector<SearchHit> &hits);
+    void finished(const SearchStats &stats);
+
+public:
+    struct Job;
+
+private:
+    std::shared_ptr<Job> startJob(const SearchQuery &query);
+    void scanFiles(const std::shared_ptr<Job> &job, const QStringList &paths);
+    void post(const std::shared_ptr<Job> &job, QVector<SearchHit> hits);
+    void finishTask(const std::shared_ptr<Job> &job);
+
+    QThreadPool m_pool;
+    std::shared_ptr<Job> m_job;
+};
@@ -0,0 +1,156 @@
+#include "SearchPanel.hpp"
+#include <QDir>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QRegularExpression>
+#include <QVBoxLayout>
+
+namespace {
+enum HitRole {
+    PathRole = Qt::UserRole,
+    LineRole,
+    ColumnRole,
+    LengthRole,
+};
+}
+
+SearchPanel::SearchPanel(QWidget *parent) : QWidget(parent) {
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    auto row = new QHBoxLayout();
+    m_query = new QLineEdit();
+    m_query->setPlaceholderText("Искать...");
+    m_query->setClearButtonEnabled(true);
+    m_regex = new QCheckBox(".*");
+    m_regex->setToolTip("Регулярное выражение");
+    m_case = new QCheckBox("Aa");
+    m_case->setToolTip("Учитывать регистр");
+    auto fileBtn = new QPushButton("В файле");
+    auto projectBtn = new QPushButton("В проекте");
+    auto stopBtn = new QPushButton("Стоп");
+    row->addWidget(m_query, 1);
+    row->addWidget(m_regex);
+    row->addWidget(m_case);
+    row->addWidget(fileBtn);
+    row->addWidget(projectBtn);
+    row->addWidget(stopBtn);
+    layout->addLayout(row);
+
+    m_results = new QTreeWidget();
+    m_results->setHeaderHidden(true);
+    m_results->setUniformRowHeights(true);
+    m_results->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(m_results, 1);
+
+    m_status = new QLabel();
+    layout->addWidget(m_status);
+
+    m_engine = new SearchEngine(this);
+    connect(m_engine, &SearchEngine::hitsFound, this, &SearchPanel::onHits);
+    connect(m_engine, &SearchEngine::finished, this, &SearchPanel::onFinished);
+    connect(m_results, &QTreeWidget::itemActivated, this, &SearchPanel::onItemActivated);
+    connect(m_query, &QLineEdit::returnPressed, this, &SearchPanel::onReturnPressed);
+    connect(fileBtn, &QPushButton::clicked, this, [this]{ m_projectScope = false; emit documentSearchRequested(); });
+    connect(projectBtn, &QPushButton::clicked, this, [this]{ m_projectScope = true; emit projectSearchRequested(); });
+    connect(stopBtn, &QPushButton::clicked, this, [this]{
+        if (!m_engine->isRunning()) return;
+        m_engine->cancel();
+        m_status->setText(m_status->text() + " — остановлено");
+    });
+}
+
+SearchQuery SearchPanel::query() const {
+    SearchQuery q;
+    q.pattern = m_query->text();
+    q.regex = m_regex->isChecked();
+    q.caseSensitive = m_case->isChecked();
+    return q;
+}
+
+void SearchPanel::activate(bool project) {
+    m_projectScope = project;
+    show();
+    m_query->setFocus();
+    m_query->selectAll();
+}
+
+void SearchPanel::onReturnPressed() {
+    if (m_projectScope) emit projectSearchRequested();
+    else emit documentSearchRequested();
+}
+
+bool SearchPanel::begin(const QString &scope) {
+    const SearchQuery q = query();
+    if (q.pattern.isEmpty()) return false;
+    if (q.regex) {
+        const QRegularExpression re(q.pattern);
+        if (!re.isValid()) {
+            m_status->setText("Ошибка в выражении: " + re.errorString());
+            return false;
+        }
+    }
+    m_results->clear();
+    m_fileItems.clear();
+    m_status->setText("Поиск " + scope + "...");
+    return true;
+}
+
+void SearchPanel::runInDocument(const QByteArray &utf8, const QString &label) {
+    if (!begin("в файле")) return;
+    m_documentLabel = label;
+    m_engine->searchBuffer(utf8, query());
+}
+
+void SearchPanel::runInFiles(const QStringList &paths) {
+    if (!begin("в файле")) return;
+    m_root.clear();
+    m_engine->searchFiles(paths, query());
+}
+
+void SearchPanel::runInEdited(const QString &path, std::vector<LargeFileDocument::Span> spans) {
+    if (!begin("в файле")) return;
+    m_root.clear();
+    m_engine->searchEdited(path, std::move(spans), query());
+}
+
+void SearchPanel::runInProject(const QString &root) {
+    if (!begin("в проекте")) return;
+    m_root = root;
+    m_engine->searchTree(root, query());
+}
+
+void SearchPanel::onHits(const QVector<SearchHit> &hits) {
+    // Пачка добавляется без промежуточных перерисовок
+    m_results->setUpdatesEnabled(false);
+    for (const SearchHit &hit : hits) {
+        QTreeWidgetItem *&fileItem = m_fileItems[hit.path];
+        if (!fileItem) {
+            const QString title = hit.path.isEmpty() ? m_documentLabel
+                : m_root.isEmpty() ? hit.path : QDir(m_root).relativeFilePath(hit.path);
+            fileItem = new QTreeWidgetItem(m_results, QStringList(title));
+            fileItem->setData(0, PathRole, hit.path);
+            fileItem->setExpanded(true);
+        }
+        auto item = new QTreeWidgetItem(fileItem, QStringList(QString("%1: %2").arg(hit.line + 1).arg(hit.preview.trimmed())));
+        item->setData(0, PathRole, hit.path);
+        item->setData(0, LineRole, hit.line);
+        item->setData(0, ColumnRole, hit.column);
+        item->setData(0, LengthRole, hit.length);
+    }
+    m_results->setUpdatesEnabled(true);
+}
+
+void SearchPanel::onFinished(const SearchStats &stats) {
+    QString text = QString("Совпадений: %1 в %2 файл(ах), просмотрено %3 файл(ов), %4 КБ за %5 мс")
+        .arg(stats.hits).arg(m_fileItems.size()).arg(stats.files).arg(stats.bytes / 1024).arg(stats.elapsedMs);
+    if (stats.truncated) text += QString(" — показаны первые %1").arg(SearchEngine::MaxHits);
+    m_status->setText(text);
+}
+
+void SearchPanel::onItemActivated(QTreeWidgetItem *item, int) {
+    if (!item || !item->parent()) return;
+    emit hitActivated(item->data(0, PathRole).toString(), item->data(0, LineRole).toLongLong(),
+                      item->data(0, ColumnRole).toInt(), item->data(0, LengthRole).toInt());
+}
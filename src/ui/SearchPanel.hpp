@@ -0,0 +1,52 @@
+#pragma once
+#include <QWidget>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QTreeWidget>
+#include <QLabel>
+#include <QHash>
+#include "SearchEngine.hpp"
+
+// Панель поиска вкладки кода: строка запроса, флаги и список результатов,
+// сгруппированных по файлам. Результаты добавляются по мере того, как их находит
+// SearchEngine. Откуда брать текст, решает CodePanel — по сигналам *Requested.
+class SearchPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit SearchPanel(QWidget *parent=nullptr);
+
+    SearchQuery query() const;
+    // Показать панель с фокусом в строке запроса; project — область по Enter.
+    void activate(bool project);
+
+    void runInDocument(const QByteArray &utf8, const QString &label);
+    void runInFiles(const QStringList &paths);
+    void runInEdited(const QString &path, std::vector<LargeFileDocument::Span> spans);
+    void runInProject(const QString &root);
+
+signals:
+    void documentSearchRequested();
+    void projectSearchRequested();
+    // path пуст — совпадение в текущем документе
+    void hitActivated(const QString &path, qint64 line, int column, int length);
+
+private slots:
+    void onHits(const QVector<SearchHit> &hits);
+    void onFinished(const SearchStats &stats);
+    void onItemActivated(QTreeWidgetItem *item, int column);
+    void onReturnPressed();
+
+private:
+    bool begin(const QString &scope);
+
+    SearchEngine *m_engine=nullptr;
+    QLineEdit *m_query=nullptr;
+    QCheckBox *m_regex=nullptr;
+    QCheckBox *m_case=nullptr;
+    QTreeWidget *m_results=nullptr;
+    QLabel *m_status=nullptr;
+    QHash<QString, QTreeWidgetItem*> m_fileItems;
+    QString m_documentLabel;
+    QString m_root; // пути в списке показываются относительно него
+    bool m_projectScope=false;
+};
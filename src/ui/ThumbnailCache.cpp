@@ -0,0 +1,263 @@
+#include "ThumbnailCache.hpp"
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPainter>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include "RenderService.hpp"
+
+namespace {
+constexpr quint32 PerPage = ThumbnailCache::PageTiles * ThumbnailCache::PageTiles;
+constexpr int PageSide = ThumbnailCache::TileSize * ThumbnailCache::PageTiles;
+// Защита от битого файла
+constexpr quint32 MaxPages = 1u << 12;
+constexpr qint64 EntryBytes = 8 + 8 + 8 + 8 + 4;
+
+quint64 firstBytes(const QByteArray &digest) {
+    quint64 v = 0;
+    std::memcpy(&v, digest.constData(), std::min<size_t>(sizeof(v), size_t(digest.size())));
+    return v;
+}
+}
+
+ThumbnailCache::ThumbnailCache(const QString &file, RenderService *renderer, QObject *parent)
+    : QObject(parent), m_file(file), m_renderer(renderer) {
+    m_pool.setMaxThreadCount(2);
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(2000);
+    connect(&m_saveTimer, &QTimer::timeout, this, &ThumbnailCache::save);
+    connect(m_renderer, &RenderService::thumbnailReady, this, &ThumbnailCache::onRendered);
+    connect(m_renderer, &RenderService::failed, this, [this](const QString &path, const QString &){ onFailed(path); });
+    load();
+}
+
+ThumbnailCache::~ThumbnailCache() {
+    // Задачи пула пишут в this через очередь событий — дожидаемся их до удаления
+    m_pool.waitForDone();
+    if (!m_dirty) return;
+    std::vector<PageSnapshot> pages = snapshot();
+    write(m_file, m_entries, pages);
+}
+
+quint64 ThumbnailCache::pathHash(const QString &path) {
+    return firstBytes(QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Md5));
+}
+
+QImage ThumbnailCache::thumbnail(const QString &path) {
+    const QFileInfo info(path);
+    if (!info.isFile()) return QImage();
+    const QString file = info.absoluteFilePath();
+    const quint64 key = pathHash(file);
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+    auto it = m_entries.constFind(key);
+    if (it != m_entries.cend() && it->mtime == mtime && it->size == info.size()) return tileImage(it->tile);
+
+    if (m_pending.contains(file)) return QImage();
+    auto failed = m_failed.constFind(key);
+    if (failed != m_failed.cend() && *failed == mtime) return QImage();
+    m_pending.insert(file, Pending{key, mtime, info.size()});
+    // Файл читается один раз — ради хэша содержимого; разбирать его будет RenderService, если придётся
+    m_pool.start([this, file]{
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        QFile f(file);
+        const quint64 content = f.open(QIODevice::ReadOnly) && hash.addData(&f) ? firstBytes(hash.result()) : 0;
+        QMetaObject::invokeMethod(this, [this, file, content]{ onHashed(file, content); }, Qt::QueuedConnection);
+    });
+    return QImage();
+}
+
+void ThumbnailCache::onHashed(const QString &path, quint64 contentHash) {
+    auto it = m_pending.find(path);
+    if (it == m_pending.end()) return;
+    if (contentHash == 0) { onFailed(path); return; }
+    it->contentHash = contentHash;
+    auto same = m_byContent.constFind(contentHash);
+    if (same != m_byContent.cend()) {
+        const quint32 tile = *same;
+        const Pending p = *it;
+        m_pending.erase(it);
+        setEntry(p.pathHash, {contentHash, p.mtime, p.size, tile});
+        emit thumbnailReady(path, tileImage(tile));
+        return;
+    }
+    if (!m_renderer->renderThumbnails({path}, QString(), TileSize)) onFailed(path);
+}
+
+void ThumbnailCache::onRendered(const QString &path, const QImage &image) {
+    auto it = m_pending.find(path);
+    if (it == m_pending.end()) return;
+    const Pending p = *it;
+    m_pending.erase(it);
+    const quint32 tile = allocateTile();
+    storeTile(tile, image);
+    setEntry(p.pathHash, {p.contentHash, p.mtime, p.size, tile});
+    emit thumbnailReady(path, tileImage(tile));
+}
+
+void ThumbnailCache::onFailed(const QString &path) {
+    auto it = m_pending.find(path);
+    if (it == m_pending.end()) return;
+    // До следующего изменения файла не пробуем снова
+    m_failed.insert(it->pathHash, it->mtime);
+    m_pending.erase(it);
+}
+
+void ThumbnailCache::setEntry(quint64 pathHash, const Entry &entry) {
+    ++m_tileRefs[entry.tile];
+    auto it = m_entries.find(pathHash);
+    if (it != m_entries.end()) releaseTile(it->tile, it->contentHash);
+    m_entries.insert(pathHash, entry);
+    m_byContent.insert(entry.contentHash, entry.tile);
+    m_dirty = true;
+    m_saveTimer.start();
+}
+
+void ThumbnailCache::releaseTile(quint32 tile, quint64 contentHash) {
+    if (--m_tileRefs[tile] > 0) return;
+    m_freeTiles.push_back(tile);
+    auto it = m_byContent.find(contentHash);
+    if (it != m_byContent.end() && *it == tile) m_byContent.erase(it);
+}
+
+quint32 ThumbnailCache::allocateTile() {
+    if (m_freeTiles.empty()) {
+        const quint32 first = quint32(m_pages.size()) * PerPage;
+        m_pages.emplace_back();
+        m_tileRefs.resize(first + PerPage, 0);
+        // С конца: первой выдаётся младшая плитка страницы
+        for (quint32 t = first + PerPage; t-- > first;) m_freeTiles.push_back(t);
+    }
+    const quint32 tile = m_freeTiles.back();
+    m_freeTiles.pop_back();
+    return tile;
+}
+
+ThumbnailCache::Page &ThumbnailCache::page(quint32 tile) {
+    Page &p = m_pages[tile / PerPage];
+    if (p.image.isNull()) {
+        if (!p.png.isEmpty()) p.image.loadFromData(p.png, "PNG");
+        if (p.image.size() != QSize(PageSide, PageSide)) {
+            p.image = QImage(PageSide, PageSide, QImage::Format_ARGB32_Premultiplied);
+            p.image.fill(Qt::transparent);
+        } else {
+            p.image = p.image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        }
+    }
+    return p;
+}
+
+QImage ThumbnailCache::tileImage(quint32 tile) {
+    const Page &p = page(tile);
+    const quint32 local = tile % PerPage;
+    return p.image.copy(int(local % PageTiles) * TileSize, int(local / PageTiles) * TileSize, TileSize, TileSize);
+}
+
+void ThumbnailCache::storeTile(quint32 tile, const QImage &image) {
+    Page &p = page(tile);
+    const quint32 local = tile % PerPage;
+    QPainter painter(&p.image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(QRect(int(local % PageTiles) * TileSize, int(local / PageTiles) * TileSize, TileSize, TileSize), image);
+    ++p.version;
+}
+
+void ThumbnailCache::load() {
+    QFile f(m_file);
+    if (!f.open(QIODevice::ReadOnly)) return;
+    QDataStream in(&f);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic = 0, version = 0, tileSize = 0, pageTiles = 0, entryCount = 0, pageCount = 0;
+    in >> magic >> version >> tileSize >> pageTiles >> entryCount >> pageCount;
+    // Другой размер плиток — атлас собирается заново
+    if (in.status() != QDataStream::Ok || magic != Magic || version != Version
+        || tileSize != TileSize || pageTiles != PageTiles || pageCount > MaxPages) return;
+    if (qint64(entryCount) * EntryBytes > f.size()) return;
+
+    std::vector<std::pair<quint64, Entry>> entries(entryCount);
+    for (auto &[key, e] : entries) in >> key >> e.contentHash >> e.mtime >> e.size >> e.tile;
+    std::vector<Page> pages(pageCount);
+    for (Page &p : pages) in >> p.png;
+    if (in.status() != QDataStream::Ok) return;
+
+    m_pages = std::move(pages);
+    m_tileRefs.assign(size_t(pageCount) * PerPage, 0);
+    for (const auto &[key, e] : entries) {
+        if (e.tile >= m_tileRefs.size()) continue;
+        m_entries.insert(key, e);
+        ++m_tileRefs[e.tile];
+        m_byContent.insert(e.contentHash, e.tile);
+    }
+    for (quint32 t = quint32(m_tileRefs.size()); t-- > 0;) {
+        if (m_tileRefs[t] == 0) m_freeTiles.push_back(t);
+    }
+}
+
+std::vector<ThumbnailCache::PageSnapshot> ThumbnailCache::snapshot() const {
+    std::vector<PageSnapshot> pages;
+    pages.reserve(m_pages.size());
+    for (const Page &p : m_pages) {
+        const bool dirty = p.version != p.savedVersion;
+        pages.push_back({dirty ? p.image : QImage(), p.png, p.version});
+    }
+    return pages;
+}
+
+void ThumbnailCache::save() {
+    if (m_saving) { m_saveAgain = true; return; }
+    if (!m_dirty) return;
+    m_dirty = false;
+    m_saving = true;
+    // Страницы сжимаются и пишутся в пуле; в GUI-поток возвращаются готовые PNG
+    auto pages = std::make_shared<std::vector<PageSnapshot>>(snapshot());
+    m_pool.start([this, file = m_file, entries = m_entries, pages]{
+        const bool ok = write(file, entries, *pages);
+        QMetaObject::invokeMethod(this, [this, pages, ok]{
+            m_saving = false;
+            if (ok) {
+                for (size_t i = 0; i < pages->size(); ++i) {
+                    Page &p = m_pages[i];
+                    if ((*pages)[i].version != p.version) continue;
+                    p.png = (*pages)[i].png;
+                    p.savedVersion = p.version;
+                }
+            } else {
+                m_dirty = true;
+            }
+            if (m_saveAgain) {
+                m_saveAgain = false;
+                save();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+bool ThumbnailCache::write(const QString &file, const QHash<quint64, Entry> &entries, std::vector<PageSnapshot> &pages) {
+    for (PageSnapshot &p : pages) {
+        if (p.image.isNull()) continue;
+        QByteArray png;
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        if (!p.image.save(&buffer, "PNG")) return false;
+        p.png = png;
+        p.image = QImage();
+    }
+    QDir().mkpath(QFileInfo(file).absolutePath());
+    QSaveFile f(file);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    QDataStream out(&f);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << Magic << Version << quint32(TileSize) << quint32(PageTiles) << quint32(entries.size()) << quint32(pages.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        out << it.key() << it->contentHash << it->mtime << it->size << it->tile;
+    }
+    for (const PageSnapshot &p : pages) out << p.png;
+    return out.status() == QDataStream::Ok && f.commit();
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <vector>
+
+class RenderService;
+
+// Дисковый кэш превью моделей и сцен: один файл-атлас на проект.
+//
+// Запись ищется по хэшу пути и сверяется с размером и mtime — для попадания
+// хватает stat, сам файл не открывается и не разбирается. Хэш содержимого
+// считается только на промахе: если файл лишь скопировали или тронули,
+// превью берётся из атласа по содержимому без отрисовки. Остальные промахи
+// рендерит RenderService в фоне, готовое приходит в thumbnailReady.
+//
+// Превью TileSize x TileSize уложены страницами PageTiles x PageTiles,
+// страница хранится PNG и декодируется при первом обращении к её превью.
+//   u32 magic 'SCTA', u32 version, u32 tileSize, u32 pageTiles, u32 entryCount, u32 pageCount
+//   entryCount x {u64 pathHash, u64 contentHash, i64 mtimeMs, i64 size, u32 tile}
+//   pageCount x {bytes PNG}
+class ThumbnailCache : public QObject {
+    Q_OBJECT
+public:
+    static constexpr quint32 Magic = 0x41544353; // "SCTA"
+    static constexpr quint32 Version = 1;
+    static constexpr int TileSize = 96;
+    static constexpr int PageTiles = 16; // 256 превью на страницу
+
+    ThumbnailCache(const QString &file, RenderService *renderer, QObject *parent=nullptr);
+    ~ThumbnailCache() override;
+
+    // Превью из атласа; нет или устарело — пустая картинка и заказ в фоне
+    QImage thumbnail(const QString &path);
+    int size() const { return int(m_entries.size()); }
+    // Запись на диск в фоне; сама вызывается через пару секунд после изменений
+    void save();
+
+signals:
+    void thumbnailReady(const QString &path, const QImage &image);
+
+private:
+    struct Entry {
+        quint64 contentHash = 0;
+        qint64 mtime = 0;
+        qint64 size = 0;
+        quint32 tile = 0;
+    };
+    struct Pending {
+        quint64 pathHash = 0;
+        qint64 mtime = 0;
+        qint64 size = 0;
+        quint64 contentHash = 0;
+    };
+    struct Page {
+        QImage image;        // пусто, пока не понадобилась
+        QByteArray png;      // как лежит в файле
+        quint64 version = 0; // растёт при записи превью; png соответствует savedVersion
+        quint64 savedVersion = 0;
+    };
+    struct PageSnapshot {
+        QImage image;        // не пусто — страницу надо сжать заново
+        QByteArray png;
+        quint64 version;
+    };
+
+    static quint64 pathHash(const QString &path);
+    void load();
+    void onHashed(const QString &path, quint64 contentHash);
+    void onRendered(const QString &path, const QImage &image);
+    void onFailed(const QString &path);
+    void setEntry(quint64 pathHash, const Entry &entry);
+    void releaseTile(quint32 tile, quint64 contentHash);
+    quint32 allocateTile();
+    Page &page(quint32 tile);
+    QImage tileImage(quint32 tile);
+    void storeTile(quint32 tile, const QImage &image);
+    std::vector<PageSnapshot> snapshot() const;
+    static bool write(const QString &file, const QHash<quint64, Entry> &entries, std::vector<PageSnapshot> &pages);
+
+    QString m_file;
+    RenderService *m_renderer;
+    QHash<quint64, Entry> m_entries;     // по хэшу пути
+    QHash<quint64, quint32> m_byContent; // хэш содержимого -> плитка
+    std::vector<quint16> m_tileRefs;     // одна плитка — у всех копий файла
+    std::vector<quint32> m_freeTiles;
+    std::vector<Page> m_pages;
+    QHash<QString, Pending> m_pending;   // путь -> что заказано
+    QHash<quint64, qint64> m_failed;     // хэш пути -> mtime, на котором отрисовка не удалась
+
+    QThreadPool m_pool;
+    QTimer m_saveTimer;
+    bool m_dirty = false;
+    bool m_saving = false;
+    bool m_saveAgain = false;
+};